@@ -0,0 +1,210 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Aabb3.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		3D axis-aligned bounding box.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/Aabb3.h"
+#include "Math/MathSimd.h"
+#include "Math/MathUtils.h"
+#include <float.h>
+
+void aabb3_empty( aabb3_t* box )
+{
+	if ( box == NULL ) return;
+
+	box->min.x = box->min.y = box->min.z = FLT_MAX;
+	box->max.x = box->max.y = box->max.z = -FLT_MAX;
+}
+
+bool aabb3_is_empty( const aabb3_t* box )
+{
+	return box->min.x > box->max.x || box->min.y > box->max.y || box->min.z > box->max.z;
+}
+
+void aabb3_merge( aabb3_t* result, const aabb3_t* box1, const aabb3_t* box2 )
+{
+	if ( result == NULL || box1 == NULL || box2 == NULL ) return;
+
+	result->min.x = math_min( box1->min.x, box2->min.x );
+	result->min.y = math_min( box1->min.y, box2->min.y );
+	result->min.z = math_min( box1->min.z, box2->min.z );
+	result->max.x = math_max( box1->max.x, box2->max.x );
+	result->max.y = math_max( box1->max.y, box2->max.y );
+	result->max.z = math_max( box1->max.z, box2->max.z );
+}
+
+void aabb3_expand( aabb3_t* result, const aabb3_t* box, const vector3_t* point )
+{
+	if ( result == NULL || box == NULL || point == NULL ) return;
+
+	result->min.x = math_min( box->min.x, point->x );
+	result->min.y = math_min( box->min.y, point->y );
+	result->min.z = math_min( box->min.z, point->z );
+	result->max.x = math_max( box->max.x, point->x );
+	result->max.y = math_max( box->max.y, point->y );
+	result->max.z = math_max( box->max.z, point->z );
+}
+
+void aabb3_inflate( aabb3_t* result, const aabb3_t* box, float amount )
+{
+	if ( result == NULL || box == NULL ) return;
+
+	result->min.x = box->min.x - amount;
+	result->min.y = box->min.y - amount;
+	result->min.z = box->min.z - amount;
+	result->max.x = box->max.x + amount;
+	result->max.y = box->max.y + amount;
+	result->max.z = box->max.z + amount;
+}
+
+void aabb3_transform( aabb3_t* result, const aabb3_t* box, const matrix4_t* mat )
+{
+	float min[3], max[3], a, b;
+	uint32 i, j;
+
+	if ( result == NULL || box == NULL || mat == NULL ) return;
+
+	// The terms below would turn the infinite extents of an empty box into an infinite box.
+	if ( aabb3_is_empty( box ) )
+	{
+		aabb3_empty( result );
+		return;
+	}
+
+	// Start from the translation and add the smaller and larger of each term of the transform.
+	for ( j = 0; j < 3; j++ )
+	{
+		min[j] = max[j] = mat->m[3][j];
+
+		for ( i = 0; i < 3; i++ )
+		{
+			a = mat->m[i][j] * box->min.coords[i];
+			b = mat->m[i][j] * box->max.coords[i];
+
+			min[j] += math_min( a, b );
+			max[j] += math_max( a, b );
+		}
+	}
+
+	for ( j = 0; j < 3; j++ )
+	{
+		result->min.coords[j] = min[j];
+		result->max.coords[j] = max[j];
+	}
+}
+
+bool aabb3_overlaps( const aabb3_t* box1, const aabb3_t* box2 )
+{
+	return ( box1->min.x <= box2->max.x && box2->min.x <= box1->max.x &&
+			 box1->min.y <= box2->max.y && box2->min.y <= box1->max.y &&
+			 box1->min.z <= box2->max.z && box2->min.z <= box1->max.z );
+}
+
+bool aabb3_contains( const aabb3_t* box1, const aabb3_t* box2 )
+{
+	return ( box1->min.x <= box2->min.x && box2->max.x <= box1->max.x &&
+			 box1->min.y <= box2->min.y && box2->max.y <= box1->max.y &&
+			 box1->min.z <= box2->min.z && box2->max.z <= box1->max.z );
+}
+
+bool aabb3_contains_point( const aabb3_t* box, const vector3_t* point )
+{
+	return ( box->min.x <= point->x && point->x <= box->max.x &&
+			 box->min.y <= point->y && point->y <= box->max.y &&
+			 box->min.z <= point->z && point->z <= box->max.z );
+}
+
+void aabb3_center( vector3_t* result, const aabb3_t* box )
+{
+	result->x = ( box->min.x + box->max.x ) * 0.5f;
+	result->y = ( box->min.y + box->max.y ) * 0.5f;
+	result->z = ( box->min.z + box->max.z ) * 0.5f;
+}
+
+void aabb3_extents( vector3_t* result, const aabb3_t* box )
+{
+	result->x = ( box->max.x - box->min.x ) * 0.5f;
+	result->y = ( box->max.y - box->min.y ) * 0.5f;
+	result->z = ( box->max.z - box->min.z ) * 0.5f;
+}
+
+float aabb3_surface_area( const aabb3_t* box )
+{
+	float x, y, z;
+
+	if ( aabb3_is_empty( box ) ) return 0.0f;
+
+	x = box->max.x - box->min.x;
+	y = box->max.y - box->min.y;
+	z = box->max.z - box->min.z;
+
+	return 2.0f * ( x * y + y * z + z * x );
+}
+
+void aabb3_from_points( aabb3_t* result, const vector3_t* points, uint32 count, uint32 stride )
+{
+	const vector3_t* p;
+	float lanes[12];
+	uint32 i = 0, j;
+
+	if ( result == NULL || points == NULL ) return;
+
+	aabb3_empty( result );
+
+	if ( stride == 0 || stride == sizeof( vector3_t ) )
+	{
+		// Four packed points are exactly three vectors: x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3.
+		// Keep a min and a max per vector, the lanes are sorted out once at the end.
+		simd4f min0, min1, min2, max0, max1, max2, a, b, c;
+		const float* f = &points[0].x;
+
+		if ( count >= 4 )
+		{
+			min0 = max0 = simd4f_loadu( f );
+			min1 = max1 = simd4f_loadu( f + 4 );
+			min2 = max2 = simd4f_loadu( f + 8 );
+
+			for ( i = 4; i + 4 <= count; i += 4 )
+			{
+				a = simd4f_loadu( f + i * 3 );
+				b = simd4f_loadu( f + i * 3 + 4 );
+				c = simd4f_loadu( f + i * 3 + 8 );
+
+				min0 = simd4f_min( min0, a ); max0 = simd4f_max( max0, a );
+				min1 = simd4f_min( min1, b ); max1 = simd4f_max( max1, b );
+				min2 = simd4f_min( min2, c ); max2 = simd4f_max( max2, c );
+			}
+
+			simd4f_storeu( lanes, min0 );
+			simd4f_storeu( lanes + 4, min1 );
+			simd4f_storeu( lanes + 8, min2 );
+
+			for ( j = 0; j < 12; j++ )
+				result->min.coords[j % 3] = math_min( result->min.coords[j % 3], lanes[j] );
+
+			simd4f_storeu( lanes, max0 );
+			simd4f_storeu( lanes + 4, max1 );
+			simd4f_storeu( lanes + 8, max2 );
+
+			for ( j = 0; j < 12; j++ )
+				result->max.coords[j % 3] = math_max( result->max.coords[j % 3], lanes[j] );
+		}
+
+		for ( ; i < count; i++ )
+			aabb3_expand( result, result, &points[i] );
+
+		return;
+	}
+
+	for ( i = 0; i < count; i++ )
+	{
+		p = (const vector3_t*)( (const uint8*)points + (size_t)i * stride );
+		aabb3_expand( result, result, p );
+	}
+}
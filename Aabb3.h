@@ -0,0 +1,53 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Aabb3.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		3D axis-aligned bounding box.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_AABB3_H
+#define __MYLLY_AABB3_H
+
+#include "stdtypes.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+
+// An empty box has min > max on every axis (see aabb3_empty), merging or expanding it works as expected.
+typedef struct
+{
+	vector3_t min;
+	vector3_t max;
+} aabb3_t;
+
+__BEGIN_DECLS
+
+MYLLY_API void			aabb3_empty				( aabb3_t* box );
+MYLLY_API bool			aabb3_is_empty			( const aabb3_t* box );
+
+MYLLY_API void			aabb3_merge				( aabb3_t* result, const aabb3_t* box1, const aabb3_t* box2 );
+MYLLY_API void			aabb3_expand			( aabb3_t* result, const aabb3_t* box, const vector3_t* point );
+MYLLY_API void			aabb3_inflate			( aabb3_t* result, const aabb3_t* box, float amount );
+
+// Bounds of the transformed box using Arvo's method, tighter and much cheaper than transforming all 8 corners.
+// An empty box stays empty.
+MYLLY_API void			aabb3_transform			( aabb3_t* result, const aabb3_t* box, const matrix4_t* mat );
+
+MYLLY_API bool			aabb3_overlaps			( const aabb3_t* box1, const aabb3_t* box2 );
+MYLLY_API bool			aabb3_contains			( const aabb3_t* box1, const aabb3_t* box2 );
+MYLLY_API bool			aabb3_contains_point	( const aabb3_t* box, const vector3_t* point );
+
+MYLLY_API void			aabb3_center			( vector3_t* result, const aabb3_t* box );
+MYLLY_API void			aabb3_extents			( vector3_t* result, const aabb3_t* box );
+MYLLY_API float			aabb3_surface_area		( const aabb3_t* box );
+
+// Bounds of an array of points. The stride is in bytes, 0 means the points are tightly packed.
+MYLLY_API void			aabb3_from_points		( aabb3_t* result, const vector3_t* points, uint32 count, uint32 stride );
+
+__END_DECLS
+
+#endif /* __MYLLY_AABB3_H */
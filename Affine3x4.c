@@ -0,0 +1,229 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Affine3x4.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		An affine transformation matrix with an implicit
+ *				(0,0,0,1) last column.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/Affine3x4.h"
+#include "Math/MathSimd.h"
+
+void affine3x4_identity( affine3x4_t* a )
+{
+	if ( a == NULL ) return;
+
+	a->_12 = a->_13 =
+	a->_21 = a->_23 =
+	a->_31 = a->_32 =
+	a->_41 = a->_42 = a->_43 = 0.0f;
+
+	a->_11 = a->_22 = a->_33 = 1.0f;
+}
+
+void affine3x4_from_matrix4( affine3x4_t* result, const matrix4_t* mat )
+{
+	uint32 i;
+
+	if ( result == NULL || mat == NULL ) return;
+
+	for ( i = 0; i < 4; i++ )
+	{
+		result->m[i][0] = mat->m[i][0];
+		result->m[i][1] = mat->m[i][1];
+		result->m[i][2] = mat->m[i][2];
+	}
+}
+
+void affine3x4_to_matrix4( matrix4_t* result, const affine3x4_t* a )
+{
+	uint32 i;
+
+	if ( result == NULL || a == NULL ) return;
+
+	for ( i = 0; i < 4; i++ )
+	{
+		result->m[i][0] = a->m[i][0];
+		result->m[i][1] = a->m[i][1];
+		result->m[i][2] = a->m[i][2];
+		result->m[i][3] = 0.0f;
+	}
+
+	result->_44 = 1.0f;
+}
+
+// a1 is applied first, then a2 (like matrix4_multiply with row vectors). 36 multiplies instead of 64.
+void affine3x4_multiply( affine3x4_t* result, const affine3x4_t* a1, const affine3x4_t* a2 )
+{
+	affine3x4_t tmp;
+
+	if ( result == NULL || a1 == NULL || a2 == NULL ) return;
+
+	tmp._11 = a1->_11*a2->_11 + a1->_12*a2->_21 + a1->_13*a2->_31;
+	tmp._12 = a1->_11*a2->_12 + a1->_12*a2->_22 + a1->_13*a2->_32;
+	tmp._13 = a1->_11*a2->_13 + a1->_12*a2->_23 + a1->_13*a2->_33;
+
+	tmp._21 = a1->_21*a2->_11 + a1->_22*a2->_21 + a1->_23*a2->_31;
+	tmp._22 = a1->_21*a2->_12 + a1->_22*a2->_22 + a1->_23*a2->_32;
+	tmp._23 = a1->_21*a2->_13 + a1->_22*a2->_23 + a1->_23*a2->_33;
+
+	tmp._31 = a1->_31*a2->_11 + a1->_32*a2->_21 + a1->_33*a2->_31;
+	tmp._32 = a1->_31*a2->_12 + a1->_32*a2->_22 + a1->_33*a2->_32;
+	tmp._33 = a1->_31*a2->_13 + a1->_32*a2->_23 + a1->_33*a2->_33;
+
+	tmp._41 = a1->_41*a2->_11 + a1->_42*a2->_21 + a1->_43*a2->_31 + a2->_41;
+	tmp._42 = a1->_41*a2->_12 + a1->_42*a2->_22 + a1->_43*a2->_32 + a2->_42;
+	tmp._43 = a1->_41*a2->_13 + a1->_42*a2->_23 + a1->_43*a2->_33 + a2->_43;
+
+	*result = tmp;
+}
+
+float affine3x4_determinant( const affine3x4_t* a )
+{
+	if ( a == NULL ) return 0;
+
+	return a->_11 * ( a->_22 * a->_33 - a->_23 * a->_32 ) +
+		   a->_12 * ( a->_23 * a->_31 - a->_21 * a->_33 ) +
+		   a->_13 * ( a->_21 * a->_32 - a->_22 * a->_31 );
+}
+
+// Inverts the 3x3 part with cross products and moves the translation through it. Returns the
+// determinant like matrix4_inverse; result is left untouched when it is zero.
+float affine3x4_inverse( affine3x4_t* result, const affine3x4_t* a )
+{
+	float c0[3], c1[3], c2[3], det, inv;
+	affine3x4_t tmp;
+
+	if ( result == NULL || a == NULL ) return 0;
+
+	// Columns of the adjugate: row2 x row3, row3 x row1, row1 x row2
+	c0[0] = a->_22 * a->_33 - a->_23 * a->_32;
+	c0[1] = a->_23 * a->_31 - a->_21 * a->_33;
+	c0[2] = a->_21 * a->_32 - a->_22 * a->_31;
+
+	c1[0] = a->_32 * a->_13 - a->_33 * a->_12;
+	c1[1] = a->_33 * a->_11 - a->_31 * a->_13;
+	c1[2] = a->_31 * a->_12 - a->_32 * a->_11;
+
+	c2[0] = a->_12 * a->_23 - a->_13 * a->_22;
+	c2[1] = a->_13 * a->_21 - a->_11 * a->_23;
+	c2[2] = a->_11 * a->_22 - a->_12 * a->_21;
+
+	det = a->_11 * c0[0] + a->_12 * c0[1] + a->_13 * c0[2];
+
+	// This matrix can't be inverted
+	if ( det == 0.0f ) return det;
+
+	inv = 1.0f / det;
+
+	tmp._11 = c0[0] * inv; tmp._12 = c1[0] * inv; tmp._13 = c2[0] * inv;
+	tmp._21 = c0[1] * inv; tmp._22 = c1[1] * inv; tmp._23 = c2[1] * inv;
+	tmp._31 = c0[2] * inv; tmp._32 = c1[2] * inv; tmp._33 = c2[2] * inv;
+
+	tmp._41 = -( a->_41 * tmp._11 + a->_42 * tmp._21 + a->_43 * tmp._31 );
+	tmp._42 = -( a->_41 * tmp._12 + a->_42 * tmp._22 + a->_43 * tmp._32 );
+	tmp._43 = -( a->_41 * tmp._13 + a->_42 * tmp._23 + a->_43 * tmp._33 );
+
+	*result = tmp;
+	return det;
+}
+
+// Inverse of a rotation + translation (no scale or shear): transpose the rotation, negate the
+// translation and rotate it back.
+void affine3x4_inverse_rigid( affine3x4_t* result, const affine3x4_t* a )
+{
+	affine3x4_t tmp;
+
+	if ( result == NULL || a == NULL ) return;
+
+	tmp._11 = a->_11; tmp._12 = a->_21; tmp._13 = a->_31;
+	tmp._21 = a->_12; tmp._22 = a->_22; tmp._23 = a->_32;
+	tmp._31 = a->_13; tmp._32 = a->_23; tmp._33 = a->_33;
+
+	tmp._41 = -( a->_41 * a->_11 + a->_42 * a->_12 + a->_43 * a->_13 );
+	tmp._42 = -( a->_41 * a->_21 + a->_42 * a->_22 + a->_43 * a->_23 );
+	tmp._43 = -( a->_41 * a->_31 + a->_42 * a->_32 + a->_43 * a->_33 );
+
+	*result = tmp;
+}
+
+void affine3x4_transform_coord( vector3_t* result, const vector3_t* point, const affine3x4_t* a )
+{
+	float x = point->x, y = point->y, z = point->z;
+
+	result->x = a->_11 * x + a->_21 * y + a->_31 * z + a->_41;
+	result->y = a->_12 * x + a->_22 * y + a->_32 * z + a->_42;
+	result->z = a->_13 * x + a->_23 * y + a->_33 * z + a->_43;
+}
+
+void affine3x4_transform_normal( vector3_t* result, const vector3_t* normal, const affine3x4_t* a )
+{
+	float x = normal->x, y = normal->y, z = normal->z;
+
+	result->x = a->_11 * x + a->_21 * y + a->_31 * z;
+	result->y = a->_12 * x + a->_22 * y + a->_32 * z;
+	result->z = a->_13 * x + a->_23 * y + a->_33 * z;
+}
+
+// See vector3_transform_coord_array for the stride convention and the scalar build.
+void affine3x4_transform_coord_array( vector3_t* result, const vector3_t* points, uint32 count, uint32 stride, const affine3x4_t* a )
+{
+	const uint8* src = (const uint8*)points;
+	uint8* dst = (uint8*)result;
+	uint32 i = 0;
+#if defined(MYLLY_MATH_SSE2) || defined(MYLLY_MATH_NEON)
+	const vector3_t* p[4];
+	vector3_t* r[4];
+	simd4f x, y, z, rx, ry, rz;
+	simd4f m11, m12, m13, m21, m22, m23, m31, m32, m33, m41, m42, m43;
+	float ox[4], oy[4], oz[4];
+	uint32 j;
+#endif
+
+	if ( result == NULL || points == NULL || a == NULL ) return;
+	if ( stride == 0 ) stride = sizeof( vector3_t );
+
+#if defined(MYLLY_MATH_SSE2) || defined(MYLLY_MATH_NEON)
+	m11 = simd4f_set1( a->_11 ); m12 = simd4f_set1( a->_12 ); m13 = simd4f_set1( a->_13 );
+	m21 = simd4f_set1( a->_21 ); m22 = simd4f_set1( a->_22 ); m23 = simd4f_set1( a->_23 );
+	m31 = simd4f_set1( a->_31 ); m32 = simd4f_set1( a->_32 ); m33 = simd4f_set1( a->_33 );
+	m41 = simd4f_set1( a->_41 ); m42 = simd4f_set1( a->_42 ); m43 = simd4f_set1( a->_43 );
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		for ( j = 0; j < 4; j++ )
+		{
+			p[j] = (const vector3_t*)( src + ( i + j ) * stride );
+			r[j] = (vector3_t*)( dst + ( i + j ) * stride );
+		}
+
+		x = simd4f_set( p[0]->x, p[1]->x, p[2]->x, p[3]->x );
+		y = simd4f_set( p[0]->y, p[1]->y, p[2]->y, p[3]->y );
+		z = simd4f_set( p[0]->z, p[1]->z, p[2]->z, p[3]->z );
+
+		rx = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m11, x ), simd4f_mul( m21, y ) ), simd4f_mul( m31, z ) ), m41 );
+		ry = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m12, x ), simd4f_mul( m22, y ) ), simd4f_mul( m32, z ) ), m42 );
+		rz = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m13, x ), simd4f_mul( m23, y ) ), simd4f_mul( m33, z ) ), m43 );
+
+		simd4f_storeu( ox, rx );
+		simd4f_storeu( oy, ry );
+		simd4f_storeu( oz, rz );
+
+		for ( j = 0; j < 4; j++ )
+		{
+			r[j]->x = ox[j];
+			r[j]->y = oy[j];
+			r[j]->z = oz[j];
+		}
+	}
+#endif
+
+	for ( ; i < count; i++ )
+	{
+		affine3x4_transform_coord( (vector3_t*)( dst + i * stride ), (const vector3_t*)( src + i * stride ), a );
+	}
+}
@@ -0,0 +1,52 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Affine3x4.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		An affine transformation matrix with an implicit
+ *				(0,0,0,1) last column.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_AFFINE3X4_H
+#define __MYLLY_AFFINE3X4_H
+
+#include "stdtypes.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+
+// Same row layout as matrix4_t with the fourth column dropped: rows 1-3 hold the linear part
+// and row 4 the translation.
+typedef union
+{
+	struct {
+		float _11, _12, _13;
+		float _21, _22, _23;
+		float _31, _32, _33;
+		float _41, _42, _43;
+	};
+	float m[4][3];
+	float mat[12];
+} affine3x4_t;
+
+__BEGIN_DECLS
+
+MYLLY_API void			affine3x4_identity				( affine3x4_t* a );
+MYLLY_API void			affine3x4_from_matrix4			( affine3x4_t* result, const matrix4_t* mat );
+MYLLY_API void			affine3x4_to_matrix4			( matrix4_t* result, const affine3x4_t* a );
+
+MYLLY_API void			affine3x4_multiply				( affine3x4_t* result, const affine3x4_t* a1, const affine3x4_t* a2 );
+MYLLY_API float			affine3x4_determinant			( const affine3x4_t* a );
+MYLLY_API float			affine3x4_inverse				( affine3x4_t* result, const affine3x4_t* a );
+MYLLY_API void			affine3x4_inverse_rigid			( affine3x4_t* result, const affine3x4_t* a );
+
+MYLLY_API void			affine3x4_transform_coord		( vector3_t* result, const vector3_t* point, const affine3x4_t* a );
+MYLLY_API void			affine3x4_transform_normal		( vector3_t* result, const vector3_t* normal, const affine3x4_t* a );
+MYLLY_API void			affine3x4_transform_coord_array	( vector3_t* result, const vector3_t* points, uint32 count, uint32 stride, const affine3x4_t* a );
+
+__END_DECLS
+
+#endif /* __MYLLY_AFFINE3X4_H */
@@ -0,0 +1,318 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Bench.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Micro-benchmark harness for Lib-Math.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <time.h>
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#endif
+
+#define BENCH_MAX_SIZES		16
+#define BENCH_MAX_MODULES	16
+
+bench_data_t bench;
+volatile float bench_sink = 0.0f;
+
+static const bench_case_t* bench_modules[BENCH_MAX_MODULES] = {
+	bench_matrix_cases,
+	bench_vector_cases,
+	bench_colour_cases,
+	bench_rectangle_cases,
+	NULL
+};
+
+static uint32	batch_sizes[BENCH_MAX_SIZES] = { 1, 16, 256, 4096 };
+static uint32	num_batch_sizes = 4;
+static uint32	repeats = 5;
+static uint32	num_threads = 0;			// Worker pool size, 0 = one per core
+static double	min_sample_ns = 2000000.0;	// 2ms
+static bool		csv_output = false;
+static const char* filter = NULL;
+
+// --------------------------------------------------
+// Timers
+// --------------------------------------------------
+
+static double bench_now_ns( void )
+{
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER now;
+
+	if ( freq.QuadPart == 0 ) QueryPerformanceFrequency( &freq );
+	QueryPerformanceCounter( &now );
+
+	return (double)now.QuadPart * 1.0e9 / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (double)ts.tv_sec * 1.0e9 + (double)ts.tv_nsec;
+#endif
+}
+
+// Time stamp counter, or 0 on platforms without one.
+static uint64 bench_cycles( void )
+{
+#if defined(_WIN32) && ( defined(_M_IX86) || defined(_M_X64) )
+	return __rdtsc();
+#elif defined(__i386__) || defined(__x86_64__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+// --------------------------------------------------
+// Input data
+// --------------------------------------------------
+
+static float bench_randf( float lower, float upper )
+{
+	return lower + ( upper - lower ) * ( (float)rand() / (float)RAND_MAX );
+}
+
+void* bench_alloc( size_t size )
+{
+	void* ptr = malloc( size );
+
+	if ( ptr == NULL )
+	{
+		fprintf( stderr, "Out of memory\n" );
+		exit( 1 );
+	}
+
+	return ptr;
+}
+
+static void bench_create_data( uint32 capacity )
+{
+	uint32 i, j;
+	matrix4_t rot, trans;
+
+	srand( 1234 );
+	bench.capacity = capacity;
+	bench.mask = (uint32*)bench_alloc( ( ( capacity + 31 ) / 32 ) * sizeof( uint32 ) );
+	bench.clip = (uint8*)bench_alloc( capacity );
+	bench.packed = (uint32*)bench_alloc( capacity * 4 * sizeof( uint32 ) );
+	bench.half = (uint16*)bench_alloc( capacity * 4 * sizeof( uint16 ) );
+	bench.normals = (vector3_t*)bench_alloc( capacity * sizeof( vector3_t ) );
+
+	for ( j = 0; j < 3; j++ )
+	{
+		bench.v2[j] = (vector2_t*)bench_alloc( capacity * sizeof( vector2_t ) );
+		bench.v3[j] = (vector3_t*)bench_alloc( capacity * sizeof( vector3_t ) );
+		bench.v3d[j] = (vector3d_t*)bench_alloc( capacity * sizeof( vector3d_t ) );
+		bench.v4[j] = (vector4_t*)bench_alloc( capacity * sizeof( vector4_t ) );
+		bench.vs[j] = (vectorscreen_t*)bench_alloc( capacity * sizeof( vectorscreen_t ) );
+		bench.col[j] = (colour_t*)bench_alloc( capacity * sizeof( colour_t ) );
+		bench.col16[j] = (colour16_t*)bench_alloc( capacity * sizeof( colour16_t ) );
+		bench.rect[j] = (rectangle_t*)bench_alloc( capacity * sizeof( rectangle_t ) );
+		bench.mat[j] = (matrix4_t*)bench_alloc( capacity * sizeof( matrix4_t ) );
+		bench.matd[j] = (matrix4d_t*)bench_alloc( capacity * sizeof( matrix4d_t ) );
+		bench.aff[j] = (affine3x4_t*)bench_alloc( capacity * sizeof( affine3x4_t ) );
+		bench.quat[j] = (quaternion_t*)bench_alloc( capacity * sizeof( quaternion_t ) );
+		bench.aabb[j] = (aabb3_t*)bench_alloc( capacity * sizeof( aabb3_t ) );
+		bench.f[j] = (float*)bench_alloc( capacity * sizeof( float ) );
+
+		for ( i = 0; i < capacity; i++ )
+		{
+			bench.v2[j][i].x = bench_randf( -10, 10 );
+			bench.v2[j][i].y = bench_randf( -10, 10 );
+
+			bench.v3[j][i].x = bench_randf( -10, 10 );
+			bench.v3[j][i].y = bench_randf( -10, 10 );
+			bench.v3[j][i].z = bench_randf( -10, 10 );
+
+			vector3d_from_vector3( &bench.v3d[j][i], &bench.v3[j][i] );
+			vector3d_add_scalar( &bench.v3d[j][i], &bench.v3d[j][i], 1.0e6 );
+
+			bench.v4[j][i].x = bench_randf( -10, 10 );
+			bench.v4[j][i].y = bench_randf( -10, 10 );
+			bench.v4[j][i].z = bench_randf( -10, 10 );
+			bench.v4[j][i].w = bench_randf( -10, 10 );
+
+			bench.vs[j][i].x = (int16)( rand() % 2048 );
+			bench.vs[j][i].y = (int16)( rand() % 2048 );
+
+			bench.col[j][i].hex = ( (uint32)rand() << 16 ) ^ (uint32)rand();
+			colour_srgb_to_linear16( &bench.col16[j][i], &bench.col[j][i] );
+
+			bench.rect[j][i].x = (int16)( rand() % 1024 );
+			bench.rect[j][i].y = (int16)( rand() % 1024 );
+			bench.rect[j][i].w = (int16)( rand() % 512 );
+			bench.rect[j][i].h = (int16)( rand() % 512 );
+
+			matrix4_rotation_y( &rot, bench_randf( -PI, PI ) );
+			matrix4_translation( &trans, bench_randf( -10, 10 ), bench_randf( -10, 10 ), bench_randf( -10, 10 ) );
+			matrix4_multiply( &bench.mat[j][i], &rot, &trans );
+			matrix4d_from_matrix4( &bench.matd[j][i], &bench.mat[j][i] );
+			affine3x4_from_matrix4( &bench.aff[j][i], &bench.mat[j][i] );
+			quaternion_rotation_yaw_pitch_roll( &bench.quat[j][i], bench_randf( -PI, PI ), bench_randf( -PI, PI ), bench_randf( -PI, PI ) );
+
+			bench.f[j][i] = bench_randf( 0, 1 );
+
+			bench.aabb[j][i].min = bench.aabb[j][i].max = bench.v3[j][i];
+			aabb3_inflate( &bench.aabb[j][i], &bench.aabb[j][i], bench.f[j][i] );
+		}
+
+		vector3_soa_create( &bench.soa3[j], capacity );
+		vector3_soa_pack( &bench.soa3[j], bench.v3[j], capacity );
+		vector4_soa_create( &bench.soa4[j], capacity );
+		vector4_soa_pack( &bench.soa4[j], bench.v4[j], capacity );
+	}
+
+	for ( i = 0; i < capacity * 4; i++ )
+		bench.packed[i] = ( (uint32)rand() << 16 ) ^ (uint32)rand();
+
+	math_pack_half_array( bench.half, bench.v4[0][0].coords, capacity * 4 );
+	vector3_normalize_array( bench.normals, bench.v3[0], capacity );
+}
+
+// --------------------------------------------------
+// Runner
+// --------------------------------------------------
+
+static void bench_run_case( const bench_case_t* bc, uint32 count )
+{
+	uint32 iterations = 1, it, r;
+	double start, elapsed, best_ns = 0;
+	uint64 cycles, best_cycles = 0;
+	double ns_per_op, cycles_per_op, mops;
+
+	// Warm up and find an iteration count which fills the minimum sample time.
+	for ( ;; )
+	{
+		start = bench_now_ns();
+		for ( it = 0; it < iterations; it++ ) bc->func( count );
+		elapsed = bench_now_ns() - start;
+
+		if ( elapsed >= min_sample_ns || iterations >= ( 1u << 30 ) ) break;
+		iterations *= 2;
+	}
+
+	// Keep the fastest sample, it has the least noise from the rest of the system.
+	for ( r = 0; r < repeats; r++ )
+	{
+		cycles = bench_cycles();
+		start = bench_now_ns();
+
+		for ( it = 0; it < iterations; it++ ) bc->func( count );
+
+		elapsed = bench_now_ns() - start;
+		cycles = bench_cycles() - cycles;
+
+		if ( r == 0 || elapsed < best_ns )
+		{
+			best_ns = elapsed;
+			best_cycles = cycles;
+		}
+	}
+
+	ns_per_op = best_ns / ( (double)iterations * count );
+	cycles_per_op = (double)best_cycles / ( (double)iterations * count );
+	mops = 1.0e3 / ns_per_op;
+
+	if ( csv_output )
+		printf( "%s,%u,%.4f,%.3f,%.2f\n", bc->name, count, ns_per_op, mops, cycles_per_op );
+	else
+		printf( "%-40s %8u %12.3f %12.2f %10.2f\n", bc->name, count, ns_per_op, mops, cycles_per_op );
+}
+
+static void bench_parse_sizes( const char* arg )
+{
+	char* end;
+
+	num_batch_sizes = 0;
+
+	while ( *arg && num_batch_sizes < BENCH_MAX_SIZES )
+	{
+		uint32 size = (uint32)strtoul( arg, &end, 10 );
+		if ( end == arg ) break;
+
+		if ( size > 0 ) batch_sizes[num_batch_sizes++] = size;
+
+		arg = ( *end == ',' ) ? end + 1 : end;
+	}
+}
+
+static void bench_usage( const char* exe )
+{
+	printf( "Usage: %s [options]\n", exe );
+	printf( "  -b <n,n,...>   Batch sizes (default 1,16,256,4096)\n" );
+	printf( "  -r <n>         Samples per benchmark, the fastest one is reported (default 5)\n" );
+	printf( "  -t <ms>        Minimum duration of one sample in milliseconds (default 2)\n" );
+	printf( "  -f <text>      Only run benchmarks whose name contains text\n" );
+	printf( "  -j <n>         Threads used by the math_pool benchmarks (default one per core)\n" );
+	printf( "  -csv           Machine-readable output: function,batch,ns_per_op,mops,cycles_per_op\n" );
+}
+
+int main( int argc, char** argv )
+{
+	int i;
+	uint32 m, b, max_batch = 0;
+	const bench_case_t* bc;
+
+	for ( i = 1; i < argc; i++ )
+	{
+		if ( strcmp( argv[i], "-b" ) == 0 && i + 1 < argc ) bench_parse_sizes( argv[++i] );
+		else if ( strcmp( argv[i], "-r" ) == 0 && i + 1 < argc ) repeats = (uint32)atoi( argv[++i] );
+		else if ( strcmp( argv[i], "-t" ) == 0 && i + 1 < argc ) min_sample_ns = atof( argv[++i] ) * 1.0e6;
+		else if ( strcmp( argv[i], "-f" ) == 0 && i + 1 < argc ) filter = argv[++i];
+		else if ( strcmp( argv[i], "-j" ) == 0 && i + 1 < argc ) num_threads = (uint32)atoi( argv[++i] );
+		else if ( strcmp( argv[i], "-csv" ) == 0 ) csv_output = true;
+		else
+		{
+			bench_usage( argv[0] );
+			return strcmp( argv[i], "-h" ) == 0 ? 0 : 1;
+		}
+	}
+
+	if ( num_batch_sizes == 0 || repeats == 0 )
+	{
+		bench_usage( argv[0] );
+		return 1;
+	}
+
+	for ( b = 0; b < num_batch_sizes; b++ )
+		max_batch = math_max( max_batch, batch_sizes[b] );
+
+	bench_create_data( max_batch );
+	bench.pool = math_pool_create( num_threads );
+
+	if ( csv_output )
+		printf( "function,batch,ns_per_op,mops,cycles_per_op\n" );
+	else
+		printf( "%-40s %8s %12s %12s %10s\n", "function", "batch", "ns/op", "Mops/s", "cycles/op" );
+
+	for ( m = 0; bench_modules[m] != NULL; m++ )
+	{
+		for ( bc = bench_modules[m]; bc->name != NULL; bc++ )
+		{
+			if ( filter != NULL && strstr( bc->name, filter ) == NULL ) continue;
+
+			for ( b = 0; b < num_batch_sizes; b++ )
+				bench_run_case( bc, batch_sizes[b] );
+		}
+	}
+
+	math_pool_destroy( bench.pool );
+	return 0;
+}
@@ -0,0 +1,86 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Bench.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Micro-benchmark harness for Lib-Math.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_MATH_BENCH_H
+#define __MYLLY_MATH_BENCH_H
+
+#include "stdtypes.h"
+#include "Math/MathDefs.h"
+#include "Math/Affine3x4.h"
+#include "Math/MathThreads.h"
+
+// A single benchmark. func performs count operations on the shared input data.
+typedef struct
+{
+	const char* name;
+	void ( *func )( uint32 count );
+} bench_case_t;
+
+// Input and output arrays shared by all benchmarks. Index 0 and 1 are inputs, 2 is the output.
+typedef struct
+{
+	vector2_t*		v2[3];
+	vector3_t*		v3[3];
+	vector3d_t*		v3d[3];			// Large world positions, v3 offset by a million units
+	vector4_t*		v4[3];
+	vectorscreen_t*	vs[3];
+	colour_t*		col[3];
+	colour16_t*		col16[3];
+	rectangle_t*	rect[3];
+	matrix4_t*		mat[3];
+	matrix4d_t*		matd[3];
+	affine3x4_t*	aff[3];
+	quaternion_t*	quat[3];
+	aabb3_t*		aabb[3];
+	float*			f[3];
+	vector3_soa_t	soa3[3];
+	vector4_soa_t	soa4[3];
+	math_pool_t*	pool;
+	uint32*			mask;			// One bit per element, for kernels producing visibility masks
+	uint8*			clip;			// One byte per element, for kernels producing clip flags
+	uint32*			packed;			// Four words per element, for packed vertex formats
+	uint16*			half;			// v4[0] packed as half floats
+	vector3_t*		normals;		// v3[0] normalized, for the unit vector encoders
+	uint32			capacity;
+} bench_data_t;
+
+extern bench_data_t		bench;
+extern volatile float	bench_sink;		// Results are accumulated here so the calls can't be optimised away
+
+// malloc which exits with an error message when out of memory.
+void*					bench_alloc		( size_t size );
+
+// Defines a benchmark which runs stmt once for every i in [0, count).
+#define BENCH_LOOP(fn, stmt) \
+	static void bench_##fn( uint32 count ) \
+	{ \
+		uint32 i; \
+		for ( i = 0; i < count; i++ ) { stmt; } \
+	}
+
+// Defines a benchmark for a batch function which handles all count elements in one call.
+#define BENCH_BATCH(fn, stmt) \
+	static void bench_##fn( uint32 count ) \
+	{ \
+		stmt; \
+	}
+
+#define BENCH_ENTRY(fn)		{ #fn, bench_##fn }
+#define BENCH_END			{ NULL, NULL }
+
+// Case tables, one per library module
+extern const bench_case_t bench_matrix_cases[];
+extern const bench_case_t bench_vector_cases[];
+extern const bench_case_t bench_colour_cases[];
+extern const bench_case_t bench_rectangle_cases[];
+
+#endif /* __MYLLY_MATH_BENCH_H */
@@ -0,0 +1,87 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		BenchColour.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Benchmarks for the colour functions.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Bench.h"
+
+#define C(j)	bench.col[j]
+#define C16(j)	bench.col16[j]
+#define V4(j)	bench.v4[j]
+#define F(j)	bench.f[j]
+
+BENCH_LOOP( colour_add,					colour_add( &C(2)[i], &C(0)[i], &C(1)[i] ) )
+BENCH_LOOP( colour_subtract,			colour_subtract( &C(2)[i], &C(0)[i], &C(1)[i] ) )
+BENCH_LOOP( colour_multiply,			colour_multiply( &C(2)[i], &C(0)[i], F(0)[i] * 2.0f ) )
+BENCH_LOOP( colour_divide,				colour_divide( &C(2)[i], &C(0)[i], F(0)[i] + 1.0f ) )
+BENCH_LOOP( colour_add_scalar,			colour_add_scalar( &C(2)[i], &C(0)[i], F(0)[i] * 64.0f ) )
+BENCH_LOOP( colour_subtract_scalar,		colour_subtract_scalar( &C(2)[i], &C(0)[i], F(0)[i] * 64.0f ) )
+BENCH_LOOP( colour_invert,				colour_invert( &C(2)[i], &C(0)[i] ) )
+BENCH_LOOP( colour_invert_no_alpha,		colour_invert_no_alpha( &C(2)[i], &C(0)[i] ) )
+BENCH_LOOP( colour_lerp,				colour_lerp( &C(2)[i], &C(0)[i], &C(1)[i], F(0)[i] ) )
+BENCH_LOOP( colour_lerp_no_alpha,		colour_lerp_no_alpha( &C(2)[i], &C(0)[i], &C(1)[i], F(0)[i] ) )
+
+BENCH_BATCH( colour_add_array,			colour_add_array( C(2), C(0), C(1), count ) )
+BENCH_BATCH( colour_multiply_array,		colour_multiply_array( C(2), C(0), 1.5f, count ) )
+BENCH_BATCH( colour_invert_array,		colour_invert_array( C(2), C(0), count ) )
+BENCH_BATCH( colour_lerp_array,			colour_lerp_array( C(2), C(0), C(1), 0.25f, count ) )
+
+// ColourBlend.h, the inputs are treated as premultiplied as they are
+BENCH_LOOP( colour_premultiply,			colour_premultiply( &C(2)[i], &C(0)[i] ) )
+BENCH_LOOP( colour_unpremultiply,		colour_unpremultiply( &C(2)[i], &C(0)[i] ) )
+BENCH_LOOP( colour_blend,				C(2)[i] = C(1)[i]; colour_blend( &C(2)[i], &C(0)[i], COLOUR_BLEND_OVER ) )
+BENCH_BATCH( colour_premultiply_span,	colour_premultiply_span( C(2), C(0), count ) )
+BENCH_BATCH( colour_unpremultiply_span,	colour_unpremultiply_span( C(2), C(0), count ) )
+BENCH_BATCH( colour_blend_span_over,	colour_blend_span( C(2), C(0), count, COLOUR_BLEND_OVER ) )
+BENCH_BATCH( colour_blend_span_add,		colour_blend_span( C(2), C(0), count, COLOUR_BLEND_ADD ) )
+BENCH_BATCH( colour_blend_span_multiply, colour_blend_span( C(2), C(0), count, COLOUR_BLEND_MULTIPLY ) )
+
+// ColourSrgb.h
+BENCH_BATCH( colour_srgb_to_linear16_array,	colour_srgb_to_linear16_array( C16(2), C(0), count ) )
+BENCH_BATCH( colour_linear16_to_srgb_array,	colour_linear16_to_srgb_array( C(2), C16(0), count ) )
+BENCH_BATCH( colour_srgb_to_linear_float_array,	colour_srgb_to_linear_float_array( V4(2), C(0), count ) )
+BENCH_BATCH( colour_linear_float_to_srgb_array,	colour_linear_float_to_srgb_array( C(2), V4(0), count ) )
+BENCH_LOOP( colour_lerp_srgb,			colour_lerp_srgb( &C(2)[i], &C(0)[i], &C(1)[i], F(0)[i] ) )
+BENCH_BATCH( colour_lerp_srgb_array,	colour_lerp_srgb_array( C(2), C(0), C(1), 0.25f, count ) )
+BENCH_BATCH( colour_from_float_array,	colour_from_float_array( C(2), V4(0), count ) )
+BENCH_BATCH( colour_to_float_array,		colour_to_float_array( V4(2), C(0), count ) )
+
+const bench_case_t bench_colour_cases[] = {
+	BENCH_ENTRY( colour_add ),
+	BENCH_ENTRY( colour_subtract ),
+	BENCH_ENTRY( colour_multiply ),
+	BENCH_ENTRY( colour_divide ),
+	BENCH_ENTRY( colour_add_scalar ),
+	BENCH_ENTRY( colour_subtract_scalar ),
+	BENCH_ENTRY( colour_invert ),
+	BENCH_ENTRY( colour_invert_no_alpha ),
+	BENCH_ENTRY( colour_lerp ),
+	BENCH_ENTRY( colour_lerp_no_alpha ),
+	BENCH_ENTRY( colour_add_array ),
+	BENCH_ENTRY( colour_multiply_array ),
+	BENCH_ENTRY( colour_invert_array ),
+	BENCH_ENTRY( colour_lerp_array ),
+	BENCH_ENTRY( colour_premultiply ),
+	BENCH_ENTRY( colour_unpremultiply ),
+	BENCH_ENTRY( colour_blend ),
+	BENCH_ENTRY( colour_premultiply_span ),
+	BENCH_ENTRY( colour_unpremultiply_span ),
+	BENCH_ENTRY( colour_blend_span_over ),
+	BENCH_ENTRY( colour_blend_span_add ),
+	BENCH_ENTRY( colour_blend_span_multiply ),
+	BENCH_ENTRY( colour_srgb_to_linear16_array ),
+	BENCH_ENTRY( colour_linear16_to_srgb_array ),
+	BENCH_ENTRY( colour_srgb_to_linear_float_array ),
+	BENCH_ENTRY( colour_linear_float_to_srgb_array ),
+	BENCH_ENTRY( colour_lerp_srgb ),
+	BENCH_ENTRY( colour_lerp_srgb_array ),
+	BENCH_ENTRY( colour_from_float_array ),
+	BENCH_ENTRY( colour_to_float_array ),
+	BENCH_END
+};
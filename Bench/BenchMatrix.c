@@ -0,0 +1,203 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		BenchMatrix.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Benchmarks for the matrix functions.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Bench.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define M(j)	bench.mat[j]
+#define A(j)	bench.aff[j]
+#define V3(j)	bench.v3[j]
+#define MD(j)	bench.matd[j]
+#define Q(j)	bench.quat[j]
+#define F(j)	bench.f[j]
+
+// A transform tree with a random hierarchy over all the bench data, built on first use.
+static transform_tree_t* bench_tree( void )
+{
+	static transform_tree_t tree;
+	static bool created = false;
+	uint32 i;
+
+	if ( !created )
+	{
+		transform_tree_create( &tree, bench.capacity );
+
+		for ( i = 0; i < bench.capacity; i++ )
+			transform_tree_add( &tree, ( i % 8 ) == 0 ? TRANSFORM_NO_PARENT : (uint32)rand() % i );
+
+		created = true;
+	}
+
+	return &tree;
+}
+
+// Moves count nodes (and so their subtrees) and updates the tree.
+static void bench_tree_update( uint32 count )
+{
+	transform_tree_t* tree = bench_tree();
+	uint32 i;
+
+	for ( i = 0; i < count; i++ )
+		transform_tree_set_position( tree, i, &V3(0)[i] );
+
+	bench_sink += (float)transform_tree_update( tree );
+}
+
+// A frustum looking down +z from the origin with a 90 degree field of view and z in [0.1, 20].
+static const frustum_t* bench_frustum( void )
+{
+	static frustum_t frustum;
+	static bool created = false;
+	matrix4_t proj;
+
+	if ( !created )
+	{
+		memset( &proj, 0, sizeof( proj ) );
+		proj._11 = proj._22 = 1.0f;
+		proj._33 = 20.0f / ( 20.0f - 0.1f );
+		proj._34 = 1.0f;
+		proj._43 = -0.1f * 20.0f / ( 20.0f - 0.1f );
+
+		frustum_from_matrix4( &frustum, &proj );
+		created = true;
+	}
+
+	return &frustum;
+}
+
+static frustum_t bench_frustum_out;
+
+// matrix4_t
+BENCH_LOOP( matrix4_add,				matrix4_add( &M(2)[i], &M(0)[i], &M(1)[i] ) )
+BENCH_LOOP( matrix4_subtract,			matrix4_subtract( &M(2)[i], &M(0)[i], &M(1)[i] ) )
+BENCH_LOOP( matrix4_multiply,			matrix4_multiply( &M(2)[i], &M(0)[i], &M(1)[i] ) )
+BENCH_LOOP( matrix4_add_scalar,			matrix4_add_scalar( &M(2)[i], &M(0)[i], F(0)[i] ) )
+BENCH_LOOP( matrix4_subtract_scalar,	matrix4_subtract_scalar( &M(2)[i], &M(0)[i], F(0)[i] ) )
+BENCH_LOOP( matrix4_multiply_scalar,	matrix4_multiply_scalar( &M(2)[i], &M(0)[i], F(0)[i] ) )
+BENCH_LOOP( matrix4_divide_scalar,		matrix4_divide_scalar( &M(2)[i], &M(0)[i], F(0)[i] + 1.0f ) )
+BENCH_LOOP( matrix4_identity,			matrix4_identity( &M(2)[i] ) )
+BENCH_LOOP( matrix4_transpose,			matrix4_transpose( &M(2)[i], &M(0)[i] ) )
+BENCH_LOOP( matrix4_inverse,			bench_sink += matrix4_inverse( &M(2)[i], &M(0)[i] ) )
+BENCH_LOOP( matrix4_determinant,		bench_sink += matrix4_determinant( &M(0)[i] ) )
+BENCH_LOOP( matrix4_translation,		matrix4_translation( &M(2)[i], F(0)[i], F(1)[i], F(2)[i] ) )
+BENCH_LOOP( matrix4_rotation_x,			matrix4_rotation_x( &M(2)[i], F(0)[i] ) )
+BENCH_LOOP( matrix4_rotation_y,			matrix4_rotation_y( &M(2)[i], F(0)[i] ) )
+BENCH_LOOP( matrix4_rotation_z,			matrix4_rotation_z( &M(2)[i], F(0)[i] ) )
+BENCH_LOOP( matrix4_scale,				matrix4_scale( &M(2)[i], F(0)[i], F(1)[i], F(2)[i] ) )
+
+// Matrix4d
+BENCH_LOOP( matrix4d_multiply,			matrix4d_multiply( &MD(2)[i], &MD(0)[i], &MD(1)[i] ) )
+BENCH_LOOP( matrix4d_inverse,			bench_sink += (float)matrix4d_inverse( &MD(2)[i], &MD(0)[i] ) )
+BENCH_LOOP( matrix4d_determinant,		bench_sink += (float)matrix4d_determinant( &MD(0)[i] ) )
+BENCH_LOOP( matrix4d_to_matrix4,		matrix4d_to_matrix4( &M(2)[i], &MD(0)[i] ) )
+
+// MathTrig.h, math_sincos uses the C library unless built with MYLLY_MATH_FAST_TRIG
+BENCH_LOOP( math_sincos,				float s; float c; math_sincos( F(0)[i] * 10.0f, &s, &c ); bench_sink += s + c )
+BENCH_LOOP( math_sincos_fast,			float s; float c; math_sincos_fast( F(0)[i] * 10.0f, &s, &c ); bench_sink += s + c )
+BENCH_BATCH( math_sincos_array,			math_sincos_array( F(1), F(2), F(0), count ) )
+
+// affine3x4_t
+BENCH_LOOP( affine3x4_identity,			affine3x4_identity( &A(2)[i] ) )
+BENCH_LOOP( affine3x4_from_matrix4,		affine3x4_from_matrix4( &A(2)[i], &M(0)[i] ) )
+BENCH_LOOP( affine3x4_to_matrix4,		affine3x4_to_matrix4( &M(2)[i], &A(0)[i] ) )
+BENCH_LOOP( affine3x4_multiply,			affine3x4_multiply( &A(2)[i], &A(0)[i], &A(1)[i] ) )
+BENCH_LOOP( affine3x4_determinant,		bench_sink += affine3x4_determinant( &A(0)[i] ) )
+BENCH_LOOP( affine3x4_inverse,			bench_sink += affine3x4_inverse( &A(2)[i], &A(0)[i] ) )
+BENCH_LOOP( affine3x4_inverse_rigid,	affine3x4_inverse_rigid( &A(2)[i], &A(0)[i] ) )
+BENCH_LOOP( affine3x4_transform_coord,	affine3x4_transform_coord( &V3(2)[i], &V3(0)[i], &A(0)[0] ) )
+BENCH_LOOP( affine3x4_transform_normal,	affine3x4_transform_normal( &V3(2)[i], &V3(0)[i], &A(0)[0] ) )
+BENCH_BATCH( affine3x4_transform_coord_array, affine3x4_transform_coord_array( V3(2), V3(0), count, 0, &A(0)[0] ) )
+
+// quaternion_t
+BENCH_LOOP( quaternion_multiply,		quaternion_multiply( &Q(2)[i], &Q(0)[i], &Q(1)[i] ) )
+BENCH_LOOP( quaternion_normalize,		Q(2)[i] = Q(0)[i]; quaternion_normalize( &Q(2)[i] ) )
+BENCH_LOOP( quaternion_slerp,			quaternion_slerp( &Q(2)[i], &Q(0)[i], &Q(1)[i], F(0)[i] ) )
+BENCH_LOOP( quaternion_nlerp,			quaternion_nlerp( &Q(2)[i], &Q(0)[i], &Q(1)[i], F(0)[i] ) )
+BENCH_LOOP( quaternion_rotation_yaw_pitch_roll, quaternion_rotation_yaw_pitch_roll( &Q(2)[i], F(0)[i], F(1)[i], F(2)[i] ) )
+BENCH_LOOP( quaternion_to_matrix4,		quaternion_to_matrix4( &M(2)[i], &Q(0)[i] ) )
+BENCH_LOOP( quaternion_from_matrix4,	quaternion_from_matrix4( &Q(2)[i], &M(0)[i] ) )
+BENCH_BATCH( quaternion_to_matrix4_array, quaternion_to_matrix4_array( M(2), Q(0), count ) )
+BENCH_LOOP( quaternion_transform_vector, quaternion_transform_vector( &V3(2)[i], &V3(0)[i], &Q(0)[i] ) )
+
+// transform_tree_t
+BENCH_BATCH( transform_tree_update,		bench_tree_update( count ) )
+
+// Camera.h, the inverses run on the matrices the builders produce.
+BENCH_LOOP( matrix4_look_at,			matrix4_look_at( &M(2)[i], &V3(0)[i], &V3(1)[i], &V3(2)[i] ) )
+BENCH_LOOP( matrix4_perspective,		matrix4_perspective( &M(2)[i], F(0)[i] + 0.5f, 1.5f, 0.1f, 100.0f ) )
+BENCH_LOOP( matrix4_ortho,				matrix4_ortho( &M(2)[i], F(0)[i] + 1.0f, F(1)[i] + 1.0f, 0.1f, 100.0f ) )
+BENCH_LOOP( matrix4_inverse_look_at,	matrix4_look_at( &M(1)[i], &V3(0)[i], &V3(1)[i], &V3(2)[i] ); matrix4_inverse_look_at( &M(2)[i], &M(1)[i] ) )
+BENCH_LOOP( matrix4_inverse_perspective, matrix4_perspective( &M(1)[i], F(0)[i] + 0.5f, 1.5f, 0.1f, 100.0f ); matrix4_inverse_perspective( &M(2)[i], &M(1)[i] ) )
+
+// frustum_t
+BENCH_LOOP( frustum_from_matrix4,		frustum_from_matrix4( &bench_frustum_out, &M(0)[i] ) )
+BENCH_LOOP( frustum_classify_sphere,	bench_sink += (float)frustum_classify_sphere( bench_frustum(), &V3(0)[i], F(0)[i] ) )
+BENCH_LOOP( frustum_classify_aabb,		bench_sink += (float)frustum_classify_aabb( bench_frustum(), &V3(0)[i], &V3(1)[i] ) )
+BENCH_BATCH( frustum_cull_spheres,		bench_sink += (float)frustum_cull_spheres( bench_frustum(), V3(0), F(0), count, bench.mask, NULL ) )
+BENCH_BATCH( frustum_cull_aabbs,		bench_sink += (float)frustum_cull_aabbs( bench_frustum(), V3(0), V3(1), count, bench.mask, NULL ) )
+
+const bench_case_t bench_matrix_cases[] = {
+	BENCH_ENTRY( matrix4_add ),
+	BENCH_ENTRY( matrix4_subtract ),
+	BENCH_ENTRY( matrix4_multiply ),
+	BENCH_ENTRY( matrix4_add_scalar ),
+	BENCH_ENTRY( matrix4_subtract_scalar ),
+	BENCH_ENTRY( matrix4_multiply_scalar ),
+	BENCH_ENTRY( matrix4_divide_scalar ),
+	BENCH_ENTRY( matrix4_identity ),
+	BENCH_ENTRY( matrix4_transpose ),
+	BENCH_ENTRY( matrix4_inverse ),
+	BENCH_ENTRY( matrix4_determinant ),
+	BENCH_ENTRY( matrix4_translation ),
+	BENCH_ENTRY( matrix4_rotation_x ),
+	BENCH_ENTRY( matrix4_rotation_y ),
+	BENCH_ENTRY( matrix4_rotation_z ),
+	BENCH_ENTRY( matrix4_scale ),
+	BENCH_ENTRY( matrix4d_multiply ),
+	BENCH_ENTRY( matrix4d_inverse ),
+	BENCH_ENTRY( matrix4d_determinant ),
+	BENCH_ENTRY( matrix4d_to_matrix4 ),
+	BENCH_ENTRY( math_sincos ),
+	BENCH_ENTRY( math_sincos_fast ),
+	BENCH_ENTRY( math_sincos_array ),
+	BENCH_ENTRY( affine3x4_identity ),
+	BENCH_ENTRY( affine3x4_from_matrix4 ),
+	BENCH_ENTRY( affine3x4_to_matrix4 ),
+	BENCH_ENTRY( affine3x4_multiply ),
+	BENCH_ENTRY( affine3x4_determinant ),
+	BENCH_ENTRY( affine3x4_inverse ),
+	BENCH_ENTRY( affine3x4_inverse_rigid ),
+	BENCH_ENTRY( affine3x4_transform_coord ),
+	BENCH_ENTRY( affine3x4_transform_normal ),
+	BENCH_ENTRY( affine3x4_transform_coord_array ),
+	BENCH_ENTRY( quaternion_multiply ),
+	BENCH_ENTRY( quaternion_normalize ),
+	BENCH_ENTRY( quaternion_slerp ),
+	BENCH_ENTRY( quaternion_nlerp ),
+	BENCH_ENTRY( quaternion_rotation_yaw_pitch_roll ),
+	BENCH_ENTRY( quaternion_to_matrix4 ),
+	BENCH_ENTRY( quaternion_from_matrix4 ),
+	BENCH_ENTRY( quaternion_to_matrix4_array ),
+	BENCH_ENTRY( quaternion_transform_vector ),
+	BENCH_ENTRY( transform_tree_update ),
+	BENCH_ENTRY( matrix4_look_at ),
+	BENCH_ENTRY( matrix4_perspective ),
+	BENCH_ENTRY( matrix4_ortho ),
+	BENCH_ENTRY( matrix4_inverse_look_at ),
+	BENCH_ENTRY( matrix4_inverse_perspective ),
+	BENCH_ENTRY( frustum_from_matrix4 ),
+	BENCH_ENTRY( frustum_classify_sphere ),
+	BENCH_ENTRY( frustum_classify_aabb ),
+	BENCH_ENTRY( frustum_cull_spheres ),
+	BENCH_ENTRY( frustum_cull_aabbs ),
+	BENCH_END
+};
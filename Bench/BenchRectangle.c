@@ -0,0 +1,81 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		BenchRectangle.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Benchmarks for the rectangle functions.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Bench.h"
+
+#define R(j)	bench.rect[j]
+#define VS(j)	bench.vs[j]
+
+#define GRID_ITEMS	4096
+
+// A grid holding the first GRID_ITEMS input rectangles, built on first use.
+static rect_grid_t* bench_grid( void )
+{
+	static rect_grid_t grid;
+	static bool created = false;
+	rectangle_t bounds;
+	uint32 i;
+
+	if ( !created )
+	{
+		bounds.x = 0; bounds.y = 0;
+		bounds.w = 1536; bounds.h = 1536;
+
+		rect_grid_create( &grid, &bounds, 64 );
+
+		for ( i = 0; i < GRID_ITEMS && i < bench.capacity; i++ )
+			rect_grid_insert( &grid, &R(0)[i], NULL );
+
+		created = true;
+	}
+
+	return &grid;
+}
+
+static uint32 bench_grid_results[GRID_ITEMS];
+
+// Builds a dirty region out of 32 rectangles at a time.
+static region_t bench_region, bench_region_out;
+
+static void bench_region_add( uint32 i )
+{
+	if ( ( i & 31 ) == 0 ) region_clear( &bench_region );
+	region_union_rect( &bench_region, &bench_region, &R(0)[i] );
+}
+
+BENCH_LOOP( rect_is_point_in,			bench_sink += (float)rect_is_point_in( &R(0)[i], VS(0)[i].ux, VS(0)[i].uy ) )
+BENCH_LOOP( rect_is_in,					bench_sink += (float)rect_is_in( &R(0)[i], &R(1)[i] ) )
+BENCH_LOOP( rect_equals,				bench_sink += (float)rect_equals( &R(0)[i], &R(1)[i] ) )
+BENCH_LOOP( rect_clip,					bench_sink += (float)rect_clip( &R(2)[i], &R(0)[i], &R(1)[0] ) )
+BENCH_BATCH( rect_clip_array,			bench_sink += (float)rect_clip_array( R(2), bench.mask, R(0), count, &R(1)[0] ) )
+
+// RectangleGrid.h
+BENCH_LOOP( rect_grid_query_point,		bench_sink += (float)rect_grid_query_point( bench_grid(), VS(0)[i].ux, VS(0)[i].uy, bench_grid_results, GRID_ITEMS ) )
+BENCH_LOOP( rect_grid_query_rect,		bench_sink += (float)rect_grid_query_rect( bench_grid(), &R(1)[i], bench_grid_results, GRID_ITEMS ) )
+BENCH_LOOP( region_union_rect,			bench_region_add( i ) )
+BENCH_LOOP( region_subtract_rect,		region_subtract_rect( &bench_region_out, &bench_region, &R(1)[i] ) )
+BENCH_LOOP( region_test_rect,			bench_sink += (float)region_test_rect( &bench_region, &R(1)[i] ) )
+BENCH_LOOP( rect_grid_update,			rect_grid_update( bench_grid(), i % GRID_ITEMS, &R(1)[i] ) )
+
+const bench_case_t bench_rectangle_cases[] = {
+	BENCH_ENTRY( rect_is_point_in ),
+	BENCH_ENTRY( rect_is_in ),
+	BENCH_ENTRY( rect_equals ),
+	BENCH_ENTRY( rect_clip ),
+	BENCH_ENTRY( rect_clip_array ),
+	BENCH_ENTRY( rect_grid_query_point ),
+	BENCH_ENTRY( rect_grid_query_rect ),
+	BENCH_ENTRY( rect_grid_update ),
+	BENCH_ENTRY( region_union_rect ),
+	BENCH_ENTRY( region_subtract_rect ),
+	BENCH_ENTRY( region_test_rect ),
+	BENCH_END
+};
@@ -0,0 +1,377 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		BenchVector.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Benchmarks for the vector functions.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Bench.h"
+
+#define V2(j)	bench.v2[j]
+#define V3(j)	bench.v3[j]
+#define V3D(j)	bench.v3d[j]
+#define V4(j)	bench.v4[j]
+#define VS(j)	bench.vs[j]
+#define SOA3(j)	bench.soa3[j]
+#define SOA4(j)	bench.soa4[j]
+#define F(j)	bench.f[j]
+#define AABB(j)	bench.aabb[j]
+
+// A camera 20 units behind the bench points looking at the origin, built on first use.
+static const matrix4_t* bench_view_proj( void )
+{
+	static matrix4_t view_proj;
+	static bool created = false;
+	vector3_t eye = { { 0.0f, 0.0f, -20.0f } }, at = { { 0.0f, 0.0f, 0.0f } }, up = { { 0.0f, 1.0f, 0.0f } };
+	matrix4_t view, proj;
+
+	if ( !created )
+	{
+		matrix4_look_at( &view, &eye, &at, &up );
+		matrix4_perspective( &proj, 1.0f, 16.0f / 9.0f, 0.1f, 100.0f );
+		matrix4_multiply( &view_proj, &view, &proj );
+		created = true;
+	}
+
+	return &view_proj;
+}
+
+// vector2_t
+BENCH_LOOP( vector2_add,					vector2_add( &V2(2)[i], &V2(0)[i], &V2(1)[i] ) )
+BENCH_LOOP( vector2_subtract,				vector2_subtract( &V2(2)[i], &V2(0)[i], &V2(1)[i] ) )
+BENCH_LOOP( vector2_multiply,				vector2_multiply( &V2(2)[i], &V2(0)[i], F(0)[i] ) )
+BENCH_LOOP( vector2_divide,					vector2_divide( &V2(2)[i], &V2(0)[i], F(0)[i] + 1.0f ) )
+BENCH_LOOP( vector2_add_scalar,				vector2_add_scalar( &V2(2)[i], &V2(0)[i], F(0)[i] ) )
+BENCH_LOOP( vector2_subtract_scalar,		vector2_subtract_scalar( &V2(2)[i], &V2(0)[i], F(0)[i] ) )
+BENCH_LOOP( vector2_dot,					bench_sink += vector2_dot( &V2(0)[i], &V2(1)[i] ) )
+BENCH_LOOP( vector2_angle,					bench_sink += vector2_angle( &V2(0)[i], &V2(1)[i] ) )
+BENCH_LOOP( vector2_length,					bench_sink += vector2_length( &V2(0)[i] ) )
+BENCH_LOOP( vector2_length_sq,				bench_sink += vector2_length_sq( &V2(0)[i] ) )
+BENCH_LOOP( vector2_distance,				bench_sink += vector2_distance( &V2(0)[i], &V2(1)[i] ) )
+BENCH_LOOP( vector2_distance_sq,			bench_sink += vector2_distance_sq( &V2(0)[i], &V2(1)[i] ) )
+BENCH_LOOP( vector2_normalize,				V2(2)[i] = V2(0)[i]; vector2_normalize( &V2(2)[i] ) )
+BENCH_BATCH( vector2_normalize_array,		vector2_normalize_array( V2(2), V2(0), count ) )
+BENCH_BATCH( vector2_normalize_array_fast,	vector2_normalize_array_fast( V2(2), V2(0), count ) )
+BENCH_BATCH( vector2_length_array,		vector2_length_array( F(2), V2(0), count ) )
+BENCH_LOOP( vector2_lerp,					vector2_lerp( &V2(2)[i], &V2(0)[i], &V2(1)[i], F(0)[i] ) )
+
+// vector3_t
+BENCH_LOOP( vector3_add,					vector3_add( &V3(2)[i], &V3(0)[i], &V3(1)[i] ) )
+BENCH_LOOP( vector3_subtract,				vector3_subtract( &V3(2)[i], &V3(0)[i], &V3(1)[i] ) )
+BENCH_LOOP( vector3_multiply,				vector3_multiply( &V3(2)[i], &V3(0)[i], F(0)[i] ) )
+BENCH_LOOP( vector3_divide,					vector3_divide( &V3(2)[i], &V3(0)[i], F(0)[i] + 1.0f ) )
+BENCH_LOOP( vector3_add_scalar,				vector3_add_scalar( &V3(2)[i], &V3(0)[i], F(0)[i] ) )
+BENCH_LOOP( vector3_subtract_scalar,		vector3_subtract_scalar( &V3(2)[i], &V3(0)[i], F(0)[i] ) )
+BENCH_LOOP( vector3_dot,					bench_sink += vector3_dot( &V3(0)[i], &V3(1)[i] ) )
+BENCH_LOOP( vector3_cross,					vector3_cross( &V3(2)[i], &V3(0)[i], &V3(1)[i] ) )
+BENCH_LOOP( vector3_angle,					bench_sink += vector3_angle( &V3(0)[i], &V3(1)[i] ) )
+BENCH_LOOP( vector3_is_zero,				bench_sink += (float)vector3_is_zero( &V3(0)[i] ) )
+BENCH_LOOP( vector3_length,					bench_sink += vector3_length( &V3(0)[i] ) )
+BENCH_LOOP( vector3_length_sq,				bench_sink += vector3_length_sq( &V3(0)[i] ) )
+BENCH_LOOP( vector3_distance,				bench_sink += vector3_distance( &V3(0)[i], &V3(1)[i] ) )
+BENCH_LOOP( vector3_distance_sq,			bench_sink += vector3_distance_sq( &V3(0)[i], &V3(1)[i] ) )
+BENCH_LOOP( vector3_difference,				vector3_difference( &V3(2)[i], &V3(0)[i], &V3(1)[i] ) )
+BENCH_LOOP( vector3_normalize,				V3(2)[i] = V3(0)[i]; vector3_normalize( &V3(2)[i] ) )
+BENCH_BATCH( vector3_normalize_array,		vector3_normalize_array( V3(2), V3(0), count ) )
+BENCH_BATCH( vector3_normalize_array_fast,	vector3_normalize_array_fast( V3(2), V3(0), count ) )
+BENCH_BATCH( vector3_length_array,		vector3_length_array( F(2), V3(0), count ) )
+BENCH_LOOP( vector3_lerp,					vector3_lerp( &V3(2)[i], &V3(0)[i], &V3(1)[i], F(0)[i] ) )
+BENCH_LOOP( vector3_transform_coord,		vector3_transform_coord( &V3(2)[i], &V3(0)[i], &bench.mat[0][0] ) )
+BENCH_BATCH( vector3_transform_coord_array, vector3_transform_coord_array( V3(2), V3(0), count, 0, &bench.mat[0][0] ) )
+BENCH_BATCH( math_pool_transform_coord_array, math_pool_transform_coord_array( bench.pool, V3(2), V3(0), count, 0, &bench.mat[0][0] ) )
+BENCH_LOOP( vector3d_transform_coord,		vector3d_transform_coord( &V3D(2)[i], &V3D(0)[i], &bench.matd[0][0] ) )
+BENCH_BATCH( vector3d_transform_coord_array, vector3d_transform_coord_array( V3D(2), V3D(0), count, 0, &bench.matd[0][0] ) )
+BENCH_BATCH( vector3d_to_view_array,		vector3d_to_view_array( V3(2), V3D(0), count, &bench.matd[0][0] ) )
+BENCH_BATCH( vector3_project_array,		bench_sink += (float)vector3_project_array( VS(2), bench.clip, V3(0), count, 0, bench_view_proj(), &bench.rect[0][0] ) )
+
+// Packed formats, one vector4_t per op
+BENCH_LOOP( math_pack_half,				((uint16*)bench.packed)[i] = math_pack_half( F(0)[i] ) )
+BENCH_BATCH( math_pack_half_array,		math_pack_half_array( (uint16*)bench.packed, V4(0)[0].coords, count * 4 ) )
+BENCH_BATCH( math_unpack_half_array,	math_unpack_half_array( V4(2)[0].coords, bench.half, count * 4 ) )
+BENCH_BATCH( math_pack_snorm16_array,	math_pack_snorm16_array( (int16*)bench.packed, V4(0)[0].coords, count * 4 ) )
+BENCH_BATCH( math_unpack_snorm16_array,	math_unpack_snorm16_array( V4(2)[0].coords, (const int16*)bench.packed, count * 4 ) )
+BENCH_BATCH( math_pack_unorm8_array,	math_pack_unorm8_array( (uint8*)bench.packed, V4(0)[0].coords, count * 4 ) )
+BENCH_BATCH( math_unpack_unorm8_array,	math_unpack_unorm8_array( V4(2)[0].coords, (const uint8*)bench.packed, count * 4 ) )
+BENCH_BATCH( vector4_pack_unorm1010102_array, vector4_pack_unorm1010102_array( bench.packed, V4(0), count ) )
+BENCH_BATCH( vector4_unpack_unorm1010102_array, vector4_unpack_unorm1010102_array( V4(2), bench.packed, count ) )
+BENCH_BATCH( vector3_pack_oct16_array,	vector3_pack_oct16_array( (int16*)bench.packed, bench.normals, count ) )
+BENCH_BATCH( vector3_unpack_oct16_array, vector3_unpack_oct16_array( V3(2), (const int16*)bench.packed, count ) )
+BENCH_BATCH( vector3_pack_oct8_array,	vector3_pack_oct8_array( (int8*)bench.packed, bench.normals, count ) )
+BENCH_BATCH( vector3_unpack_oct8_array,	vector3_unpack_oct8_array( V3(2), (const int8*)bench.packed, count ) )
+
+// vector4_t
+BENCH_LOOP( vector4_add,					vector4_add( &V4(2)[i], &V4(0)[i], &V4(1)[i] ) )
+BENCH_LOOP( vector4_subtract,				vector4_subtract( &V4(2)[i], &V4(0)[i], &V4(1)[i] ) )
+BENCH_LOOP( vector4_multiply,				vector4_multiply( &V4(2)[i], &V4(0)[i], F(0)[i] ) )
+BENCH_LOOP( vector4_divide,					vector4_divide( &V4(2)[i], &V4(0)[i], F(0)[i] + 1.0f ) )
+BENCH_LOOP( vector4_add_scalar,				vector4_add_scalar( &V4(2)[i], &V4(0)[i], F(0)[i] ) )
+BENCH_LOOP( vector4_subtract_scalar,		vector4_subtract_scalar( &V4(2)[i], &V4(0)[i], F(0)[i] ) )
+BENCH_LOOP( vector4_dot,					bench_sink += vector4_dot( &V4(0)[i], &V4(1)[i] ) )
+BENCH_LOOP( vector4_angle,					bench_sink += vector4_angle( &V4(0)[i], &V4(1)[i] ) )
+BENCH_LOOP( vector4_length,					bench_sink += vector4_length( &V4(0)[i] ) )
+BENCH_LOOP( vector4_length_sq,				bench_sink += vector4_length_sq( &V4(0)[i] ) )
+BENCH_LOOP( vector4_distance,				bench_sink += vector4_distance( &V4(0)[i], &V4(1)[i] ) )
+BENCH_LOOP( vector4_distance_sq,			bench_sink += vector4_distance_sq( &V4(0)[i], &V4(1)[i] ) )
+BENCH_LOOP( vector4_normalize,				V4(2)[i] = V4(0)[i]; vector4_normalize( &V4(2)[i] ) )
+BENCH_BATCH( vector4_normalize_array,		vector4_normalize_array( V4(2), V4(0), count ) )
+BENCH_BATCH( vector4_normalize_array_fast,	vector4_normalize_array_fast( V4(2), V4(0), count ) )
+BENCH_BATCH( vector4_length_array,		vector4_length_array( F(2), V4(0), count ) )
+BENCH_LOOP( vector4_lerp,					vector4_lerp( &V4(2)[i], &V4(0)[i], &V4(1)[i], F(0)[i] ) )
+
+// vectorscreen_t
+BENCH_LOOP( vectorscreen_add,				vectorscreen_add( &VS(2)[i], &VS(0)[i], &VS(1)[i] ) )
+BENCH_LOOP( vectorscreen_subtract,			vectorscreen_subtract( &VS(2)[i], &VS(0)[i], &VS(1)[i] ) )
+BENCH_LOOP( vectorscreen_multiply,			vectorscreen_multiply( &VS(2)[i], &VS(0)[i], F(0)[i] ) )
+BENCH_LOOP( vectorscreen_divide,			vectorscreen_divide( &VS(2)[i], &VS(0)[i], F(0)[i] + 1.0f ) )
+BENCH_LOOP( vectorscreen_add_scalar,		vectorscreen_add_scalar( &VS(2)[i], &VS(0)[i], F(0)[i] ) )
+BENCH_LOOP( vectorscreen_subtract_scalar,	vectorscreen_subtract_scalar( &VS(2)[i], &VS(0)[i], F(0)[i] ) )
+BENCH_LOOP( vectorscreen_dot,				bench_sink += vectorscreen_dot( &VS(0)[i], &VS(1)[i] ) )
+BENCH_LOOP( vectorscreen_angle,				bench_sink += vectorscreen_angle( &VS(0)[i], &VS(1)[i] ) )
+BENCH_LOOP( vectorscreen_length,			bench_sink += vectorscreen_length( &VS(0)[i] ) )
+BENCH_LOOP( vectorscreen_length_sq,			bench_sink += vectorscreen_length_sq( &VS(0)[i] ) )
+BENCH_LOOP( vectorscreen_distance,			bench_sink += vectorscreen_distance( &VS(0)[i], &VS(1)[i] ) )
+BENCH_LOOP( vectorscreen_distance_sq,		bench_sink += vectorscreen_distance_sq( &VS(0)[i], &VS(1)[i] ) )
+BENCH_LOOP( vectorscreen_normalize,			VS(2)[i] = VS(0)[i]; vectorscreen_normalize( &VS(2)[i] ) )
+BENCH_LOOP( vectorscreen_lerp,				vectorscreen_lerp( &VS(2)[i], &VS(0)[i], &VS(1)[i], F(0)[i] ) )
+
+// vector3_soa_t
+BENCH_BATCH( vector3_soa_pack, vector3_soa_pack( &SOA3(2), V3(0), count ) )
+BENCH_BATCH( vector3_soa_unpack, SOA3(0).count = count; vector3_soa_unpack( V3(2), &SOA3(0) ) )
+BENCH_BATCH( vector3_soa_add, SOA3(0).count = SOA3(1).count = count; vector3_soa_add( &SOA3(2), &SOA3(0), &SOA3(1) ) )
+BENCH_BATCH( vector3_soa_subtract, SOA3(0).count = SOA3(1).count = count; vector3_soa_subtract( &SOA3(2), &SOA3(0), &SOA3(1) ) )
+BENCH_BATCH( vector3_soa_scale, SOA3(0).count = count; vector3_soa_scale( &SOA3(2), &SOA3(0), 2.0f ) )
+BENCH_BATCH( vector3_soa_dot, SOA3(0).count = SOA3(1).count = count; vector3_soa_dot( F(2), &SOA3(0), &SOA3(1) ) )
+BENCH_BATCH( vector3_soa_cross, SOA3(0).count = SOA3(1).count = count; vector3_soa_cross( &SOA3(2), &SOA3(0), &SOA3(1) ) )
+BENCH_BATCH( vector3_soa_length, SOA3(0).count = count; vector3_soa_length( F(2), &SOA3(0) ) )
+BENCH_BATCH( vector3_soa_normalize, SOA3(0).count = count; vector3_soa_normalize( &SOA3(2), &SOA3(0) ) )
+BENCH_BATCH( vector3_soa_lerp, SOA3(0).count = SOA3(1).count = count; vector3_soa_lerp( &SOA3(2), &SOA3(0), &SOA3(1), 0.5f ) )
+
+// vector4_soa_t
+BENCH_BATCH( vector4_soa_pack, vector4_soa_pack( &SOA4(2), V4(0), count ) )
+BENCH_BATCH( vector4_soa_unpack, SOA4(0).count = count; vector4_soa_unpack( V4(2), &SOA4(0) ) )
+BENCH_BATCH( vector4_soa_add, SOA4(0).count = SOA4(1).count = count; vector4_soa_add( &SOA4(2), &SOA4(0), &SOA4(1) ) )
+BENCH_BATCH( vector4_soa_subtract, SOA4(0).count = SOA4(1).count = count; vector4_soa_subtract( &SOA4(2), &SOA4(0), &SOA4(1) ) )
+BENCH_BATCH( vector4_soa_scale, SOA4(0).count = count; vector4_soa_scale( &SOA4(2), &SOA4(0), 2.0f ) )
+BENCH_BATCH( vector4_soa_dot, SOA4(0).count = SOA4(1).count = count; vector4_soa_dot( F(2), &SOA4(0), &SOA4(1) ) )
+BENCH_BATCH( vector4_soa_length, SOA4(0).count = count; vector4_soa_length( F(2), &SOA4(0) ) )
+BENCH_BATCH( vector4_soa_normalize, SOA4(0).count = count; vector4_soa_normalize( &SOA4(2), &SOA4(0) ) )
+BENCH_BATCH( vector4_soa_lerp, SOA4(0).count = SOA4(1).count = count; vector4_soa_lerp( &SOA4(2), &SOA4(0), &SOA4(1), 0.5f ) )
+
+// aabb3_t
+BENCH_LOOP( aabb3_merge,					aabb3_merge( &AABB(2)[i], &AABB(0)[i], &AABB(1)[i] ) )
+BENCH_LOOP( aabb3_expand,					aabb3_expand( &AABB(2)[i], &AABB(0)[i], &V3(1)[i] ) )
+BENCH_LOOP( aabb3_transform,				aabb3_transform( &AABB(2)[i], &AABB(0)[i], &bench.mat[0][i] ) )
+BENCH_LOOP( aabb3_overlaps,					bench_sink += (float)aabb3_overlaps( &AABB(0)[i], &AABB(1)[i] ) )
+BENCH_LOOP( aabb3_contains,					bench_sink += (float)aabb3_contains( &AABB(0)[i], &AABB(1)[i] ) )
+BENCH_BATCH( aabb3_from_points,				aabb3_from_points( &AABB(2)[0], V3(0), count, 0 ) )
+
+static bvh_t		bench_bvh;
+static ray3_t*		bench_rays = NULL;
+static bvh_hit_t*	bench_hits = NULL;
+static uint32		bench_query_results[64];
+
+// A tree over all the bench boxes and rays shot through them along +z from a regular grid, so
+// neighbouring rays are coherent. Created on first use.
+static void bench_bvh_init( void )
+{
+	uint32 i, side;
+
+	if ( bench_rays != NULL ) return;
+
+	bvh_build( &bench_bvh, AABB(0), bench.capacity );
+
+	bench_rays = (ray3_t*)bench_alloc( bench.capacity * sizeof( ray3_t ) );
+	bench_hits = (bvh_hit_t*)bench_alloc( bench.capacity * sizeof( bvh_hit_t ) );
+
+	for ( side = 1; side * side < bench.capacity; side++ );
+
+	for ( i = 0; i < bench.capacity; i++ )
+	{
+		bench_rays[i].origin.x = -10.0f + 20.0f * (float)( i % side ) / side;
+		bench_rays[i].origin.y = -10.0f + 20.0f * (float)( i / side ) / side;
+		bench_rays[i].origin.z = -20.0f;
+		bench_rays[i].direction.x = 0.01f * V3(1)[i].x;
+		bench_rays[i].direction.y = 0.01f * V3(1)[i].y;
+		bench_rays[i].direction.z = 1.0f;
+	}
+}
+
+static void bench_bvh_rebuild( uint32 count )
+{
+	bvh_t bvh;
+
+	bvh_build( &bvh, AABB(0), count );
+	bench_sink += (float)bvh.num_nodes;
+	bvh_destroy( &bvh );
+}
+
+static void bench_bvh_raycast( uint32 count )
+{
+	uint32 i;
+
+	bench_bvh_init();
+
+	for ( i = 0; i < count; i++ )
+		bench_sink += (float)bvh_raycast( &bench_bvh, &bench_rays[i], 100.0f, NULL, NULL, &bench_hits[i] );
+}
+
+static void bench_bvh_raycast_array( uint32 count )
+{
+	bench_bvh_init();
+	bench_sink += (float)bvh_raycast_array( &bench_bvh, bench_rays, count, 100.0f, NULL, NULL, bench_hits );
+}
+
+static void bench_bvh_query_aabb( uint32 count )
+{
+	uint32 i;
+
+	bench_bvh_init();
+
+	for ( i = 0; i < count; i++ )
+		bench_sink += (float)bvh_query_aabb( &bench_bvh, &AABB(1)[i], bench_query_results, 64 );
+}
+
+// Refits a tree over the first count boxes, the tree is rebuilt when the batch size changes.
+static void bench_bvh_refit( uint32 count )
+{
+	static bvh_t bvh;
+	static uint32 built = 0;
+
+	if ( built != count )
+	{
+		bvh_destroy( &bvh );
+		bvh_build( &bvh, AABB(0), count );
+		built = count;
+	}
+
+	bvh_refit( &bvh, AABB(1) );
+}
+
+// bvh_t
+BENCH_BATCH( bvh_build,						bench_bvh_rebuild( count ) )
+
+const bench_case_t bench_vector_cases[] = {
+	BENCH_ENTRY( vector2_add ),
+	BENCH_ENTRY( vector2_subtract ),
+	BENCH_ENTRY( vector2_multiply ),
+	BENCH_ENTRY( vector2_divide ),
+	BENCH_ENTRY( vector2_add_scalar ),
+	BENCH_ENTRY( vector2_subtract_scalar ),
+	BENCH_ENTRY( vector2_dot ),
+	BENCH_ENTRY( vector2_angle ),
+	BENCH_ENTRY( vector2_length ),
+	BENCH_ENTRY( vector2_length_sq ),
+	BENCH_ENTRY( vector2_distance ),
+	BENCH_ENTRY( vector2_distance_sq ),
+	BENCH_ENTRY( vector2_normalize ),
+	BENCH_ENTRY( vector2_normalize_array ),
+	BENCH_ENTRY( vector2_normalize_array_fast ),
+	BENCH_ENTRY( vector2_length_array ),
+	BENCH_ENTRY( vector2_lerp ),
+	BENCH_ENTRY( vector3_add ),
+	BENCH_ENTRY( vector3_subtract ),
+	BENCH_ENTRY( vector3_multiply ),
+	BENCH_ENTRY( vector3_divide ),
+	BENCH_ENTRY( vector3_add_scalar ),
+	BENCH_ENTRY( vector3_subtract_scalar ),
+	BENCH_ENTRY( vector3_dot ),
+	BENCH_ENTRY( vector3_cross ),
+	BENCH_ENTRY( vector3_angle ),
+	BENCH_ENTRY( vector3_is_zero ),
+	BENCH_ENTRY( vector3_length ),
+	BENCH_ENTRY( vector3_length_sq ),
+	BENCH_ENTRY( vector3_distance ),
+	BENCH_ENTRY( vector3_distance_sq ),
+	BENCH_ENTRY( vector3_difference ),
+	BENCH_ENTRY( vector3_normalize ),
+	BENCH_ENTRY( vector3_normalize_array ),
+	BENCH_ENTRY( vector3_normalize_array_fast ),
+	BENCH_ENTRY( vector3_length_array ),
+	BENCH_ENTRY( vector3_lerp ),
+	BENCH_ENTRY( vector3_transform_coord ),
+	BENCH_ENTRY( vector3_transform_coord_array ),
+	BENCH_ENTRY( math_pool_transform_coord_array ),
+	BENCH_ENTRY( vector3d_transform_coord ),
+	BENCH_ENTRY( vector3d_transform_coord_array ),
+	BENCH_ENTRY( vector3d_to_view_array ),
+	BENCH_ENTRY( vector3_project_array ),
+	BENCH_ENTRY( math_pack_half ),
+	BENCH_ENTRY( math_pack_half_array ),
+	BENCH_ENTRY( math_unpack_half_array ),
+	BENCH_ENTRY( math_pack_snorm16_array ),
+	BENCH_ENTRY( math_unpack_snorm16_array ),
+	BENCH_ENTRY( math_pack_unorm8_array ),
+	BENCH_ENTRY( math_unpack_unorm8_array ),
+	BENCH_ENTRY( vector4_pack_unorm1010102_array ),
+	BENCH_ENTRY( vector4_unpack_unorm1010102_array ),
+	BENCH_ENTRY( vector3_pack_oct16_array ),
+	BENCH_ENTRY( vector3_unpack_oct16_array ),
+	BENCH_ENTRY( vector3_pack_oct8_array ),
+	BENCH_ENTRY( vector3_unpack_oct8_array ),
+	BENCH_ENTRY( vector4_add ),
+	BENCH_ENTRY( vector4_subtract ),
+	BENCH_ENTRY( vector4_multiply ),
+	BENCH_ENTRY( vector4_divide ),
+	BENCH_ENTRY( vector4_add_scalar ),
+	BENCH_ENTRY( vector4_subtract_scalar ),
+	BENCH_ENTRY( vector4_dot ),
+	BENCH_ENTRY( vector4_angle ),
+	BENCH_ENTRY( vector4_length ),
+	BENCH_ENTRY( vector4_length_sq ),
+	BENCH_ENTRY( vector4_distance ),
+	BENCH_ENTRY( vector4_distance_sq ),
+	BENCH_ENTRY( vector4_normalize ),
+	BENCH_ENTRY( vector4_normalize_array ),
+	BENCH_ENTRY( vector4_normalize_array_fast ),
+	BENCH_ENTRY( vector4_length_array ),
+	BENCH_ENTRY( vector4_lerp ),
+	BENCH_ENTRY( vectorscreen_add ),
+	BENCH_ENTRY( vectorscreen_subtract ),
+	BENCH_ENTRY( vectorscreen_multiply ),
+	BENCH_ENTRY( vectorscreen_divide ),
+	BENCH_ENTRY( vectorscreen_add_scalar ),
+	BENCH_ENTRY( vectorscreen_subtract_scalar ),
+	BENCH_ENTRY( vectorscreen_dot ),
+	BENCH_ENTRY( vectorscreen_angle ),
+	BENCH_ENTRY( vectorscreen_length ),
+	BENCH_ENTRY( vectorscreen_length_sq ),
+	BENCH_ENTRY( vectorscreen_distance ),
+	BENCH_ENTRY( vectorscreen_distance_sq ),
+	BENCH_ENTRY( vectorscreen_normalize ),
+	BENCH_ENTRY( vectorscreen_lerp ),
+	BENCH_ENTRY( vector3_soa_pack ),
+	BENCH_ENTRY( vector3_soa_unpack ),
+	BENCH_ENTRY( vector3_soa_add ),
+	BENCH_ENTRY( vector3_soa_subtract ),
+	BENCH_ENTRY( vector3_soa_scale ),
+	BENCH_ENTRY( vector3_soa_dot ),
+	BENCH_ENTRY( vector3_soa_cross ),
+	BENCH_ENTRY( vector3_soa_length ),
+	BENCH_ENTRY( vector3_soa_normalize ),
+	BENCH_ENTRY( vector3_soa_lerp ),
+	BENCH_ENTRY( vector4_soa_pack ),
+	BENCH_ENTRY( vector4_soa_unpack ),
+	BENCH_ENTRY( vector4_soa_add ),
+	BENCH_ENTRY( vector4_soa_subtract ),
+	BENCH_ENTRY( vector4_soa_scale ),
+	BENCH_ENTRY( vector4_soa_dot ),
+	BENCH_ENTRY( vector4_soa_length ),
+	BENCH_ENTRY( vector4_soa_normalize ),
+	BENCH_ENTRY( vector4_soa_lerp ),
+	BENCH_ENTRY( aabb3_merge ),
+	BENCH_ENTRY( aabb3_expand ),
+	BENCH_ENTRY( aabb3_transform ),
+	BENCH_ENTRY( aabb3_overlaps ),
+	BENCH_ENTRY( aabb3_contains ),
+	BENCH_ENTRY( aabb3_from_points ),
+	BENCH_ENTRY( bvh_build ),
+	BENCH_ENTRY( bvh_refit ),
+	BENCH_ENTRY( bvh_raycast ),
+	BENCH_ENTRY( bvh_raycast_array ),
+	BENCH_ENTRY( bvh_query_aabb ),
+	BENCH_END
+};
@@ -0,0 +1,539 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Bvh.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Bounding volume hierarchy for ray and overlap queries.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/Bvh.h"
+#include "Math/MathSimd.h"
+#include "Math/MathUtils.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define BVH_BINS			16
+#define BVH_MIN_LEAF		2		// Nodes with this many primitives or fewer are always leaves
+#define BVH_MAX_LEAF		16		// Nodes with more primitives than this are always split
+#define BVH_MAX_DEPTH		64		// Also the size of the traversal stack
+#define BVH_MEDIAN_DEPTH	( BVH_MAX_DEPTH - 32 )	// Below this split at the median so we never exceed BVH_MAX_DEPTH
+#define BVH_TRAVERSAL_COST	1.0f	// Cost of visiting a node relative to testing one primitive
+
+typedef struct
+{
+	bvh_t*				bvh;
+	const aabb3_t*		bounds;
+	vector3_t*			centroids;
+} bvh_builder_t;
+
+typedef struct
+{
+	aabb3_t		bounds;
+	uint32		count;
+} bvh_bin_t;
+
+// --------------------------------------------------
+// Building
+// --------------------------------------------------
+
+static MYLLY_INLINE uint32 bvh_bin_index( float c, float min, float scale )
+{
+	int32 bin = (int32)( ( c - min ) * scale );
+	return (uint32)math_clamp( bin, 0, BVH_BINS - 1 );
+}
+
+// Finds the cheapest binned split. Returns false if splitting isn't worth it.
+static bool bvh_find_split( bvh_builder_t* b, uint32 first, uint32 count, const aabb3_t* centroid_bounds,
+							float parent_area, uint32* best_axis, uint32* best_bin )
+{
+	bvh_bin_t bins[BVH_BINS];
+	float left_area[BVH_BINS], best_cost, cost, extent, scale;
+	uint32 left_count[BVH_BINS], axis, i, bin, n;
+	aabb3_t acc;
+	const uint32* indices = b->bvh->indices;
+
+	best_cost = (float)count * parent_area;	// Cost of making this node a leaf
+	*best_axis = 3;
+
+	for ( axis = 0; axis < 3; axis++ )
+	{
+		extent = centroid_bounds->max.coords[axis] - centroid_bounds->min.coords[axis];
+		if ( extent <= 0.0f ) continue;
+
+		scale = BVH_BINS / extent;
+
+		for ( i = 0; i < BVH_BINS; i++ )
+		{
+			aabb3_empty( &bins[i].bounds );
+			bins[i].count = 0;
+		}
+
+		for ( i = first; i < first + count; i++ )
+		{
+			bin = bvh_bin_index( b->centroids[indices[i]].coords[axis], centroid_bounds->min.coords[axis], scale );
+			aabb3_merge( &bins[bin].bounds, &bins[bin].bounds, &b->bounds[indices[i]] );
+			bins[bin].count++;
+		}
+
+		// Sweep from the left to get the cost of everything left of each split...
+		aabb3_empty( &acc );
+		for ( i = 0, n = 0; i < BVH_BINS - 1; i++ )
+		{
+			aabb3_merge( &acc, &acc, &bins[i].bounds );
+			n += bins[i].count;
+			left_area[i] = aabb3_surface_area( &acc );
+			left_count[i] = n;
+		}
+
+		// ...and then from the right to complete it.
+		aabb3_empty( &acc );
+		for ( i = BVH_BINS - 1, n = 0; i > 0; i-- )
+		{
+			aabb3_merge( &acc, &acc, &bins[i].bounds );
+			n += bins[i].count;
+
+			if ( n == 0 || left_count[i-1] == 0 ) continue;
+
+			cost = BVH_TRAVERSAL_COST * parent_area + left_area[i-1] * left_count[i-1] + aabb3_surface_area( &acc ) * n;
+
+			if ( cost < best_cost )
+			{
+				best_cost = cost;
+				*best_axis = axis;
+				*best_bin = i;
+			}
+		}
+	}
+
+	return *best_axis < 3;
+}
+
+static void bvh_build_node( bvh_builder_t* b, uint32 node, uint32 first, uint32 count, uint32 depth )
+{
+	bvh_t* bvh = b->bvh;
+	bvh_node_t* n = &bvh->nodes[node];
+	aabb3_t centroid_bounds;
+	uint32 i, j, axis = 0, bin = 0, mid, tmp;
+	float min, scale;
+	bool split;
+
+	aabb3_empty( &n->bounds );
+	aabb3_empty( &centroid_bounds );
+
+	for ( i = first; i < first + count; i++ )
+	{
+		aabb3_merge( &n->bounds, &n->bounds, &b->bounds[bvh->indices[i]] );
+		aabb3_expand( &centroid_bounds, &centroid_bounds, &b->centroids[bvh->indices[i]] );
+	}
+
+	n->offset = first;
+	n->count = (uint16)count;
+	n->axis = 0;
+
+	if ( count <= BVH_MIN_LEAF ) return;
+
+	if ( depth < BVH_MEDIAN_DEPTH )
+		split = bvh_find_split( b, first, count, &centroid_bounds, aabb3_surface_area( &n->bounds ), &axis, &bin );
+	else
+		split = false;
+
+	if ( !split && count <= BVH_MAX_LEAF && depth < BVH_MEDIAN_DEPTH ) return;
+
+	mid = first;
+
+	if ( split )
+	{
+		// Partition the primitives around the chosen bin.
+		min = centroid_bounds.min.coords[axis];
+		scale = BVH_BINS / ( centroid_bounds.max.coords[axis] - min );
+
+		for ( i = first, j = first + count; i < j; )
+		{
+			if ( bvh_bin_index( b->centroids[bvh->indices[i]].coords[axis], min, scale ) < bin )
+			{
+				i++;
+			}
+			else
+			{
+				tmp = bvh->indices[i];
+				bvh->indices[i] = bvh->indices[--j];
+				bvh->indices[j] = tmp;
+			}
+		}
+
+		mid = i;
+	}
+
+	// No useful split but too many primitives for a leaf (all centroids are the same, or we're too
+	// deep): split the list in half.
+	if ( mid == first || mid == first + count )
+	{
+		axis = 0;
+		mid = first + count / 2;
+	}
+
+	n->axis = (uint16)axis;
+	n->count = 0;
+
+	bvh_build_node( b, bvh->num_nodes++, first, mid - first, depth + 1 );
+
+	// The left subtree is complete, the right child goes right after it.
+	n = &bvh->nodes[node];
+	n->offset = bvh->num_nodes++;
+	bvh_build_node( b, n->offset, mid, first + count - mid, depth + 1 );
+}
+
+bool bvh_build( bvh_t* bvh, const aabb3_t* bounds, uint32 count )
+{
+	bvh_builder_t builder;
+	uint32 i;
+
+	if ( bvh == NULL || ( bounds == NULL && count > 0 ) ) return false;
+
+	memset( bvh, 0, sizeof( *bvh ) );
+	if ( count == 0 ) return true;
+
+	bvh->nodes = (bvh_node_t*)math_aligned_alloc( ( 2 * count - 1 ) * sizeof( bvh_node_t ), 32 );
+	bvh->indices = (uint32*)malloc( count * sizeof( uint32 ) );
+	builder.centroids = (vector3_t*)malloc( count * sizeof( vector3_t ) );
+
+	if ( bvh->nodes == NULL || bvh->indices == NULL || builder.centroids == NULL )
+	{
+		free( builder.centroids );
+		bvh_destroy( bvh );
+		return false;
+	}
+
+	builder.bvh = bvh;
+	builder.bounds = bounds;
+
+	for ( i = 0; i < count; i++ )
+	{
+		bvh->indices[i] = i;
+		aabb3_center( &builder.centroids[i], &bounds[i] );
+	}
+
+	bvh->bounds = bounds;
+	bvh->num_prims = count;
+	bvh->num_nodes = 1;
+
+	bvh_build_node( &builder, 0, 0, count, 0 );
+
+	free( builder.centroids );
+	return true;
+}
+
+void bvh_destroy( bvh_t* bvh )
+{
+	if ( bvh == NULL ) return;
+
+	math_aligned_free( bvh->nodes );
+	free( bvh->indices );
+
+	memset( bvh, 0, sizeof( *bvh ) );
+}
+
+void bvh_refit( bvh_t* bvh, const aabb3_t* bounds )
+{
+	bvh_node_t* n;
+	uint32 i, j;
+
+	if ( bvh == NULL || bounds == NULL || bvh->num_nodes == 0 ) return;
+
+	bvh->bounds = bounds;
+
+	// Children always come after their parent, so walking backwards updates them first.
+	for ( i = bvh->num_nodes; i-- > 0; )
+	{
+		n = &bvh->nodes[i];
+
+		if ( n->count > 0 )
+		{
+			n->bounds = bounds[bvh->indices[n->offset]];
+
+			for ( j = 1; j < n->count; j++ )
+				aabb3_merge( &n->bounds, &n->bounds, &bounds[bvh->indices[n->offset + j]] );
+		}
+		else
+		{
+			aabb3_merge( &n->bounds, &bvh->nodes[i+1].bounds, &bvh->nodes[n->offset].bounds );
+		}
+	}
+}
+
+// --------------------------------------------------
+// Queries
+// --------------------------------------------------
+
+// Precomputed ray data for the slab test.
+typedef struct
+{
+	float origin[3];
+	float inv_dir[3];
+} bvh_ray_t;
+
+static void bvh_setup_ray( bvh_ray_t* r, const ray3_t* ray )
+{
+	uint32 i;
+
+	for ( i = 0; i < 3; i++ )
+	{
+		r->origin[i] = ray->origin.coords[i];
+		r->inv_dir[i] = 1.0f / ray->direction.coords[i];	// Infinity for axis-parallel rays is fine
+	}
+}
+
+// Slab test, returns the entry distance or a negative value if the box is missed within [0, tmax].
+static MYLLY_INLINE float bvh_ray_box( const bvh_ray_t* r, const aabb3_t* box, float tmax )
+{
+	float t0, t1, tmin = 0.0f;
+	uint32 i;
+
+	for ( i = 0; i < 3; i++ )
+	{
+		t0 = ( box->min.coords[i] - r->origin[i] ) * r->inv_dir[i];
+		t1 = ( box->max.coords[i] - r->origin[i] ) * r->inv_dir[i];
+
+		tmin = math_max( tmin, math_min( t0, t1 ) );
+		tmax = math_min( tmax, math_max( t0, t1 ) );
+	}
+
+	return tmin <= tmax ? tmin : -1.0f;
+}
+
+// Tests the primitives of a leaf against one ray and keeps the nearest hit.
+static void bvh_test_leaf( const bvh_t* bvh, const bvh_node_t* leaf, const bvh_ray_t* r, const ray3_t* ray,
+						   bvh_hit_func_t hit_func, void* context, bvh_hit_t* hit )
+{
+	uint32 i, prim;
+	float t;
+
+	for ( i = leaf->offset; i < leaf->offset + leaf->count; i++ )
+	{
+		prim = bvh->indices[i];
+
+		// The bounds are a cheap early out before the exact test.
+		t = bvh_ray_box( r, &bvh->bounds[prim], hit->distance );
+		if ( t < 0.0f ) continue;
+
+		if ( hit_func != NULL )
+		{
+			t = hit->distance;
+			if ( !hit_func( context, prim, ray, &t ) || t >= hit->distance ) continue;
+		}
+		else if ( t >= hit->distance && hit->index != BVH_NO_HIT )
+		{
+			continue;
+		}
+
+		hit->index = prim;
+		hit->distance = t;
+	}
+}
+
+bool bvh_raycast( const bvh_t* bvh, const ray3_t* ray, float max_distance, bvh_hit_func_t hit_func, void* context, bvh_hit_t* hit )
+{
+	const bvh_node_t* n;
+	uint32 stack[BVH_MAX_DEPTH], top = 0, node = 0;
+	bvh_ray_t r;
+
+	if ( bvh == NULL || ray == NULL || hit == NULL ) return false;
+
+	hit->index = BVH_NO_HIT;
+	hit->distance = max_distance;
+
+	if ( bvh->num_nodes == 0 ) return false;
+
+	bvh_setup_ray( &r, ray );
+
+	for ( ;; )
+	{
+		n = &bvh->nodes[node];
+
+		if ( bvh_ray_box( &r, &n->bounds, hit->distance ) >= 0.0f )
+		{
+			if ( n->count == 0 )
+			{
+				// Visit the child on the ray's side of the split first, it's more likely to give an early hit.
+				if ( ray->direction.coords[n->axis] < 0.0f )
+				{
+					stack[top++] = node + 1;
+					node = n->offset;
+				}
+				else
+				{
+					stack[top++] = n->offset;
+					node = node + 1;
+				}
+				continue;
+			}
+
+			bvh_test_leaf( bvh, n, &r, ray, hit_func, context, hit );
+		}
+
+		if ( top == 0 ) break;
+		node = stack[--top];
+	}
+
+	return hit->index != BVH_NO_HIT;
+}
+
+// Traverses the tree with up to four rays at once. A node is visited if any of the rays hits it, the
+// node tests are done for all rays in one go and only the leaves are handled one ray at a time.
+static uint32 bvh_raycast_packet( const bvh_t* bvh, const ray3_t* rays, uint32 count, float max_distance,
+								  bvh_hit_func_t hit_func, void* context, bvh_hit_t* hits )
+{
+	const bvh_node_t* n;
+	bvh_ray_t r[4];
+	float tmax[4];
+	simd4f ox, oy, oz, ix, iy, iz, vtmax, tmin, tfar, t0, t1;
+	uint32 stack[BVH_MAX_DEPTH], top = 0, node = 0, mask, i, num_hits = 0;
+
+	for ( i = 0; i < 4; i++ )
+	{
+		if ( i < count )
+		{
+			bvh_setup_ray( &r[i], &rays[i] );
+			hits[i].index = BVH_NO_HIT;
+			hits[i].distance = max_distance;
+			tmax[i] = max_distance;
+		}
+		else
+		{
+			r[i] = r[0];
+			tmax[i] = -1.0f;	// Unused lanes never hit anything
+		}
+	}
+
+	ox = simd4f_set( r[0].origin[0], r[1].origin[0], r[2].origin[0], r[3].origin[0] );
+	oy = simd4f_set( r[0].origin[1], r[1].origin[1], r[2].origin[1], r[3].origin[1] );
+	oz = simd4f_set( r[0].origin[2], r[1].origin[2], r[2].origin[2], r[3].origin[2] );
+	ix = simd4f_set( r[0].inv_dir[0], r[1].inv_dir[0], r[2].inv_dir[0], r[3].inv_dir[0] );
+	iy = simd4f_set( r[0].inv_dir[1], r[1].inv_dir[1], r[2].inv_dir[1], r[3].inv_dir[1] );
+	iz = simd4f_set( r[0].inv_dir[2], r[1].inv_dir[2], r[2].inv_dir[2], r[3].inv_dir[2] );
+	vtmax = simd4f_loadu( tmax );
+
+	for ( ;; )
+	{
+		n = &bvh->nodes[node];
+
+		t0 = simd4f_mul( simd4f_sub( simd4f_set1( n->bounds.min.x ), ox ), ix );
+		t1 = simd4f_mul( simd4f_sub( simd4f_set1( n->bounds.max.x ), ox ), ix );
+		tmin = simd4f_max( simd4f_zero(), simd4f_min( t0, t1 ) );
+		tfar = simd4f_min( vtmax, simd4f_max( t0, t1 ) );
+
+		t0 = simd4f_mul( simd4f_sub( simd4f_set1( n->bounds.min.y ), oy ), iy );
+		t1 = simd4f_mul( simd4f_sub( simd4f_set1( n->bounds.max.y ), oy ), iy );
+		tmin = simd4f_max( tmin, simd4f_min( t0, t1 ) );
+		tfar = simd4f_min( tfar, simd4f_max( t0, t1 ) );
+
+		t0 = simd4f_mul( simd4f_sub( simd4f_set1( n->bounds.min.z ), oz ), iz );
+		t1 = simd4f_mul( simd4f_sub( simd4f_set1( n->bounds.max.z ), oz ), iz );
+		tmin = simd4f_max( tmin, simd4f_min( t0, t1 ) );
+		tfar = simd4f_min( tfar, simd4f_max( t0, t1 ) );
+
+		mask = simd4f_movemask( simd4f_cmple( tmin, tfar ) );
+
+		if ( mask != 0 )
+		{
+			if ( n->count == 0 )
+			{
+				// The rays of a packet are expected to point roughly the same way, order by the first one.
+				if ( rays[0].direction.coords[n->axis] < 0.0f )
+				{
+					stack[top++] = node + 1;
+					node = n->offset;
+				}
+				else
+				{
+					stack[top++] = n->offset;
+					node = node + 1;
+				}
+				continue;
+			}
+
+			for ( i = 0; i < count; i++ )
+			{
+				if ( mask & ( 1 << i ) )
+				{
+					bvh_test_leaf( bvh, n, &r[i], &rays[i], hit_func, context, &hits[i] );
+					tmax[i] = hits[i].distance;
+				}
+			}
+
+			vtmax = simd4f_loadu( tmax );
+		}
+
+		if ( top == 0 ) break;
+		node = stack[--top];
+	}
+
+	for ( i = 0; i < count; i++ )
+	{
+		if ( hits[i].index != BVH_NO_HIT ) num_hits++;
+	}
+
+	return num_hits;
+}
+
+uint32 bvh_raycast_array( const bvh_t* bvh, const ray3_t* rays, uint32 count, float max_distance, bvh_hit_func_t hit_func, void* context, bvh_hit_t* hits )
+{
+	uint32 i, num_hits = 0;
+
+	if ( bvh == NULL || rays == NULL || hits == NULL ) return 0;
+
+	if ( bvh->num_nodes == 0 )
+	{
+		for ( i = 0; i < count; i++ )
+		{
+			hits[i].index = BVH_NO_HIT;
+			hits[i].distance = max_distance;
+		}
+		return 0;
+	}
+
+	for ( i = 0; i < count; i += 4 )
+		num_hits += bvh_raycast_packet( bvh, &rays[i], math_min( count - i, 4 ), max_distance, hit_func, context, &hits[i] );
+
+	return num_hits;
+}
+
+uint32 bvh_query_aabb( const bvh_t* bvh, const aabb3_t* box, uint32* results, uint32 max_results )
+{
+	const bvh_node_t* n;
+	uint32 stack[BVH_MAX_DEPTH], top = 0, node = 0, i, prim, found = 0;
+
+	if ( bvh == NULL || box == NULL || bvh->num_nodes == 0 ) return 0;
+
+	for ( ;; )
+	{
+		n = &bvh->nodes[node];
+
+		if ( aabb3_overlaps( &n->bounds, box ) )
+		{
+			if ( n->count == 0 )
+			{
+				stack[top++] = n->offset;
+				node = node + 1;
+				continue;
+			}
+
+			for ( i = n->offset; i < n->offset + n->count; i++ )
+			{
+				prim = bvh->indices[i];
+				if ( !aabb3_overlaps( &bvh->bounds[prim], box ) ) continue;
+
+				if ( found < max_results ) results[found] = prim;
+				found++;
+			}
+		}
+
+		if ( top == 0 ) break;
+		node = stack[--top];
+	}
+
+	return found;
+}
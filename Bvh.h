@@ -0,0 +1,82 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Bvh.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Bounding volume hierarchy for ray and overlap queries.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_BVH_H
+#define __MYLLY_BVH_H
+
+#include "stdtypes.h"
+#include "Math/Aabb3.h"
+#include "Math/Vector3.h"
+
+#define BVH_NO_HIT	0xFFFFFFFF
+
+typedef struct
+{
+	vector3_t origin;
+	vector3_t direction;		// Doesn't need to be normalized, distances are in multiples of it
+} ray3_t;
+
+typedef struct
+{
+	uint32 index;				// Index of the primitive hit or BVH_NO_HIT
+	float distance;
+} bvh_hit_t;
+
+// Nodes are stored depth first, the left child of an inner node always follows its parent. 32 bytes
+// so two nodes share a cache line.
+typedef struct
+{
+	aabb3_t		bounds;
+	uint32		offset;			// Leaf: first entry in indices, inner node: index of the right child
+	uint16		count;			// Number of primitives in a leaf, 0 for inner nodes
+	uint16		axis;			// Split axis of an inner node, used to visit the nearer child first
+} bvh_node_t;
+
+typedef struct
+{
+	bvh_node_t*	nodes;
+	uint32*		indices;		// Primitive indices referenced by the leaves
+	const aabb3_t* bounds;		// Primitive bounds of the last build or refit, not copied
+	uint32		num_nodes;
+	uint32		num_prims;
+} bvh_t;
+
+// Exact intersection test against primitive index. Called with the distance of the nearest hit so
+// far, must return true and update distance when the primitive is hit closer than that.
+typedef bool ( *bvh_hit_func_t )( void* context, uint32 index, const ray3_t* ray, float* distance );
+
+__BEGIN_DECLS
+
+// Builds the tree over count primitive bounds using the surface area heuristic with binned splits.
+// The bounds array must stay valid while the tree is queried.
+MYLLY_API bool			bvh_build				( bvh_t* bvh, const aabb3_t* bounds, uint32 count );
+MYLLY_API void			bvh_destroy				( bvh_t* bvh );
+
+// Updates the node bounds after the primitives have moved without changing the tree structure.
+// Quality degrades as the primitives move further, rebuild once in a while.
+MYLLY_API void			bvh_refit				( bvh_t* bvh, const aabb3_t* bounds );
+
+// Finds the nearest primitive hit by the ray within max_distance. If hit_func is NULL the primitive
+// bounds are used for the test. Returns true if something was hit.
+MYLLY_API bool			bvh_raycast				( const bvh_t* bvh, const ray3_t* ray, float max_distance, bvh_hit_func_t hit_func, void* context, bvh_hit_t* hit );
+
+// Same as bvh_raycast for count rays, traversing the tree with four rays at a time. Works best when
+// the rays are coherent, like the rays of neighbouring pixels.
+MYLLY_API uint32		bvh_raycast_array		( const bvh_t* bvh, const ray3_t* rays, uint32 count, float max_distance, bvh_hit_func_t hit_func, void* context, bvh_hit_t* hits );
+
+// Writes the indices of up to max_results primitives whose bounds overlap box into results. Returns
+// the total number of overlapping primitives.
+MYLLY_API uint32		bvh_query_aabb			( const bvh_t* bvh, const aabb3_t* box, uint32* results, uint32 max_results );
+
+__END_DECLS
+
+#endif /* __MYLLY_BVH_H */
@@ -0,0 +1,301 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Camera.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		View and projection matrix builders.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/Camera.h"
+#include "Math/MathSimd.h"
+#include "Math/MathUtils.h"
+#include <math.h>
+#include <string.h>
+
+void matrix4_look_at( matrix4_t* result, const vector3_t* eye, const vector3_t* at, const vector3_t* up )
+{
+	vector3_t dir;
+
+	if ( result == NULL || eye == NULL || at == NULL || up == NULL ) return;
+
+	vector3_subtract( &dir, at, eye );
+	matrix4_look_to( result, eye, &dir, up );
+}
+
+void matrix4_look_to( matrix4_t* result, const vector3_t* eye, const vector3_t* dir, const vector3_t* up )
+{
+	vector3_t x, y, z;
+
+	if ( result == NULL || eye == NULL || dir == NULL || up == NULL ) return;
+
+	z = *dir;
+	vector3_normalize( &z );
+
+	vector3_cross( &x, up, &z );
+	vector3_normalize( &x );
+
+	vector3_cross( &y, &z, &x );
+
+	// The basis vectors go into the columns, which makes the rotation part the transpose of the
+	// camera's orientation.
+	result->_11 = x.x; result->_12 = y.x; result->_13 = z.x; result->_14 = 0.0f;
+	result->_21 = x.y; result->_22 = y.y; result->_23 = z.y; result->_24 = 0.0f;
+	result->_31 = x.z; result->_32 = y.z; result->_33 = z.z; result->_34 = 0.0f;
+
+	result->_41 = -vector3_dot( &x, eye );
+	result->_42 = -vector3_dot( &y, eye );
+	result->_43 = -vector3_dot( &z, eye );
+	result->_44 = 1.0f;
+}
+
+// Sets up the parts shared by all the perspective projections.
+static void matrix4_perspective_base( matrix4_t* result, float fov_y, float aspect )
+{
+	float y_scale = 1.0f / tanf( fov_y * 0.5f );
+
+	memset( result, 0, sizeof( *result ) );
+
+	result->_11 = y_scale / aspect;
+	result->_22 = y_scale;
+	result->_34 = 1.0f;
+}
+
+void matrix4_perspective( matrix4_t* result, float fov_y, float aspect, float znear, float zfar )
+{
+	if ( result == NULL ) return;
+
+	matrix4_perspective_base( result, fov_y, aspect );
+
+	result->_33 = zfar / ( zfar - znear );
+	result->_43 = -znear * zfar / ( zfar - znear );
+}
+
+void matrix4_perspective_reverse_z( matrix4_t* result, float fov_y, float aspect, float znear, float zfar )
+{
+	if ( result == NULL ) return;
+
+	matrix4_perspective_base( result, fov_y, aspect );
+
+	result->_33 = znear / ( znear - zfar );
+	result->_43 = -zfar * znear / ( znear - zfar );
+}
+
+void matrix4_perspective_infinite( matrix4_t* result, float fov_y, float aspect, float znear )
+{
+	if ( result == NULL ) return;
+
+	matrix4_perspective_base( result, fov_y, aspect );
+
+	// The limit of matrix4_perspective as zfar goes to infinity.
+	result->_33 = 1.0f;
+	result->_43 = -znear;
+}
+
+void matrix4_perspective_infinite_reverse_z( matrix4_t* result, float fov_y, float aspect, float znear )
+{
+	if ( result == NULL ) return;
+
+	matrix4_perspective_base( result, fov_y, aspect );
+
+	result->_33 = 0.0f;
+	result->_43 = znear;
+}
+
+void matrix4_ortho( matrix4_t* result, float width, float height, float znear, float zfar )
+{
+	if ( result == NULL ) return;
+
+	matrix4_ortho_off_center( result, -0.5f * width, 0.5f * width, -0.5f * height, 0.5f * height, znear, zfar );
+}
+
+void matrix4_ortho_off_center( matrix4_t* result, float left, float right, float bottom, float top, float znear, float zfar )
+{
+	if ( result == NULL ) return;
+
+	memset( result, 0, sizeof( *result ) );
+
+	result->_11 = 2.0f / ( right - left );
+	result->_22 = 2.0f / ( top - bottom );
+	result->_33 = 1.0f / ( zfar - znear );
+	result->_41 = ( left + right ) / ( left - right );
+	result->_42 = ( top + bottom ) / ( bottom - top );
+	result->_43 = znear / ( znear - zfar );
+	result->_44 = 1.0f;
+}
+
+void matrix4_inverse_look_at( matrix4_t* result, const matrix4_t* view )
+{
+	matrix4_t tmp;
+
+	if ( result == NULL || view == NULL ) return;
+
+	// The rotation is orthonormal so its inverse is the transpose, and the translation is undone
+	// by rotating it back to world space.
+	tmp._11 = view->_11; tmp._12 = view->_21; tmp._13 = view->_31; tmp._14 = 0.0f;
+	tmp._21 = view->_12; tmp._22 = view->_22; tmp._23 = view->_32; tmp._24 = 0.0f;
+	tmp._31 = view->_13; tmp._32 = view->_23; tmp._33 = view->_33; tmp._34 = 0.0f;
+
+	tmp._41 = -( view->_41 * tmp._11 + view->_42 * tmp._21 + view->_43 * tmp._31 );
+	tmp._42 = -( view->_41 * tmp._12 + view->_42 * tmp._22 + view->_43 * tmp._32 );
+	tmp._43 = -( view->_41 * tmp._13 + view->_42 * tmp._23 + view->_43 * tmp._33 );
+	tmp._44 = 1.0f;
+
+	*result = tmp;
+}
+
+void matrix4_inverse_perspective( matrix4_t* result, const matrix4_t* proj )
+{
+	float a, b, c, d, p, q;
+
+	if ( result == NULL || proj == NULL ) return;
+
+	// [a 0 0 0]            [ 1/a   0   0    0  ]
+	// [0 b 0 0]  inverts   [  0   1/b  0    0  ]
+	// [p q c 1]  to        [  0    0   0   1/d ]
+	// [0 0 d 0]            [-p/a -q/b  1  -c/d ]
+	a = 1.0f / proj->_11;
+	b = 1.0f / proj->_22;
+	c = proj->_33;
+	d = 1.0f / proj->_43;
+	p = proj->_31;
+	q = proj->_32;
+
+	memset( result, 0, sizeof( *result ) );
+
+	result->_11 = a;
+	result->_22 = b;
+	result->_34 = d;
+	result->_41 = -p * a;
+	result->_42 = -q * b;
+	result->_43 = 1.0f;
+	result->_44 = -c * d;
+}
+
+void matrix4_inverse_ortho( matrix4_t* result, const matrix4_t* proj )
+{
+	float a, b, c;
+	float tx, ty, tz;
+
+	if ( result == NULL || proj == NULL ) return;
+
+	a = 1.0f / proj->_11;
+	b = 1.0f / proj->_22;
+	c = 1.0f / proj->_33;
+	tx = proj->_41;
+	ty = proj->_42;
+	tz = proj->_43;
+
+	memset( result, 0, sizeof( *result ) );
+
+	result->_11 = a;
+	result->_22 = b;
+	result->_33 = c;
+	result->_41 = -tx * a;
+	result->_42 = -ty * b;
+	result->_43 = -tz * c;
+	result->_44 = 1.0f;
+}
+
+// Clip flag bits as simd4f lanes, so the flags of four points can be combined with bitwise ops.
+static simd4f camera_flag_mask( uint32 flag )
+{
+	union { uint32 u; float f; } bits;
+
+	bits.u = flag;
+	return simd4f_set1( bits.f );
+}
+
+uint32 vector3_project_array( vectorscreen_t* result, uint8* clip, const vector3_t* points, uint32 count, uint32 stride, const matrix4_t* view_proj, const rectangle_t* viewport )
+{
+	const uint8* src = (const uint8*)points;
+	const matrix4_t* m = view_proj;
+	const vector3_t* p[4];
+	vectorscreen_t tmp[4];
+	union { float f[4]; uint32 u[4]; } flags;
+	simd4f x, y, z, cx, cy, cz, cw, sx, sy, f, zero, min_w, lo, hi;
+	simd4f flag_left, flag_right, flag_bottom, flag_top, flag_near, flag_far;
+	simd4f half_w, half_h, center_x, center_y;
+	simd4f m11, m12, m13, m14, m21, m22, m23, m24, m31, m32, m33, m34, m41, m42, m43, m44;
+	uint32 i, j, n, visible = 0;
+
+	if ( result == NULL || points == NULL || view_proj == NULL || viewport == NULL ) return 0;
+	if ( stride == 0 ) stride = sizeof( vector3_t );
+
+	m11 = simd4f_set1( m->_11 ); m12 = simd4f_set1( m->_12 ); m13 = simd4f_set1( m->_13 ); m14 = simd4f_set1( m->_14 );
+	m21 = simd4f_set1( m->_21 ); m22 = simd4f_set1( m->_22 ); m23 = simd4f_set1( m->_23 ); m24 = simd4f_set1( m->_24 );
+	m31 = simd4f_set1( m->_31 ); m32 = simd4f_set1( m->_32 ); m33 = simd4f_set1( m->_33 ); m34 = simd4f_set1( m->_34 );
+	m41 = simd4f_set1( m->_41 ); m42 = simd4f_set1( m->_42 ); m43 = simd4f_set1( m->_43 ); m44 = simd4f_set1( m->_44 );
+
+	half_w = simd4f_set1( 0.5f * viewport->uw );
+	half_h = simd4f_set1( -0.5f * viewport->uh );
+	center_x = simd4f_set1( viewport->x + 0.5f * viewport->uw );
+	center_y = simd4f_set1( viewport->y + 0.5f * viewport->uh );
+
+	flag_left = camera_flag_mask( PROJECT_CLIP_LEFT );
+	flag_right = camera_flag_mask( PROJECT_CLIP_RIGHT );
+	flag_bottom = camera_flag_mask( PROJECT_CLIP_BOTTOM );
+	flag_top = camera_flag_mask( PROJECT_CLIP_TOP );
+	flag_near = camera_flag_mask( PROJECT_CLIP_NEAR );
+	flag_far = camera_flag_mask( PROJECT_CLIP_FAR );
+
+	zero = simd4f_zero();
+	min_w = simd4f_set1( 1.0e-20f );	// Keeps the divide finite for points on or behind the camera plane
+	lo = simd4f_set1( -32768.0f );
+	hi = simd4f_set1( 32767.0f );
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		// The last group repeats its final point to fill all four lanes.
+		n = math_min( count - i, 4 );
+
+		for ( j = 0; j < 4; j++ )
+			p[j] = (const vector3_t*)( src + ( i + math_min( j, n - 1 ) ) * stride );
+
+		x = simd4f_set( p[0]->x, p[1]->x, p[2]->x, p[3]->x );
+		y = simd4f_set( p[0]->y, p[1]->y, p[2]->y, p[3]->y );
+		z = simd4f_set( p[0]->z, p[1]->z, p[2]->z, p[3]->z );
+
+		cx = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m11, x ), simd4f_mul( m21, y ) ), simd4f_mul( m31, z ) ), m41 );
+		cy = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m12, x ), simd4f_mul( m22, y ) ), simd4f_mul( m32, z ) ), m42 );
+		cz = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m13, x ), simd4f_mul( m23, y ) ), simd4f_mul( m33, z ) ), m43 );
+		cw = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m14, x ), simd4f_mul( m24, y ) ), simd4f_mul( m34, z ) ), m44 );
+
+		// Clip space tests, -w <= x <= w, -w <= y <= w and 0 <= z <= w.
+		f = simd4f_and( simd4f_cmplt( simd4f_add( cx, cw ), zero ), flag_left );
+		f = simd4f_or( f, simd4f_and( simd4f_cmpgt( cx, cw ), flag_right ) );
+		f = simd4f_or( f, simd4f_and( simd4f_cmplt( simd4f_add( cy, cw ), zero ), flag_bottom ) );
+		f = simd4f_or( f, simd4f_and( simd4f_cmpgt( cy, cw ), flag_top ) );
+		f = simd4f_or( f, simd4f_and( simd4f_or( simd4f_cmplt( cz, zero ), simd4f_cmple( cw, zero ) ), flag_near ) );
+		f = simd4f_or( f, simd4f_and( simd4f_cmpgt( cz, cw ), flag_far ) );
+		simd4f_storeu( flags.f, f );
+
+		cw = simd4f_max( cw, min_w );
+
+		sx = simd4f_add( simd4f_mul( simd4f_div( cx, cw ), half_w ), center_x );
+		sy = simd4f_add( simd4f_mul( simd4f_div( cy, cw ), half_h ), center_y );
+
+		sx = simd4f_round( simd4f_min( simd4f_max( sx, lo ), hi ) );
+		sy = simd4f_round( simd4f_min( simd4f_max( sy, lo ), hi ) );
+
+		if ( n == 4 )
+		{
+			simd4f_store_int16_pairs( (int16*)&result[i], sx, sy );
+		}
+		else
+		{
+			simd4f_store_int16_pairs( (int16*)tmp, sx, sy );
+			memcpy( &result[i], tmp, n * sizeof( vectorscreen_t ) );
+		}
+
+		for ( j = 0; j < n; j++ )
+		{
+			if ( clip != NULL ) clip[i+j] = (uint8)flags.u[j];
+			if ( flags.u[j] == 0 ) visible++;
+		}
+	}
+
+	return visible;
+}
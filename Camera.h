@@ -0,0 +1,69 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Camera.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		View and projection matrix builders.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_CAMERA_H
+#define __MYLLY_CAMERA_H
+
+#include "stdtypes.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+#include "Math/VectorScreen.h"
+#include "Math/Rectangle.h"
+
+// Clip flags set by vector3_project_array, one bit for each clip space plane the point is outside of.
+enum
+{
+	PROJECT_CLIP_LEFT	= 0x01,
+	PROJECT_CLIP_RIGHT	= 0x02,
+	PROJECT_CLIP_BOTTOM	= 0x04,
+	PROJECT_CLIP_TOP	= 0x08,
+	PROJECT_CLIP_NEAR	= 0x10,		// Also set for points behind the camera
+	PROJECT_CLIP_FAR	= 0x20
+};
+
+// All the builders follow the Direct3D conventions: left-handed coordinates with +z into the screen,
+// row vectors and clip space z in [0, w]. The reverse-Z variants map the near plane to 1 and the far
+// plane to 0, which spreads the float depth precision evenly over the view distance.
+
+__BEGIN_DECLS
+
+// View matrix for a camera at eye looking at the point at.
+MYLLY_API void			matrix4_look_at						( matrix4_t* result, const vector3_t* eye, const vector3_t* at, const vector3_t* up );
+MYLLY_API void			matrix4_look_to						( matrix4_t* result, const vector3_t* eye, const vector3_t* dir, const vector3_t* up );
+
+// Perspective projections, fov_y is the vertical field of view in radians and aspect is width / height.
+MYLLY_API void			matrix4_perspective					( matrix4_t* result, float fov_y, float aspect, float znear, float zfar );
+MYLLY_API void			matrix4_perspective_reverse_z		( matrix4_t* result, float fov_y, float aspect, float znear, float zfar );
+MYLLY_API void			matrix4_perspective_infinite		( matrix4_t* result, float fov_y, float aspect, float znear );
+MYLLY_API void			matrix4_perspective_infinite_reverse_z	( matrix4_t* result, float fov_y, float aspect, float znear );
+
+// Orthographic projections of a width x height view centered on the z axis, or of an arbitrary
+// rectangle of view space.
+MYLLY_API void			matrix4_ortho						( matrix4_t* result, float width, float height, float znear, float zfar );
+MYLLY_API void			matrix4_ortho_off_center			( matrix4_t* result, float left, float right, float bottom, float top, float znear, float zfar );
+
+// Closed form inverses. These only look at the elements the matching builders above set, so they
+// are exact for those matrices and wrong for anything else.
+MYLLY_API void			matrix4_inverse_look_at				( matrix4_t* result, const matrix4_t* view );
+MYLLY_API void			matrix4_inverse_perspective			( matrix4_t* result, const matrix4_t* proj );
+MYLLY_API void			matrix4_inverse_ortho				( matrix4_t* result, const matrix4_t* proj );
+
+// Transforms points by view_proj, does the perspective divide and maps the result to the viewport
+// with y pointing down, all in one pass. Screen coordinates are rounded to the nearest pixel and
+// clamped to the int16 range. clip receives the flags of each point and can be NULL. Returns the
+// number of points inside the view volume. stride is the distance between the input points in
+// bytes, 0 for tightly packed.
+MYLLY_API uint32		vector3_project_array				( vectorscreen_t* result, uint8* clip, const vector3_t* points, uint32 count, uint32 stride, const matrix4_t* view_proj, const rectangle_t* viewport );
+
+__END_DECLS
+
+#endif /* __MYLLY_CAMERA_H */
@@ -9,88 +9,179 @@
  *
  **********************************************************************/
 
+// Always build the out-of-line versions into the library, see MathInline.h
+#define MYLLY_MATH_BUILD
+
 #include "Math/Colour.h"
+#include "Math/Colour.inl"
+#include "Math/MathSimd.h"
 
-static __inline int8 clamp( int32 n )
-{
-	n = n > 255 ? 255 : n;
-	return n < 0 ? 0 : (uint8)n;
-}
+// The array versions give exactly the same results as calling the single colour functions in a loop.
+// Four colours (16 channels) are handled per step. Add and invert work on saturated bytes directly;
+// multiply and lerp expand the channels to floats so the truncation matches the scalar code.
 
-void colour_add( colour_t* result, const colour_t* c1, const colour_t* c2 )
-{
-	result->r = clamp( (int32)c1->r + c2->r );
-	result->g = clamp( (int32)c1->g + c2->g );
-	result->b = clamp( (int32)c1->b + c2->b );
-	result->a = clamp( (int32)c1->a + c2->a );
-}
+#if defined(MYLLY_MATH_SSE2)
 
-void colour_subtract( colour_t* result, const colour_t* c1, const colour_t* c2 )
+// Expands the 16 channels of four colours into four vectors of floats, one colour each.
+static MYLLY_INLINE void colour_unpack_sse2( __m128i c, __m128 f[4] )
 {
-	result->r = clamp( (int32)c1->r - c2->r );
-	result->g = clamp( (int32)c1->g - c2->g );
-	result->b = clamp( (int32)c1->b - c2->b );
-	result->a = clamp( (int32)c1->a - c2->a );
-}
+	__m128i zero = _mm_setzero_si128();
+	__m128i lo = _mm_unpacklo_epi8( c, zero );
+	__m128i hi = _mm_unpackhi_epi8( c, zero );
 
-void colour_multiply( colour_t* result, const colour_t* c, float value )
-{
-	result->r = clamp( (int32)( c->r * value ) );
-	result->g = clamp( (int32)( c->g * value ) );
-	result->b = clamp( (int32)( c->b * value ) );
-	result->a = clamp( (int32)( c->a * value ) );
+	f[0] = _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) );
+	f[1] = _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) );
+	f[2] = _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) );
+	f[3] = _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) );
 }
 
-void colour_divide( colour_t* result, const colour_t* c, float value )
+// Truncates the channels back to integers and clamps them to 0-255 with saturating packs.
+static MYLLY_INLINE __m128i colour_pack_sse2( __m128 f[4] )
 {
-	result->r = clamp( (int32)( c->r / value ) );
-	result->g = clamp( (int32)( c->g / value ) );
-	result->b = clamp( (int32)( c->b / value ) );
-	result->a = clamp( (int32)( c->a / value ) );
+	__m128i lo = _mm_packs_epi32( _mm_cvttps_epi32( f[0] ), _mm_cvttps_epi32( f[1] ) );
+	__m128i hi = _mm_packs_epi32( _mm_cvttps_epi32( f[2] ), _mm_cvttps_epi32( f[3] ) );
+
+	return _mm_packus_epi16( lo, hi );
 }
 
-void colour_add_scalar( colour_t* result, const colour_t* c, float value )
+#elif defined(MYLLY_MATH_NEON)
+
+static MYLLY_INLINE void colour_unpack_neon( uint8x16_t c, float32x4_t f[4] )
 {
-	result->r = clamp( (int32)( c->r + value ) );
-	result->g = clamp( (int32)( c->g + value ) );
-	result->b = clamp( (int32)( c->b + value ) );
-	result->a = clamp( (int32)( c->a + value ) );
+	uint16x8_t lo = vmovl_u8( vget_low_u8( c ) );
+	uint16x8_t hi = vmovl_u8( vget_high_u8( c ) );
+
+	f[0] = vcvtq_f32_u32( vmovl_u16( vget_low_u16( lo ) ) );
+	f[1] = vcvtq_f32_u32( vmovl_u16( vget_high_u16( lo ) ) );
+	f[2] = vcvtq_f32_u32( vmovl_u16( vget_low_u16( hi ) ) );
+	f[3] = vcvtq_f32_u32( vmovl_u16( vget_high_u16( hi ) ) );
 }
 
-void colour_subtract_scalar( colour_t* result, const colour_t* c, float value )
+static MYLLY_INLINE uint8x16_t colour_pack_neon( float32x4_t f[4] )
 {
-	result->r = clamp( (int32)( c->r - value ) );
-	result->g = clamp( (int32)( c->g - value ) );
-	result->b = clamp( (int32)( c->b - value ) );
-	result->a = clamp( (int32)( c->a - value ) );
+	int16x8_t lo = vcombine_s16( vqmovn_s32( vcvtq_s32_f32( f[0] ) ), vqmovn_s32( vcvtq_s32_f32( f[1] ) ) );
+	int16x8_t hi = vcombine_s16( vqmovn_s32( vcvtq_s32_f32( f[2] ) ), vqmovn_s32( vcvtq_s32_f32( f[3] ) ) );
+
+	return vcombine_u8( vqmovun_s16( lo ), vqmovun_s16( hi ) );
 }
 
-void colour_invert( colour_t* result, const colour_t* c )
+#endif
+
+void colour_add_array( colour_t* result, const colour_t* c1, const colour_t* c2, uint32 count )
 {
-	result->r = 255 - c->r;
-	result->g = 255 - c->g;
-	result->b = 255 - c->b;
-	result->a = 255 - c->a;
+	uint32 i = 0;
+
+#if defined(MYLLY_MATH_SSE2)
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		__m128i a = _mm_loadu_si128( (const __m128i*)&c1[i] );
+		__m128i b = _mm_loadu_si128( (const __m128i*)&c2[i] );
+		_mm_storeu_si128( (__m128i*)&result[i], _mm_adds_epu8( a, b ) );
+	}
+#elif defined(MYLLY_MATH_NEON)
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		uint8x16_t a = vld1q_u8( (const uint8*)&c1[i] );
+		uint8x16_t b = vld1q_u8( (const uint8*)&c2[i] );
+		vst1q_u8( (uint8*)&result[i], vqaddq_u8( a, b ) );
+	}
+#endif
+
+	for ( ; i < count; i++ )
+		colour_add( &result[i], &c1[i], &c2[i] );
 }
 
-void colour_invert_no_alpha( colour_t* result, const colour_t* c )
+void colour_multiply_array( colour_t* result, const colour_t* c, float value, uint32 count )
 {
-	result->r = 255 - c->r;
-	result->g = 255 - c->g;
-	result->b = 255 - c->b;
+	uint32 i = 0;
+
+#if defined(MYLLY_MATH_SSE2)
+	__m128 f[4], v = _mm_set1_ps( value );
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		colour_unpack_sse2( _mm_loadu_si128( (const __m128i*)&c[i] ), f );
+
+		f[0] = _mm_mul_ps( f[0], v );
+		f[1] = _mm_mul_ps( f[1], v );
+		f[2] = _mm_mul_ps( f[2], v );
+		f[3] = _mm_mul_ps( f[3], v );
+
+		_mm_storeu_si128( (__m128i*)&result[i], colour_pack_sse2( f ) );
+	}
+#elif defined(MYLLY_MATH_NEON)
+	float32x4_t f[4];
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		colour_unpack_neon( vld1q_u8( (const uint8*)&c[i] ), f );
+
+		f[0] = vmulq_n_f32( f[0], value );
+		f[1] = vmulq_n_f32( f[1], value );
+		f[2] = vmulq_n_f32( f[2], value );
+		f[3] = vmulq_n_f32( f[3], value );
+
+		vst1q_u8( (uint8*)&result[i], colour_pack_neon( f ) );
+	}
+#endif
+
+	for ( ; i < count; i++ )
+		colour_multiply( &result[i], &c[i], value );
 }
 
-void colour_lerp( colour_t* result, const colour_t* c1, const colour_t* c2, float t )
+void colour_invert_array( colour_t* result, const colour_t* c, uint32 count )
 {
-	result->r = clamp( (int32)( c1->r + ( c2->r - c1->r ) * t ) );
-	result->g = clamp( (int32)( c1->g + ( c2->g - c1->g ) * t ) );
-	result->b = clamp( (int32)( c1->b + ( c2->b - c1->b ) * t ) );
-	result->a = clamp( (int32)( c1->a + ( c2->a - c1->a ) * t ) );
+	uint32 i = 0;
+
+#if defined(MYLLY_MATH_SSE2)
+	__m128i ones = _mm_set1_epi32( -1 );
+
+	for ( ; i + 4 <= count; i += 4 )
+		_mm_storeu_si128( (__m128i*)&result[i], _mm_xor_si128( _mm_loadu_si128( (const __m128i*)&c[i] ), ones ) );
+#elif defined(MYLLY_MATH_NEON)
+	for ( ; i + 4 <= count; i += 4 )
+		vst1q_u8( (uint8*)&result[i], vmvnq_u8( vld1q_u8( (const uint8*)&c[i] ) ) );
+#endif
+
+	for ( ; i < count; i++ )
+		colour_invert( &result[i], &c[i] );
 }
 
-void colour_lerp_no_alpha( colour_t* result, const colour_t* c1, const colour_t* c2, float t )
+void colour_lerp_array( colour_t* result, const colour_t* c1, const colour_t* c2, float t, uint32 count )
 {
-	result->r = clamp( (int32)( c1->r + ( c2->r - c1->r ) * t ) );
-	result->g = clamp( (int32)( c1->g + ( c2->g - c1->g ) * t ) );
-	result->b = clamp( (int32)( c1->b + ( c2->b - c1->b ) * t ) );
+	uint32 i = 0, j;
+
+#if defined(MYLLY_MATH_SSE2)
+	__m128 a[4], b[4], vt = _mm_set1_ps( t );
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		colour_unpack_sse2( _mm_loadu_si128( (const __m128i*)&c1[i] ), a );
+		colour_unpack_sse2( _mm_loadu_si128( (const __m128i*)&c2[i] ), b );
+
+		// c1 + ( c2 - c1 ) * t, the difference is exact in floats just like the integer one
+		for ( j = 0; j < 4; j++ )
+			a[j] = _mm_add_ps( a[j], _mm_mul_ps( _mm_sub_ps( b[j], a[j] ), vt ) );
+
+		_mm_storeu_si128( (__m128i*)&result[i], colour_pack_sse2( a ) );
+	}
+#elif defined(MYLLY_MATH_NEON)
+	float32x4_t a[4], b[4];
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		colour_unpack_neon( vld1q_u8( (const uint8*)&c1[i] ), a );
+		colour_unpack_neon( vld1q_u8( (const uint8*)&c2[i] ), b );
+
+		for ( j = 0; j < 4; j++ )
+			a[j] = vaddq_f32( a[j], vmulq_n_f32( vsubq_f32( b[j], a[j] ), t ) );
+
+		vst1q_u8( (uint8*)&result[i], colour_pack_neon( a ) );
+	}
+#endif
+
+	(void)j;
+
+	for ( ; i < count; i++ )
+		colour_lerp( &result[i], &c1[i], &c2[i], t );
 }
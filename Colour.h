@@ -14,6 +14,7 @@
 #define __MYLLY_COLOUR_H
 
 #include "stdtypes.h"
+#include "Math/MathInline.h"
 
 #ifdef __cplusplus
 
@@ -59,6 +60,8 @@ typedef union
 
 __BEGIN_DECLS
 
+#ifndef MYLLY_MATH_USE_INLINE
+
 MYLLY_API void			colour_add				( colour_t* result, const colour_t* c1, const colour_t* c2 );
 MYLLY_API void			colour_subtract			( colour_t* result, const colour_t* c1, const colour_t* c2 );
 MYLLY_API void			colour_multiply			( colour_t* result, const colour_t* c, float value );
@@ -71,6 +74,17 @@ MYLLY_API void			colour_invert_no_alpha	( colour_t* result, const colour_t* c );
 MYLLY_API void			colour_lerp				( colour_t* result, const colour_t* c1, const colour_t* c2, float t );
 MYLLY_API void			colour_lerp_no_alpha	( colour_t* result, const colour_t* c1, const colour_t* c2, float t );
 
+#endif
+
+MYLLY_API void			colour_add_array		( colour_t* result, const colour_t* c1, const colour_t* c2, uint32 count );
+MYLLY_API void			colour_multiply_array	( colour_t* result, const colour_t* c, float value, uint32 count );
+MYLLY_API void			colour_invert_array		( colour_t* result, const colour_t* c, uint32 count );
+MYLLY_API void			colour_lerp_array		( colour_t* result, const colour_t* c1, const colour_t* c2, float t, uint32 count );
+
 __END_DECLS
 
+#ifdef MYLLY_MATH_USE_INLINE
+#include "Math/Colour.inl"
+#endif
+
 #endif /* __MYLLY_COLOUR_H */
@@ -0,0 +1,100 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Colour.inl
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		RGBA colour struct.
+ *				Shared by the library and the MYLLY_MATH_INLINE build.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#ifndef __MYLLY_COLOUR_INL
+#define __MYLLY_COLOUR_INL
+
+static MYLLY_INLINE uint8 colour_clamp( int32 n )
+{
+	n = n > 255 ? 255 : n;
+	return n < 0 ? 0 : (uint8)n;
+}
+
+MYLLY_MATH_KERNEL void colour_add( colour_t* result, const colour_t* c1, const colour_t* c2 )
+{
+	result->r = colour_clamp( (int32)c1->r + c2->r );
+	result->g = colour_clamp( (int32)c1->g + c2->g );
+	result->b = colour_clamp( (int32)c1->b + c2->b );
+	result->a = colour_clamp( (int32)c1->a + c2->a );
+}
+
+MYLLY_MATH_KERNEL void colour_subtract( colour_t* result, const colour_t* c1, const colour_t* c2 )
+{
+	result->r = colour_clamp( (int32)c1->r - c2->r );
+	result->g = colour_clamp( (int32)c1->g - c2->g );
+	result->b = colour_clamp( (int32)c1->b - c2->b );
+	result->a = colour_clamp( (int32)c1->a - c2->a );
+}
+
+MYLLY_MATH_KERNEL void colour_multiply( colour_t* result, const colour_t* c, float value )
+{
+	result->r = colour_clamp( (int32)( c->r * value ) );
+	result->g = colour_clamp( (int32)( c->g * value ) );
+	result->b = colour_clamp( (int32)( c->b * value ) );
+	result->a = colour_clamp( (int32)( c->a * value ) );
+}
+
+MYLLY_MATH_KERNEL void colour_divide( colour_t* result, const colour_t* c, float value )
+{
+	result->r = colour_clamp( (int32)( c->r / value ) );
+	result->g = colour_clamp( (int32)( c->g / value ) );
+	result->b = colour_clamp( (int32)( c->b / value ) );
+	result->a = colour_clamp( (int32)( c->a / value ) );
+}
+
+MYLLY_MATH_KERNEL void colour_add_scalar( colour_t* result, const colour_t* c, float value )
+{
+	result->r = colour_clamp( (int32)( c->r + value ) );
+	result->g = colour_clamp( (int32)( c->g + value ) );
+	result->b = colour_clamp( (int32)( c->b + value ) );
+	result->a = colour_clamp( (int32)( c->a + value ) );
+}
+
+MYLLY_MATH_KERNEL void colour_subtract_scalar( colour_t* result, const colour_t* c, float value )
+{
+	result->r = colour_clamp( (int32)( c->r - value ) );
+	result->g = colour_clamp( (int32)( c->g - value ) );
+	result->b = colour_clamp( (int32)( c->b - value ) );
+	result->a = colour_clamp( (int32)( c->a - value ) );
+}
+
+MYLLY_MATH_KERNEL void colour_invert( colour_t* result, const colour_t* c )
+{
+	result->r = 255 - c->r;
+	result->g = 255 - c->g;
+	result->b = 255 - c->b;
+	result->a = 255 - c->a;
+}
+
+MYLLY_MATH_KERNEL void colour_invert_no_alpha( colour_t* result, const colour_t* c )
+{
+	result->r = 255 - c->r;
+	result->g = 255 - c->g;
+	result->b = 255 - c->b;
+}
+
+MYLLY_MATH_KERNEL void colour_lerp( colour_t* result, const colour_t* c1, const colour_t* c2, float t )
+{
+	result->r = colour_clamp( (int32)( c1->r + ( c2->r - c1->r ) * t ) );
+	result->g = colour_clamp( (int32)( c1->g + ( c2->g - c1->g ) * t ) );
+	result->b = colour_clamp( (int32)( c1->b + ( c2->b - c1->b ) * t ) );
+	result->a = colour_clamp( (int32)( c1->a + ( c2->a - c1->a ) * t ) );
+}
+
+MYLLY_MATH_KERNEL void colour_lerp_no_alpha( colour_t* result, const colour_t* c1, const colour_t* c2, float t )
+{
+	result->r = colour_clamp( (int32)( c1->r + ( c2->r - c1->r ) * t ) );
+	result->g = colour_clamp( (int32)( c1->g + ( c2->g - c1->g ) * t ) );
+	result->b = colour_clamp( (int32)( c1->b + ( c2->b - c1->b ) * t ) );
+}
+
+#endif /* __MYLLY_COLOUR_INL */
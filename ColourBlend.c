@@ -0,0 +1,284 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		ColourBlend.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Premultiplied alpha compositing of colour spans.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/ColourBlend.h"
+#include "Math/MathSimd.h"
+
+// The vector code assumes the alpha channel is the first byte of each colour in memory.
+#if ( defined(MYLLY_MATH_SSE2) || defined(MYLLY_MATH_NEON) ) && !defined(MYLLY_BIG_ENDIAN)
+#define BLEND_SIMD
+#endif
+
+// 16.16 fixed point 255 / alpha rounded to nearest, 0 for alpha 0. Constant so the span functions
+// can run on several threads at once.
+static const uint32 unpremultiply_table[256] = {
+	0, 16711680, 8355840, 5570560, 4177920, 3342336, 2785280, 2387383,
+	2088960, 1856853, 1671168, 1519244, 1392640, 1285514, 1193691, 1114112,
+	1044480, 983040, 928427, 879562, 835584, 795794, 759622, 726595,
+	696320, 668467, 642757, 618951, 596846, 576265, 557056, 539086,
+	522240, 506415, 491520, 477477, 464213, 451667, 439781, 428505,
+	417792, 407602, 397897, 388644, 379811, 371371, 363297, 355568,
+	348160, 341055, 334234, 327680, 321378, 315315, 309476, 303849,
+	298423, 293187, 288132, 283249, 278528, 273962, 269543, 265265,
+	261120, 257103, 253207, 249428, 245760, 242198, 238738, 235376,
+	232107, 228927, 225834, 222822, 219891, 217035, 214252, 211540,
+	208896, 206317, 203801, 201346, 198949, 196608, 194322, 192088,
+	189905, 187772, 185685, 183645, 181649, 179695, 177784, 175912,
+	174080, 172285, 170527, 168805, 167117, 165462, 163840, 162249,
+	160689, 159159, 157657, 156184, 154738, 153318, 151924, 150556,
+	149211, 147891, 146594, 145319, 144066, 142835, 141624, 140434,
+	139264, 138113, 136981, 135867, 134772, 133693, 132632, 131588,
+	130560, 129548, 128551, 127570, 126604, 125652, 124714, 123790,
+	122880, 121983, 121099, 120228, 119369, 118523, 117688, 116865,
+	116053, 115253, 114464, 113685, 112917, 112159, 111411, 110673,
+	109945, 109227, 108517, 107817, 107126, 106444, 105770, 105105,
+	104448, 103799, 103159, 102526, 101900, 101283, 100673, 100070,
+	99474, 98886, 98304, 97729, 97161, 96599, 96044, 95495,
+	94953, 94416, 93886, 93361, 92843, 92330, 91822, 91321,
+	90824, 90333, 89848, 89367, 88892, 88422, 87956, 87496,
+	87040, 86589, 86143, 85701, 85264, 84831, 84402, 83978,
+	83558, 83143, 82731, 82324, 81920, 81520, 81125, 80733,
+	80345, 79960, 79579, 79202, 78829, 78459, 78092, 77729,
+	77369, 77012, 76659, 76309, 75962, 75618, 75278, 74940,
+	74606, 74274, 73945, 73620, 73297, 72977, 72659, 72345,
+	72033, 71724, 71417, 71114, 70812, 70513, 70217, 69923,
+	69632, 69343, 69057, 68772, 68490, 68211, 67934, 67659,
+	67386, 67115, 66847, 66580, 66316, 66054, 65794, 65536
+};
+
+// x / 255 rounded to nearest, exact for all x in [0, 255*255]
+static MYLLY_INLINE uint32 blend_div255( uint32 x )
+{
+	x += 128;
+	return ( x + ( x >> 8 ) ) >> 8;
+}
+
+static MYLLY_INLINE uint8 blend_saturate( uint32 x )
+{
+	return x > 255 ? 255 : (uint8)x;
+}
+
+// --------------------------------------------------
+// Single colours
+// --------------------------------------------------
+
+void colour_premultiply( colour_t* result, const colour_t* c )
+{
+	uint32 a = c->a;
+
+	result->r = (uint8)blend_div255( c->r * a );
+	result->g = (uint8)blend_div255( c->g * a );
+	result->b = (uint8)blend_div255( c->b * a );
+	result->a = (uint8)a;
+}
+
+void colour_unpremultiply( colour_t* result, const colour_t* c )
+{
+	uint32 factor;
+
+	factor = unpremultiply_table[c->a];
+
+	result->r = blend_saturate( ( c->r * factor + 0x8000 ) >> 16 );
+	result->g = blend_saturate( ( c->g * factor + 0x8000 ) >> 16 );
+	result->b = blend_saturate( ( c->b * factor + 0x8000 ) >> 16 );
+	result->a = c->a;
+}
+
+static MYLLY_INLINE uint8 blend_channel( uint32 s, uint32 d, uint32 sa, uint32 da, colour_blend_t mode )
+{
+	switch ( mode )
+	{
+	case COLOUR_BLEND_OVER:
+		return blend_saturate( s + blend_div255( d * ( 255 - sa ) ) );
+
+	case COLOUR_BLEND_ADD:
+		return blend_saturate( s + d );
+
+	case COLOUR_BLEND_MULTIPLY:
+		return blend_saturate( blend_div255( s * d ) + blend_div255( s * ( 255 - da ) ) + blend_div255( d * ( 255 - sa ) ) );
+	}
+
+	return (uint8)d;
+}
+
+void colour_blend( colour_t* dst, const colour_t* src, colour_blend_t mode )
+{
+	uint32 sa = src->a, da = dst->a;
+
+	dst->r = blend_channel( src->r, dst->r, sa, da, mode );
+	dst->g = blend_channel( src->g, dst->g, sa, da, mode );
+	dst->b = blend_channel( src->b, dst->b, sa, da, mode );
+	dst->a = blend_channel( sa, da, sa, da, mode );
+}
+
+// --------------------------------------------------
+// Spans. Four colours are widened into two vectors of 16-bit channels (two colours each), blended
+// with the same integer arithmetic as above and narrowed back with saturation.
+// --------------------------------------------------
+
+#if defined(BLEND_SIMD) && defined(MYLLY_MATH_SSE2)
+
+typedef __m128i blend16_t;
+
+#define b16_set1(x)			_mm_set1_epi16( x )
+#define b16_add(a, b)		_mm_add_epi16( a, b )
+#define b16_sub(a, b)		_mm_sub_epi16( a, b )
+#define b16_mul(a, b)		_mm_mullo_epi16( a, b )
+
+static MYLLY_INLINE void b16_load( const colour_t* c, blend16_t* lo, blend16_t* hi )
+{
+	__m128i v = _mm_loadu_si128( (const __m128i*)c );
+
+	*lo = _mm_unpacklo_epi8( v, _mm_setzero_si128() );
+	*hi = _mm_unpackhi_epi8( v, _mm_setzero_si128() );
+}
+
+static MYLLY_INLINE void b16_store( colour_t* c, blend16_t lo, blend16_t hi )
+{
+	_mm_storeu_si128( (__m128i*)c, _mm_packus_epi16( lo, hi ) );
+}
+
+static MYLLY_INLINE blend16_t b16_div255( blend16_t x )
+{
+	x = _mm_add_epi16( x, _mm_set1_epi16( 128 ) );
+	return _mm_srli_epi16( _mm_add_epi16( x, _mm_srli_epi16( x, 8 ) ), 8 );
+}
+
+// Copies the alpha of each colour into all of its channels.
+static MYLLY_INLINE blend16_t b16_alpha( blend16_t x )
+{
+	x = _mm_shufflelo_epi16( x, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+	return _mm_shufflehi_epi16( x, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+}
+
+// Takes the alpha channels from a and the colour channels from b.
+static MYLLY_INLINE blend16_t b16_keep_alpha( blend16_t a, blend16_t b )
+{
+	__m128i mask = _mm_set_epi16( 0, 0, 0, -1, 0, 0, 0, -1 );
+	return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) );
+}
+
+#elif defined(BLEND_SIMD) && defined(MYLLY_MATH_NEON)
+
+typedef uint16x8_t blend16_t;
+
+#define b16_set1(x)			vdupq_n_u16( x )
+#define b16_add(a, b)		vaddq_u16( a, b )
+#define b16_sub(a, b)		vsubq_u16( a, b )
+#define b16_mul(a, b)		vmulq_u16( a, b )
+
+static MYLLY_INLINE void b16_load( const colour_t* c, blend16_t* lo, blend16_t* hi )
+{
+	uint8x16_t v = vld1q_u8( (const uint8*)c );
+
+	*lo = vmovl_u8( vget_low_u8( v ) );
+	*hi = vmovl_u8( vget_high_u8( v ) );
+}
+
+static MYLLY_INLINE void b16_store( colour_t* c, blend16_t lo, blend16_t hi )
+{
+	vst1q_u8( (uint8*)c, vcombine_u8( vqmovn_u16( lo ), vqmovn_u16( hi ) ) );
+}
+
+static MYLLY_INLINE blend16_t b16_div255( blend16_t x )
+{
+	x = vaddq_u16( x, vdupq_n_u16( 128 ) );
+	return vshrq_n_u16( vaddq_u16( x, vshrq_n_u16( x, 8 ) ), 8 );
+}
+
+static MYLLY_INLINE blend16_t b16_alpha( blend16_t x )
+{
+	return vcombine_u16( vdup_lane_u16( vget_low_u16( x ), 0 ), vdup_lane_u16( vget_high_u16( x ), 0 ) );
+}
+
+static MYLLY_INLINE blend16_t b16_keep_alpha( blend16_t a, blend16_t b )
+{
+	static const uint16 mask[8] = { 0xFFFF, 0, 0, 0, 0xFFFF, 0, 0, 0 };
+	return vbslq_u16( vld1q_u16( mask ), a, b );
+}
+
+#endif
+
+#ifdef BLEND_SIMD
+
+static MYLLY_INLINE blend16_t b16_premultiply( blend16_t c )
+{
+	return b16_keep_alpha( c, b16_div255( b16_mul( c, b16_alpha( c ) ) ) );
+}
+
+static MYLLY_INLINE blend16_t b16_blend( blend16_t s, blend16_t d, colour_blend_t mode )
+{
+	blend16_t full = b16_set1( 255 );
+
+	switch ( mode )
+	{
+	case COLOUR_BLEND_OVER:
+		return b16_add( s, b16_div255( b16_mul( d, b16_sub( full, b16_alpha( s ) ) ) ) );
+
+	case COLOUR_BLEND_ADD:
+		return b16_add( s, d );
+
+	case COLOUR_BLEND_MULTIPLY:
+		return b16_add( b16_add( b16_div255( b16_mul( s, d ) ),
+								 b16_div255( b16_mul( s, b16_sub( full, b16_alpha( d ) ) ) ) ),
+								 b16_div255( b16_mul( d, b16_sub( full, b16_alpha( s ) ) ) ) );
+	}
+
+	return d;
+}
+
+#endif
+
+void colour_premultiply_span( colour_t* dst, const colour_t* src, uint32 count )
+{
+	uint32 i = 0;
+
+#ifdef BLEND_SIMD
+	blend16_t lo, hi;
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		b16_load( &src[i], &lo, &hi );
+		b16_store( &dst[i], b16_premultiply( lo ), b16_premultiply( hi ) );
+	}
+#endif
+
+	for ( ; i < count; i++ )
+		colour_premultiply( &dst[i], &src[i] );
+}
+
+// Table driven, there's no integer vector divide to make a vector version worthwhile.
+void colour_unpremultiply_span( colour_t* dst, const colour_t* src, uint32 count )
+{
+	uint32 i;
+
+	for ( i = 0; i < count; i++ )
+		colour_unpremultiply( &dst[i], &src[i] );
+}
+
+void colour_blend_span( colour_t* dst, const colour_t* src, uint32 count, colour_blend_t mode )
+{
+	uint32 i = 0;
+
+#ifdef BLEND_SIMD
+	blend16_t slo, shi, dlo, dhi;
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		b16_load( &src[i], &slo, &shi );
+		b16_load( &dst[i], &dlo, &dhi );
+		b16_store( &dst[i], b16_blend( slo, dlo, mode ), b16_blend( shi, dhi, mode ) );
+	}
+#endif
+
+	for ( ; i < count; i++ )
+		colour_blend( &dst[i], &src[i], mode );
+}
@@ -0,0 +1,39 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		ColourBlend.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Premultiplied alpha compositing of colour spans.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_COLOURBLEND_H
+#define __MYLLY_COLOURBLEND_H
+
+#include "stdtypes.h"
+#include "Math/Colour.h"
+
+// Blend modes for premultiplied colours. s = source, d = destination, all channels including alpha.
+typedef enum
+{
+	COLOUR_BLEND_OVER,		// Porter-Duff source over: s + d * ( 1 - sa )
+	COLOUR_BLEND_ADD,		// Saturating sum: s + d
+	COLOUR_BLEND_MULTIPLY	// s * d + s * ( 1 - da ) + d * ( 1 - sa )
+} colour_blend_t;
+
+__BEGIN_DECLS
+
+MYLLY_API void			colour_premultiply			( colour_t* result, const colour_t* c );
+MYLLY_API void			colour_unpremultiply		( colour_t* result, const colour_t* c );
+MYLLY_API void			colour_blend				( colour_t* dst, const colour_t* src, colour_blend_t mode );
+
+MYLLY_API void			colour_premultiply_span		( colour_t* dst, const colour_t* src, uint32 count );
+MYLLY_API void			colour_unpremultiply_span	( colour_t* dst, const colour_t* src, uint32 count );
+MYLLY_API void			colour_blend_span			( colour_t* dst, const colour_t* src, uint32 count, colour_blend_t mode );
+
+__END_DECLS
+
+#endif /* __MYLLY_COLOURBLEND_H */
@@ -0,0 +1,44 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		ColourSrgb.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Table driven sRGB <-> linear colour conversion.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_COLOURSRGB_H
+#define __MYLLY_COLOURSRGB_H
+
+#include "stdtypes.h"
+#include "Math/Colour.h"
+#include "Math/Vector4.h"
+
+// A linear colour with 16 bits per channel (0-65535). Alpha is stored linearly as it is in colour_t.
+typedef struct
+{
+	uint16 r, g, b, a;
+} colour16_t;
+
+__BEGIN_DECLS
+
+// colour_t <-> 16-bit linear. Converting sRGB to linear and back returns the original colour.
+MYLLY_API void			colour_srgb_to_linear16		( colour16_t* result, const colour_t* c );
+MYLLY_API void			colour_linear16_to_srgb		( colour_t* result, const colour16_t* c );
+MYLLY_API void			colour_srgb_to_linear16_array	( colour16_t* result, const colour_t* c, uint32 count );
+MYLLY_API void			colour_linear16_to_srgb_array	( colour_t* result, const colour16_t* c, uint32 count );
+
+// colour_t <-> linear floats (x = r, y = g, z = b, w = a, all 0-1). Values outside 0-1 are clamped.
+MYLLY_API void			colour_srgb_to_linear_float_array	( vector4_t* result, const colour_t* c, uint32 count );
+MYLLY_API void			colour_linear_float_to_srgb_array	( colour_t* result, const vector4_t* c, uint32 count );
+
+// Gamma correct interpolation, the colours are blended in linear space. t is clamped to 0-1.
+MYLLY_API void			colour_lerp_srgb			( colour_t* result, const colour_t* c1, const colour_t* c2, float t );
+MYLLY_API void			colour_lerp_srgb_array		( colour_t* result, const colour_t* c1, const colour_t* c2, float t, uint32 count );
+
+__END_DECLS
+
+#endif /* __MYLLY_COLOURSRGB_H */
@@ -0,0 +1,236 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Frustum.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		View frustum extraction and culling.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/Frustum.h"
+#include "Math/MathSimd.h"
+#include <math.h>
+#include <string.h>
+
+static void frustum_set_plane( vector4_t* plane, float a, float b, float c, float d )
+{
+	float len = sqrtf( a * a + b * b + c * c );
+
+	// A degenerate plane (such as the far plane of an infinite projection) never culls anything.
+	if ( len == 0.0f )
+	{
+		plane->x = plane->y = plane->z = 0.0f;
+		plane->w = 1.0f;
+		return;
+	}
+
+	len = 1.0f / len;
+
+	plane->x = a * len;
+	plane->y = b * len;
+	plane->z = c * len;
+	plane->w = d * len;
+}
+
+void frustum_from_matrix4( frustum_t* frustum, const matrix4_t* m )
+{
+	if ( frustum == NULL || m == NULL ) return;
+
+	// Gribb & Hartmann: with row vectors clip = v * M, so the planes are combinations of the columns.
+	frustum_set_plane( &frustum->planes[FRUSTUM_LEFT], m->_14 + m->_11, m->_24 + m->_21, m->_34 + m->_31, m->_44 + m->_41 );
+	frustum_set_plane( &frustum->planes[FRUSTUM_RIGHT], m->_14 - m->_11, m->_24 - m->_21, m->_34 - m->_31, m->_44 - m->_41 );
+	frustum_set_plane( &frustum->planes[FRUSTUM_BOTTOM], m->_14 + m->_12, m->_24 + m->_22, m->_34 + m->_32, m->_44 + m->_42 );
+	frustum_set_plane( &frustum->planes[FRUSTUM_TOP], m->_14 - m->_12, m->_24 - m->_22, m->_34 - m->_32, m->_44 - m->_42 );
+	frustum_set_plane( &frustum->planes[FRUSTUM_NEAR], m->_13, m->_23, m->_33, m->_43 );
+	frustum_set_plane( &frustum->planes[FRUSTUM_FAR], m->_14 - m->_13, m->_24 - m->_23, m->_34 - m->_33, m->_44 - m->_43 );
+}
+
+// Shared by the sphere and box tests: a volume with the given center whose extent towards a plane
+// is r. The SIMD versions below do the exact same operations in the same order.
+static uint32 frustum_classify( const frustum_t* frustum, float x, float y, float z, const float r[FRUSTUM_PLANES] )
+{
+	const vector4_t* p;
+	uint32 i, result = FRUSTUM_IN;
+	float d;
+
+	for ( i = 0; i < FRUSTUM_PLANES; i++ )
+	{
+		p = &frustum->planes[i];
+		d = p->x * x + p->y * y + p->z * z + p->w;
+
+		if ( d < -r[i] ) return FRUSTUM_OUT;
+		if ( d < r[i] ) result = FRUSTUM_PARTIAL;
+	}
+
+	return result;
+}
+
+uint32 frustum_classify_sphere( const frustum_t* frustum, const vector3_t* center, float radius )
+{
+	float r[FRUSTUM_PLANES];
+	uint32 i;
+
+	for ( i = 0; i < FRUSTUM_PLANES; i++ ) r[i] = radius;
+
+	return frustum_classify( frustum, center->x, center->y, center->z, r );
+}
+
+uint32 frustum_classify_aabb( const frustum_t* frustum, const vector3_t* min, const vector3_t* max )
+{
+	const vector4_t* p;
+	float r[FRUSTUM_PLANES], ex, ey, ez;
+	uint32 i;
+
+	// Project the half extents onto each plane normal.
+	ex = ( max->x - min->x ) * 0.5f;
+	ey = ( max->y - min->y ) * 0.5f;
+	ez = ( max->z - min->z ) * 0.5f;
+
+	for ( i = 0; i < FRUSTUM_PLANES; i++ )
+	{
+		p = &frustum->planes[i];
+		r[i] = fabsf( p->x ) * ex + fabsf( p->y ) * ey + fabsf( p->z ) * ez;
+	}
+
+	return frustum_classify( frustum, ( min->x + max->x ) * 0.5f, ( min->y + max->y ) * 0.5f, ( min->z + max->z ) * 0.5f, r );
+}
+
+// Stores the results of one volume into the masks.
+static MYLLY_INLINE uint32 frustum_store_result( uint32 i, uint32 result, uint32* visible, uint32* partial )
+{
+	if ( result == FRUSTUM_OUT ) return 0;
+
+	visible[i / 32] |= 1u << ( i % 32 );
+	if ( partial != NULL && result == FRUSTUM_PARTIAL ) partial[i / 32] |= 1u << ( i % 32 );
+
+	return 1;
+}
+
+static void frustum_clear_masks( uint32 count, uint32* visible, uint32* partial )
+{
+	memset( visible, 0, ( ( count + 31 ) / 32 ) * sizeof( uint32 ) );
+	if ( partial != NULL ) memset( partial, 0, ( ( count + 31 ) / 32 ) * sizeof( uint32 ) );
+}
+
+// Planes splatted into vectors, one vector per plane component.
+typedef struct
+{
+	simd4f a[FRUSTUM_PLANES], b[FRUSTUM_PLANES], c[FRUSTUM_PLANES], d[FRUSTUM_PLANES];
+	simd4f abs_a[FRUSTUM_PLANES], abs_b[FRUSTUM_PLANES], abs_c[FRUSTUM_PLANES];
+} frustum_simd_t;
+
+static void frustum_splat( frustum_simd_t* f, const frustum_t* frustum )
+{
+	uint32 i;
+
+	for ( i = 0; i < FRUSTUM_PLANES; i++ )
+	{
+		f->a[i] = simd4f_set1( frustum->planes[i].x );
+		f->b[i] = simd4f_set1( frustum->planes[i].y );
+		f->c[i] = simd4f_set1( frustum->planes[i].z );
+		f->d[i] = simd4f_set1( frustum->planes[i].w );
+		f->abs_a[i] = simd4f_set1( fabsf( frustum->planes[i].x ) );
+		f->abs_b[i] = simd4f_set1( fabsf( frustum->planes[i].y ) );
+		f->abs_c[i] = simd4f_set1( fabsf( frustum->planes[i].z ) );
+	}
+}
+
+// Classifies four volumes against one plane and accumulates the out and partial lane masks.
+#define FRUSTUM_TEST_PLANE(f, i, x, y, z, r, out, part) \
+	{ \
+		simd4f d = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( f.a[i], x ), simd4f_mul( f.b[i], y ) ), simd4f_mul( f.c[i], z ) ), f.d[i] ); \
+		out = simd4f_or( out, simd4f_cmplt( d, simd4f_sub( simd4f_zero(), r ) ) ); \
+		part = simd4f_or( part, simd4f_cmplt( d, r ) ); \
+	}
+
+// Writes four lanes of results into the masks.
+static MYLLY_INLINE uint32 frustum_store_lanes( uint32 i, simd4f out, simd4f part, uint32* visible, uint32* partial )
+{
+	uint32 vis = ~simd4f_movemask( out ) & 0xF;
+
+	visible[i / 32] |= vis << ( i % 32 );
+	if ( partial != NULL ) partial[i / 32] |= ( simd4f_movemask( part ) & vis ) << ( i % 32 );
+
+	return ( vis & 1 ) + ( ( vis >> 1 ) & 1 ) + ( ( vis >> 2 ) & 1 ) + ( vis >> 3 );
+}
+
+uint32 frustum_cull_spheres( const frustum_t* frustum, const vector3_t* centers, const float* radii, uint32 count, uint32* visible, uint32* partial )
+{
+	frustum_simd_t f;
+	simd4f x, y, z, r, out, part;
+	uint32 i = 0, j, num_visible = 0;
+
+	if ( frustum == NULL || centers == NULL || radii == NULL || visible == NULL ) return 0;
+
+	frustum_clear_masks( count, visible, partial );
+	frustum_splat( &f, frustum );
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		x = simd4f_set( centers[i].x, centers[i+1].x, centers[i+2].x, centers[i+3].x );
+		y = simd4f_set( centers[i].y, centers[i+1].y, centers[i+2].y, centers[i+3].y );
+		z = simd4f_set( centers[i].z, centers[i+1].z, centers[i+2].z, centers[i+3].z );
+		r = simd4f_loadu( &radii[i] );
+
+		out = part = simd4f_zero();
+
+		for ( j = 0; j < FRUSTUM_PLANES; j++ )
+			FRUSTUM_TEST_PLANE( f, j, x, y, z, r, out, part );
+
+		num_visible += frustum_store_lanes( i, out, part, visible, partial );
+	}
+
+	for ( ; i < count; i++ )
+		num_visible += frustum_store_result( i, frustum_classify_sphere( frustum, &centers[i], radii[i] ), visible, partial );
+
+	return num_visible;
+}
+
+uint32 frustum_cull_aabbs( const frustum_t* frustum, const vector3_t* mins, const vector3_t* maxs, uint32 count, uint32* visible, uint32* partial )
+{
+	frustum_simd_t f;
+	simd4f x, y, z, ex, ey, ez, r, out, part, half;
+	simd4f x0, y0, z0, x1, y1, z1;
+	uint32 i = 0, j, num_visible = 0;
+
+	if ( frustum == NULL || mins == NULL || maxs == NULL || visible == NULL ) return 0;
+
+	frustum_clear_masks( count, visible, partial );
+	frustum_splat( &f, frustum );
+
+	half = simd4f_set1( 0.5f );
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		x0 = simd4f_set( mins[i].x, mins[i+1].x, mins[i+2].x, mins[i+3].x );
+		y0 = simd4f_set( mins[i].y, mins[i+1].y, mins[i+2].y, mins[i+3].y );
+		z0 = simd4f_set( mins[i].z, mins[i+1].z, mins[i+2].z, mins[i+3].z );
+		x1 = simd4f_set( maxs[i].x, maxs[i+1].x, maxs[i+2].x, maxs[i+3].x );
+		y1 = simd4f_set( maxs[i].y, maxs[i+1].y, maxs[i+2].y, maxs[i+3].y );
+		z1 = simd4f_set( maxs[i].z, maxs[i+1].z, maxs[i+2].z, maxs[i+3].z );
+
+		x = simd4f_mul( simd4f_add( x0, x1 ), half );
+		y = simd4f_mul( simd4f_add( y0, y1 ), half );
+		z = simd4f_mul( simd4f_add( z0, z1 ), half );
+		ex = simd4f_mul( simd4f_sub( x1, x0 ), half );
+		ey = simd4f_mul( simd4f_sub( y1, y0 ), half );
+		ez = simd4f_mul( simd4f_sub( z1, z0 ), half );
+
+		out = part = simd4f_zero();
+
+		for ( j = 0; j < FRUSTUM_PLANES; j++ )
+		{
+			r = simd4f_add( simd4f_add( simd4f_mul( f.abs_a[j], ex ), simd4f_mul( f.abs_b[j], ey ) ), simd4f_mul( f.abs_c[j], ez ) );
+			FRUSTUM_TEST_PLANE( f, j, x, y, z, r, out, part );
+		}
+
+		num_visible += frustum_store_lanes( i, out, part, visible, partial );
+	}
+
+	for ( ; i < count; i++ )
+		num_visible += frustum_store_result( i, frustum_classify_aabb( frustum, &mins[i], &maxs[i] ), visible, partial );
+
+	return num_visible;
+}
@@ -0,0 +1,64 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Frustum.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		View frustum extraction and culling.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_FRUSTUM_H
+#define __MYLLY_FRUSTUM_H
+
+#include "stdtypes.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+#include "Math/Vector4.h"
+
+enum
+{
+	FRUSTUM_LEFT,
+	FRUSTUM_RIGHT,
+	FRUSTUM_BOTTOM,
+	FRUSTUM_TOP,
+	FRUSTUM_NEAR,
+	FRUSTUM_FAR,
+	FRUSTUM_PLANES
+};
+
+// Return values of the single volume tests
+enum
+{
+	FRUSTUM_OUT,		// The volume is entirely outside the frustum
+	FRUSTUM_IN,			// The volume is entirely inside the frustum
+	FRUSTUM_PARTIAL		// The volume intersects the frustum
+};
+
+// Each plane is stored as ( a, b, c, d ) with the normal pointing inside, so a point p is inside
+// the plane when a * p.x + b * p.y + c * p.z + d >= 0.
+typedef struct
+{
+	vector4_t planes[FRUSTUM_PLANES];
+} frustum_t;
+
+__BEGIN_DECLS
+
+// Extracts normalized planes from a view-projection matrix (or a projection matrix for view space
+// planes). Uses the Direct3D convention of row vectors and clip space z in [0, w].
+MYLLY_API void			frustum_from_matrix4		( frustum_t* frustum, const matrix4_t* view_proj );
+
+MYLLY_API uint32		frustum_classify_sphere		( const frustum_t* frustum, const vector3_t* center, float radius );
+MYLLY_API uint32		frustum_classify_aabb		( const frustum_t* frustum, const vector3_t* min, const vector3_t* max );
+
+// Batch tests. Bit i % 32 of visible[i / 32] is set when volume i is at least partially inside the
+// frustum, the same bit in partial (which may be NULL) when it crosses a plane. Both masks must
+// hold ( count + 31 ) / 32 words. Returns the number of visible volumes.
+MYLLY_API uint32		frustum_cull_spheres		( const frustum_t* frustum, const vector3_t* centers, const float* radii, uint32 count, uint32* visible, uint32* partial );
+MYLLY_API uint32		frustum_cull_aabbs			( const frustum_t* frustum, const vector3_t* mins, const vector3_t* maxs, uint32 count, uint32* visible, uint32* partial );
+
+__END_DECLS
+
+#endif /* __MYLLY_FRUSTUM_H */
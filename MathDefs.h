@@ -17,15 +17,31 @@
 #define	MAX_FLOAT_ERROR		0.000001f
 
 // Math types
+#include "Math/Aabb3.h"
+#include "Math/Affine3x4.h"
+#include "Math/Bvh.h"
+#include "Math/Camera.h"
 #include "Math/Colour.h"
+#include "Math/ColourBlend.h"
+#include "Math/ColourSrgb.h"
+#include "Math/Frustum.h"
 #include "Math/Matrix4.h"
+#include "Math/Matrix4d.h"
+#include "Math/Quaternion.h"
 #include "Math/Rectangle.h"
+#include "Math/RectangleGrid.h"
+#include "Math/Region.h"
+#include "Math/Transform.h"
 #include "Math/Vector2.h"
 #include "Math/Vector3.h"
+#include "Math/Vector3d.h"
 #include "Math/Vector4.h"
 #include "Math/VectorScreen.h"
+#include "Math/VectorSoA.h"
 
 // Utility functions
+#include "Math/MathPack.h"
+#include "Math/MathTrig.h"
 #include "Math/MathUtils.h"
 
 #endif /* __MYLLY_MATH_DEFS_H */
@@ -0,0 +1,29 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		MathInline.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Switch for the header-only build of the small kernels.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_MATH_INLINE_H
+#define __MYLLY_MATH_INLINE_H
+
+#include "stdtypes.h"
+
+// Define MYLLY_MATH_INLINE before including the math headers to have Vector2.h, Vector3.h,
+// Vector4.h and Colour.h provide static inline versions of their small functions, so they can be
+// inlined at the call site without LTO. The definitions are shared with the library (*.inl),
+// which always builds the out-of-line versions because its sources define MYLLY_MATH_BUILD.
+#if defined(MYLLY_MATH_INLINE) && !defined(MYLLY_MATH_BUILD)
+#define MYLLY_MATH_USE_INLINE
+#define MYLLY_MATH_KERNEL	static MYLLY_INLINE
+#else
+#define MYLLY_MATH_KERNEL
+#endif
+
+#endif /* __MYLLY_MATH_INLINE_H */
@@ -0,0 +1,960 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		MathPack.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Conversions between floats and packed vertex formats.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/MathPack.h"
+#include "Math/MathSimd.h"
+#include "Math/MathUtils.h"
+#include <string.h>
+
+typedef union { float f; uint32 u; } pack_bits_t;
+
+// --------------------------------------------------
+// Half floats
+// --------------------------------------------------
+
+// Rounds to nearest even. Denormal halves are rounded by a float add which lines the mantissa up
+// with the half denormal step. NaNs keep the top bits of their payload and are made quiet in both
+// directions, which is what F16C does as well.
+uint16 math_pack_half( float value )
+{
+	pack_bits_t f, magic;
+	uint32 sign, h;
+
+	f.f = value;
+	sign = f.u & 0x80000000;
+	f.u ^= sign;
+
+	if ( f.u >= 0x47800000 )
+	{
+		// Rounds to infinity, or is infinity or NaN already.
+		h = f.u > 0x7F800000 ? 0x7E00 | ( ( f.u >> 13 ) & 0x3FF ) : 0x7C00;
+	}
+	else if ( f.u < 0x38800000 )
+	{
+		// Zero or denormal, adding 0.5 leaves the rounded half mantissa in the low bits.
+		magic.u = 0x3F000000;
+		f.f += magic.f;
+		h = f.u - magic.u;
+	}
+	else
+	{
+		// Rebias the exponent and round, a carry out of the mantissa bumps the exponent.
+		h = ( f.u + 0xC8000FFF + ( ( f.u >> 13 ) & 1 ) ) >> 13;
+	}
+
+	return (uint16)( h | ( sign >> 16 ) );
+}
+
+float math_unpack_half( uint16 value )
+{
+	pack_bits_t f, magic;
+	uint32 exp;
+
+	f.u = ( value & 0x7FFF ) << 13;
+	exp = f.u & 0x0F800000;
+	f.u += 0x38000000;
+
+	if ( exp == 0x0F800000 )
+	{
+		// Infinity or NaN, NaNs are made quiet.
+		f.u += 0x38000000;
+		if ( value & 0x3FF ) f.u |= 0x00400000;
+	}
+	else if ( exp == 0 )
+	{
+		// Zero or denormal, renormalized by subtracting the implicit one.
+		magic.u = 0x38800000;
+		f.u += 0x00800000;
+		f.f -= magic.f;
+	}
+
+	f.u |= (uint32)( value & 0x8000 ) << 16;
+	return f.f;
+}
+
+static void math_pack_half_c( uint16* result, const float* values, uint32 count )
+{
+	uint32 i;
+
+	for ( i = 0; i < count; i++ )
+		result[i] = math_pack_half( values[i] );
+}
+
+static void math_unpack_half_c( float* result, const uint16* values, uint32 count )
+{
+	uint32 i;
+
+	for ( i = 0; i < count; i++ )
+		result[i] = math_unpack_half( values[i] );
+}
+
+#if defined(MYLLY_MATH_SSE2)
+
+static MYLLY_INLINE __m128i pack_select_si128( __m128i mask, __m128i a, __m128i b )
+{
+	return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) );
+}
+
+// math_pack_half for four floats, the halves are returned in the low 16 bits of each lane.
+// All three cases are computed and the right one is selected per lane.
+static MYLLY_INLINE __m128i math_pack_half4( __m128 value )
+{
+	__m128i f, sign, big, nan, small, hb, hs, hn;
+
+	f = _mm_castps_si128( value );
+	sign = _mm_and_si128( f, _mm_set1_epi32( (int32)0x80000000 ) );
+	f = _mm_xor_si128( f, sign );
+
+	big = _mm_cmpgt_epi32( f, _mm_set1_epi32( 0x477FFFFF ) );
+	nan = _mm_cmpgt_epi32( f, _mm_set1_epi32( 0x7F800000 ) );
+	small = _mm_cmplt_epi32( f, _mm_set1_epi32( 0x38800000 ) );
+
+	hb = _mm_or_si128( _mm_set1_epi32( 0x200 ), _mm_and_si128( _mm_srli_epi32( f, 13 ), _mm_set1_epi32( 0x3FF ) ) );
+	hb = _mm_or_si128( _mm_set1_epi32( 0x7C00 ), _mm_and_si128( nan, hb ) );
+
+	hs = _mm_castps_si128( _mm_add_ps( _mm_castsi128_ps( f ), _mm_set1_ps( 0.5f ) ) );
+	hs = _mm_sub_epi32( hs, _mm_set1_epi32( 0x3F000000 ) );
+
+	hn = _mm_and_si128( _mm_srli_epi32( f, 13 ), _mm_set1_epi32( 1 ) );
+	hn = _mm_add_epi32( _mm_add_epi32( f, _mm_set1_epi32( (int32)0xC8000FFF ) ), hn );
+	hn = _mm_srli_epi32( hn, 13 );
+
+	hn = pack_select_si128( small, hs, hn );
+	hn = pack_select_si128( big, hb, hn );
+
+	return _mm_or_si128( hn, _mm_srli_epi32( sign, 16 ) );
+}
+
+// math_unpack_half for four halves which have been zero extended to 32 bits.
+static MYLLY_INLINE __m128 math_unpack_half4( __m128i h )
+{
+	__m128i f, exp, special, zero, nan;
+	__m128 denormal;
+
+	f = _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 0x7FFF ) ), 13 );
+	exp = _mm_and_si128( f, _mm_set1_epi32( 0x0F800000 ) );
+	special = _mm_cmpeq_epi32( exp, _mm_set1_epi32( 0x0F800000 ) );
+	zero = _mm_cmpeq_epi32( exp, _mm_setzero_si128() );
+	nan = _mm_andnot_si128( _mm_cmpeq_epi32( _mm_and_si128( h, _mm_set1_epi32( 0x3FF ) ), _mm_setzero_si128() ), special );
+
+	f = _mm_add_epi32( f, _mm_set1_epi32( 0x38000000 ) );
+	f = _mm_add_epi32( f, _mm_and_si128( special, _mm_set1_epi32( 0x38000000 ) ) );
+	f = _mm_or_si128( f, _mm_and_si128( nan, _mm_set1_epi32( 0x00400000 ) ) );
+
+	denormal = _mm_castsi128_ps( _mm_add_epi32( f, _mm_set1_epi32( 0x00800000 ) ) );
+	denormal = _mm_sub_ps( denormal, _mm_castsi128_ps( _mm_set1_epi32( 0x38800000 ) ) );
+	f = pack_select_si128( zero, _mm_castps_si128( denormal ), f );
+
+	f = _mm_or_si128( f, _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 0x8000 ) ), 16 ) );
+	return _mm_castsi128_ps( f );
+}
+
+static void math_pack_half_sse2( uint16* result, const float* values, uint32 count )
+{
+	__m128i lo, hi;
+	uint32 i;
+
+	for ( i = 0; i + 8 <= count; i += 8 )
+	{
+		lo = math_pack_half4( _mm_loadu_ps( values + i ) );
+		hi = math_pack_half4( _mm_loadu_ps( values + i + 4 ) );
+
+		// Sign extend so the saturating pack keeps the 16 bit patterns as they are.
+		lo = _mm_srai_epi32( _mm_slli_epi32( lo, 16 ), 16 );
+		hi = _mm_srai_epi32( _mm_slli_epi32( hi, 16 ), 16 );
+
+		_mm_storeu_si128( (__m128i*)( result + i ), _mm_packs_epi32( lo, hi ) );
+	}
+
+	for ( ; i < count; i++ )
+		result[i] = math_pack_half( values[i] );
+}
+
+static void math_unpack_half_sse2( float* result, const uint16* values, uint32 count )
+{
+	__m128i h, zero = _mm_setzero_si128();
+	uint32 i;
+
+	for ( i = 0; i + 8 <= count; i += 8 )
+	{
+		h = _mm_loadu_si128( (const __m128i*)( values + i ) );
+
+		_mm_storeu_ps( result + i, math_unpack_half4( _mm_unpacklo_epi16( h, zero ) ) );
+		_mm_storeu_ps( result + i + 4, math_unpack_half4( _mm_unpackhi_epi16( h, zero ) ) );
+	}
+
+	for ( ; i < count; i++ )
+		result[i] = math_unpack_half( values[i] );
+}
+
+#elif defined(MYLLY_MATH_NEON)
+
+// AArch64 converts between halves and floats natively, with the same rounding and NaN handling.
+static void math_pack_half_neon( uint16* result, const float* values, uint32 count )
+{
+	uint32 i;
+
+	for ( i = 0; i + 4 <= count; i += 4 )
+		vst1_u16( result + i, vreinterpret_u16_f16( vcvt_f16_f32( vld1q_f32( values + i ) ) ) );
+
+	for ( ; i < count; i++ )
+		result[i] = math_pack_half( values[i] );
+}
+
+static void math_unpack_half_neon( float* result, const uint16* values, uint32 count )
+{
+	uint32 i;
+
+	for ( i = 0; i + 4 <= count; i += 4 )
+		vst1q_f32( result + i, vcvt_f32_f16( vreinterpret_f16_u16( vld1_u16( values + i ) ) ) );
+
+	for ( ; i < count; i++ )
+		result[i] = math_unpack_half( values[i] );
+}
+
+#endif
+
+#ifdef MYLLY_MATH_F16C
+
+MATH_TARGET_F16C static void math_pack_half_f16c( uint16* result, const float* values, uint32 count )
+{
+	uint32 i;
+
+	for ( i = 0; i + 8 <= count; i += 8 )
+		_mm_storeu_si128( (__m128i*)( result + i ), _mm256_cvtps_ph( _mm256_loadu_ps( values + i ), _MM_FROUND_TO_NEAREST_INT ) );
+
+	for ( ; i < count; i++ )
+		result[i] = math_pack_half( values[i] );
+}
+
+MATH_TARGET_F16C static void math_unpack_half_f16c( float* result, const uint16* values, uint32 count )
+{
+	uint32 i;
+
+	for ( i = 0; i + 8 <= count; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_cvtph_ps( _mm_loadu_si128( (const __m128i*)( values + i ) ) ) );
+
+	for ( ; i < count; i++ )
+		result[i] = math_unpack_half( values[i] );
+}
+
+#endif
+
+typedef void ( *math_pack_half_func_t )( uint16* result, const float* values, uint32 count );
+typedef void ( *math_unpack_half_func_t )( float* result, const uint16* values, uint32 count );
+
+static void math_pack_half_select( uint16* result, const float* values, uint32 count );
+static void math_unpack_half_select( float* result, const uint16* values, uint32 count );
+static math_pack_half_func_t volatile math_pack_half_impl = math_pack_half_select;
+static math_unpack_half_func_t volatile math_unpack_half_impl = math_unpack_half_select;
+
+// Picks the best kernels for this CPU on the first call and replaces themselves with them. Threads
+// making their first call at the same time all pick the same kernel, the pointers are swapped atomically.
+static void math_pack_half_select( uint16* result, const float* values, uint32 count )
+{
+	uint32 features = math_cpu_features();
+	math_pack_half_func_t func = math_pack_half_c;
+
+#if defined(MYLLY_MATH_SSE2)
+	if ( features & MATH_CPU_SSE2 ) func = math_pack_half_sse2;
+#elif defined(MYLLY_MATH_NEON)
+	if ( features & MATH_CPU_NEON ) func = math_pack_half_neon;
+#endif
+#ifdef MYLLY_MATH_F16C
+	if ( features & MATH_CPU_F16C ) func = math_pack_half_f16c;
+#endif
+
+	(void)features;
+
+	math_atomic_store( &math_pack_half_impl, func );
+	func( result, values, count );
+}
+
+static void math_unpack_half_select( float* result, const uint16* values, uint32 count )
+{
+	uint32 features = math_cpu_features();
+	math_unpack_half_func_t func = math_unpack_half_c;
+
+#if defined(MYLLY_MATH_SSE2)
+	if ( features & MATH_CPU_SSE2 ) func = math_unpack_half_sse2;
+#elif defined(MYLLY_MATH_NEON)
+	if ( features & MATH_CPU_NEON ) func = math_unpack_half_neon;
+#endif
+#ifdef MYLLY_MATH_F16C
+	if ( features & MATH_CPU_F16C ) func = math_unpack_half_f16c;
+#endif
+
+	(void)features;
+
+	math_atomic_store( &math_unpack_half_impl, func );
+	func( result, values, count );
+}
+
+void math_pack_half_array( uint16* result, const float* values, uint32 count )
+{
+	math_pack_half_func_t func;
+
+	if ( result == NULL || values == NULL ) return;
+
+	func = math_atomic_load( &math_pack_half_impl );
+	func( result, values, count );
+}
+
+void math_unpack_half_array( float* result, const uint16* values, uint32 count )
+{
+	math_unpack_half_func_t func;
+
+	if ( result == NULL || values == NULL ) return;
+
+	func = math_atomic_load( &math_unpack_half_impl );
+	func( result, values, count );
+}
+
+// --------------------------------------------------
+// Normalized integer formats
+// --------------------------------------------------
+
+// Values are clamped, scaled and rounded as floats. The helpers below only move the resulting
+// whole numbers between float lanes and packed integers.
+static MYLLY_INLINE simd4f pack_scale4( simd4f value, simd4f lo, simd4f hi, simd4f scale )
+{
+	return simd4f_round( simd4f_mul( simd4f_min( simd4f_max( value, lo ), hi ), scale ) );
+}
+
+// Written like simd4f_max and simd4f_min so the tails give the same results as the vector loops.
+static MYLLY_INLINE float pack_scale( float value, float lo, float hi, float scale )
+{
+	value = value > lo ? value : lo;
+	value = value < hi ? value : hi;
+
+	return math_roundf_fast( value * scale );
+}
+
+static MYLLY_INLINE void pack_store_int16( int16* result, simd4f a, simd4f b )
+{
+#if defined(MYLLY_MATH_SSE2)
+	_mm_storeu_si128( (__m128i*)result, _mm_packs_epi32( _mm_cvttps_epi32( a ), _mm_cvttps_epi32( b ) ) );
+#elif defined(MYLLY_MATH_NEON)
+	vst1q_s16( result, vcombine_s16( vmovn_s32( vcvtq_s32_f32( a ) ), vmovn_s32( vcvtq_s32_f32( b ) ) ) );
+#else
+	uint32 i;
+
+	for ( i = 0; i < 4; i++ )
+	{
+		result[i] = (int16)a.f[i];
+		result[i+4] = (int16)b.f[i];
+	}
+#endif
+}
+
+static MYLLY_INLINE void pack_load_int16( simd4f* a, simd4f* b, const int16* values )
+{
+#if defined(MYLLY_MATH_SSE2)
+	__m128i v = _mm_loadu_si128( (const __m128i*)values );
+
+	*a = _mm_cvtepi32_ps( _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 ) );
+	*b = _mm_cvtepi32_ps( _mm_srai_epi32( _mm_unpackhi_epi16( v, v ), 16 ) );
+#elif defined(MYLLY_MATH_NEON)
+	int16x8_t v = vld1q_s16( values );
+
+	*a = vcvtq_f32_s32( vmovl_s16( vget_low_s16( v ) ) );
+	*b = vcvtq_f32_s32( vmovl_s16( vget_high_s16( v ) ) );
+#else
+	*a = simd4f_set( values[0], values[1], values[2], values[3] );
+	*b = simd4f_set( values[4], values[5], values[6], values[7] );
+#endif
+}
+
+static MYLLY_INLINE void pack_store_uint8( uint8* result, const simd4f v[4] )
+{
+#if defined(MYLLY_MATH_SSE2)
+	__m128i lo = _mm_packs_epi32( _mm_cvttps_epi32( v[0] ), _mm_cvttps_epi32( v[1] ) );
+	__m128i hi = _mm_packs_epi32( _mm_cvttps_epi32( v[2] ), _mm_cvttps_epi32( v[3] ) );
+
+	_mm_storeu_si128( (__m128i*)result, _mm_packus_epi16( lo, hi ) );
+#elif defined(MYLLY_MATH_NEON)
+	uint16x8_t lo = vcombine_u16( vmovn_u32( vcvtq_u32_f32( v[0] ) ), vmovn_u32( vcvtq_u32_f32( v[1] ) ) );
+	uint16x8_t hi = vcombine_u16( vmovn_u32( vcvtq_u32_f32( v[2] ) ), vmovn_u32( vcvtq_u32_f32( v[3] ) ) );
+
+	vst1q_u8( result, vcombine_u8( vmovn_u16( lo ), vmovn_u16( hi ) ) );
+#else
+	uint32 i, j;
+
+	for ( i = 0; i < 4; i++ )
+		for ( j = 0; j < 4; j++ )
+			result[4*i+j] = (uint8)v[i].f[j];
+#endif
+}
+
+static MYLLY_INLINE void pack_load_uint8( simd4f v[4], const uint8* values )
+{
+#if defined(MYLLY_MATH_SSE2)
+	__m128i zero = _mm_setzero_si128();
+	__m128i b = _mm_loadu_si128( (const __m128i*)values );
+	__m128i lo = _mm_unpacklo_epi8( b, zero );
+	__m128i hi = _mm_unpackhi_epi8( b, zero );
+
+	v[0] = _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) );
+	v[1] = _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) );
+	v[2] = _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) );
+	v[3] = _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) );
+#elif defined(MYLLY_MATH_NEON)
+	uint8x16_t b = vld1q_u8( values );
+	uint16x8_t lo = vmovl_u8( vget_low_u8( b ) );
+	uint16x8_t hi = vmovl_u8( vget_high_u8( b ) );
+
+	v[0] = vcvtq_f32_u32( vmovl_u16( vget_low_u16( lo ) ) );
+	v[1] = vcvtq_f32_u32( vmovl_u16( vget_high_u16( lo ) ) );
+	v[2] = vcvtq_f32_u32( vmovl_u16( vget_low_u16( hi ) ) );
+	v[3] = vcvtq_f32_u32( vmovl_u16( vget_high_u16( hi ) ) );
+#else
+	uint32 i;
+
+	for ( i = 0; i < 4; i++ )
+		v[i] = simd4f_set( values[4*i], values[4*i+1], values[4*i+2], values[4*i+3] );
+#endif
+}
+
+static MYLLY_INLINE void pack_store_1010102( uint32* result, simd4f x, simd4f y, simd4f z, simd4f w )
+{
+#if defined(MYLLY_MATH_SSE2)
+	__m128i p = _mm_cvttps_epi32( x );
+
+	p = _mm_or_si128( p, _mm_slli_epi32( _mm_cvttps_epi32( y ), 10 ) );
+	p = _mm_or_si128( p, _mm_slli_epi32( _mm_cvttps_epi32( z ), 20 ) );
+	p = _mm_or_si128( p, _mm_slli_epi32( _mm_cvttps_epi32( w ), 30 ) );
+
+	_mm_storeu_si128( (__m128i*)result, p );
+#elif defined(MYLLY_MATH_NEON)
+	uint32x4_t p = vcvtq_u32_f32( x );
+
+	p = vorrq_u32( p, vshlq_n_u32( vcvtq_u32_f32( y ), 10 ) );
+	p = vorrq_u32( p, vshlq_n_u32( vcvtq_u32_f32( z ), 20 ) );
+	p = vorrq_u32( p, vshlq_n_u32( vcvtq_u32_f32( w ), 30 ) );
+
+	vst1q_u32( result, p );
+#else
+	uint32 i;
+
+	for ( i = 0; i < 4; i++ )
+		result[i] = (uint32)x.f[i] | ( (uint32)y.f[i] << 10 ) | ( (uint32)z.f[i] << 20 ) | ( (uint32)w.f[i] << 30 );
+#endif
+}
+
+static MYLLY_INLINE void pack_load_1010102( simd4f* x, simd4f* y, simd4f* z, simd4f* w, const uint32* packed )
+{
+#if defined(MYLLY_MATH_SSE2)
+	__m128i p = _mm_loadu_si128( (const __m128i*)packed );
+	__m128i mask = _mm_set1_epi32( 0x3FF );
+
+	*x = _mm_cvtepi32_ps( _mm_and_si128( p, mask ) );
+	*y = _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( p, 10 ), mask ) );
+	*z = _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( p, 20 ), mask ) );
+	*w = _mm_cvtepi32_ps( _mm_srli_epi32( p, 30 ) );
+#elif defined(MYLLY_MATH_NEON)
+	uint32x4_t p = vld1q_u32( packed );
+	uint32x4_t mask = vdupq_n_u32( 0x3FF );
+
+	*x = vcvtq_f32_u32( vandq_u32( p, mask ) );
+	*y = vcvtq_f32_u32( vandq_u32( vshrq_n_u32( p, 10 ), mask ) );
+	*z = vcvtq_f32_u32( vandq_u32( vshrq_n_u32( p, 20 ), mask ) );
+	*w = vcvtq_f32_u32( vshrq_n_u32( p, 30 ) );
+#else
+	uint32 i;
+
+	for ( i = 0; i < 4; i++ )
+	{
+		x->f[i] = (float)( packed[i] & 0x3FF );
+		y->f[i] = (float)( ( packed[i] >> 10 ) & 0x3FF );
+		z->f[i] = (float)( ( packed[i] >> 20 ) & 0x3FF );
+		w->f[i] = (float)( packed[i] >> 30 );
+	}
+#endif
+}
+
+void math_pack_snorm16_array( int16* result, const float* values, uint32 count )
+{
+	simd4f lo = simd4f_set1( -1.0f ), hi = simd4f_set1( 1.0f ), scale = simd4f_set1( 32767.0f );
+	simd4f a, b;
+	uint32 i;
+
+	if ( result == NULL || values == NULL ) return;
+
+	for ( i = 0; i + 8 <= count; i += 8 )
+	{
+		a = pack_scale4( simd4f_loadu( values + i ), lo, hi, scale );
+		b = pack_scale4( simd4f_loadu( values + i + 4 ), lo, hi, scale );
+
+		pack_store_int16( result + i, a, b );
+	}
+
+	for ( ; i < count; i++ )
+		result[i] = (int16)pack_scale( values[i], -1.0f, 1.0f, 32767.0f );
+}
+
+void math_unpack_snorm16_array( float* result, const int16* values, uint32 count )
+{
+	simd4f lo = simd4f_set1( -1.0f ), scale = simd4f_set1( 32767.0f );
+	simd4f a, b;
+	float f;
+	uint32 i;
+
+	if ( result == NULL || values == NULL ) return;
+
+	for ( i = 0; i + 8 <= count; i += 8 )
+	{
+		pack_load_int16( &a, &b, values + i );
+
+		simd4f_storeu( result + i, simd4f_max( simd4f_div( a, scale ), lo ) );
+		simd4f_storeu( result + i + 4, simd4f_max( simd4f_div( b, scale ), lo ) );
+	}
+
+	for ( ; i < count; i++ )
+	{
+		f = (float)values[i] / 32767.0f;
+		result[i] = f > -1.0f ? f : -1.0f;
+	}
+}
+
+void math_pack_unorm8_array( uint8* result, const float* values, uint32 count )
+{
+	simd4f lo = simd4f_zero(), hi = simd4f_set1( 1.0f ), scale = simd4f_set1( 255.0f );
+	simd4f v[4];
+	uint32 i, j;
+
+	if ( result == NULL || values == NULL ) return;
+
+	for ( i = 0; i + 16 <= count; i += 16 )
+	{
+		for ( j = 0; j < 4; j++ )
+			v[j] = pack_scale4( simd4f_loadu( values + i + 4 * j ), lo, hi, scale );
+
+		pack_store_uint8( result + i, v );
+	}
+
+	for ( ; i < count; i++ )
+		result[i] = (uint8)pack_scale( values[i], 0.0f, 1.0f, 255.0f );
+}
+
+void math_unpack_unorm8_array( float* result, const uint8* values, uint32 count )
+{
+	simd4f scale = simd4f_set1( 255.0f );
+	simd4f v[4];
+	uint32 i, j;
+
+	if ( result == NULL || values == NULL ) return;
+
+	for ( i = 0; i + 16 <= count; i += 16 )
+	{
+		pack_load_uint8( v, values + i );
+
+		for ( j = 0; j < 4; j++ )
+			simd4f_storeu( result + i + 4 * j, simd4f_div( v[j], scale ) );
+	}
+
+	for ( ; i < count; i++ )
+		result[i] = values[i] / 255.0f;
+}
+
+void vector4_pack_unorm1010102_array( uint32* result, const vector4_t* v, uint32 count )
+{
+	simd4f lo = simd4f_zero(), hi = simd4f_set1( 1.0f ), scale10 = simd4f_set1( 1023.0f ), scale2 = simd4f_set1( 3.0f );
+	simd4f x, y, z, w;
+	uint32 i;
+
+	if ( result == NULL || v == NULL ) return;
+
+	for ( i = 0; i + 4 <= count; i += 4 )
+	{
+		x = simd4f_loadu( v[i].coords );
+		y = simd4f_loadu( v[i+1].coords );
+		z = simd4f_loadu( v[i+2].coords );
+		w = simd4f_loadu( v[i+3].coords );
+		simd4f_transpose( x, y, z, w );
+
+		x = pack_scale4( x, lo, hi, scale10 );
+		y = pack_scale4( y, lo, hi, scale10 );
+		z = pack_scale4( z, lo, hi, scale10 );
+		w = pack_scale4( w, lo, hi, scale2 );
+
+		pack_store_1010102( result + i, x, y, z, w );
+	}
+
+	for ( ; i < count; i++ )
+	{
+		result[i] = (uint32)pack_scale( v[i].x, 0.0f, 1.0f, 1023.0f ) |
+					( (uint32)pack_scale( v[i].y, 0.0f, 1.0f, 1023.0f ) << 10 ) |
+					( (uint32)pack_scale( v[i].z, 0.0f, 1.0f, 1023.0f ) << 20 ) |
+					( (uint32)pack_scale( v[i].w, 0.0f, 1.0f, 3.0f ) << 30 );
+	}
+}
+
+void vector4_unpack_unorm1010102_array( vector4_t* result, const uint32* packed, uint32 count )
+{
+	simd4f scale10 = simd4f_set1( 1023.0f ), scale2 = simd4f_set1( 3.0f );
+	simd4f x, y, z, w;
+	uint32 i;
+
+	if ( result == NULL || packed == NULL ) return;
+
+	for ( i = 0; i + 4 <= count; i += 4 )
+	{
+		pack_load_1010102( &x, &y, &z, &w, packed + i );
+
+		x = simd4f_div( x, scale10 );
+		y = simd4f_div( y, scale10 );
+		z = simd4f_div( z, scale10 );
+		w = simd4f_div( w, scale2 );
+		simd4f_transpose( x, y, z, w );
+
+		simd4f_storeu( result[i].coords, x );
+		simd4f_storeu( result[i+1].coords, y );
+		simd4f_storeu( result[i+2].coords, z );
+		simd4f_storeu( result[i+3].coords, w );
+	}
+
+	for ( ; i < count; i++ )
+	{
+		result[i].x = ( packed[i] & 0x3FF ) / 1023.0f;
+		result[i].y = ( ( packed[i] >> 10 ) & 0x3FF ) / 1023.0f;
+		result[i].z = ( ( packed[i] >> 20 ) & 0x3FF ) / 1023.0f;
+		result[i].w = ( packed[i] >> 30 ) / 3.0f;
+	}
+}
+
+// colour_t is stored a, b, g, r on little endian machines. The vector loops flip the channels of
+// four colours by transposing them into channel vectors and back again in reverse order.
+void colour_from_float_array( colour_t* result, const vector4_t* c, uint32 count )
+{
+	simd4f lo = simd4f_zero(), hi = simd4f_set1( 1.0f ), scale = simd4f_set1( 255.0f );
+	simd4f v[4];
+	uint32 i, j;
+
+	if ( result == NULL || c == NULL ) return;
+
+	for ( i = 0; i + 4 <= count; i += 4 )
+	{
+		for ( j = 0; j < 4; j++ )
+			v[j] = pack_scale4( simd4f_loadu( c[i+j].coords ), lo, hi, scale );
+
+#ifndef MYLLY_BIG_ENDIAN
+		simd4f_transpose( v[0], v[1], v[2], v[3] );
+		simd4f_transpose( v[3], v[2], v[1], v[0] );
+		{
+			simd4f abgr[4];
+
+			abgr[0] = v[3]; abgr[1] = v[2]; abgr[2] = v[1]; abgr[3] = v[0];
+			pack_store_uint8( (uint8*)&result[i], abgr );
+		}
+#else
+		pack_store_uint8( (uint8*)&result[i], v );
+#endif
+	}
+
+	for ( ; i < count; i++ )
+	{
+		result[i].r = (uint8)pack_scale( c[i].x, 0.0f, 1.0f, 255.0f );
+		result[i].g = (uint8)pack_scale( c[i].y, 0.0f, 1.0f, 255.0f );
+		result[i].b = (uint8)pack_scale( c[i].z, 0.0f, 1.0f, 255.0f );
+		result[i].a = (uint8)pack_scale( c[i].w, 0.0f, 1.0f, 255.0f );
+	}
+}
+
+void colour_to_float_array( vector4_t* result, const colour_t* c, uint32 count )
+{
+	simd4f scale = simd4f_set1( 255.0f );
+	simd4f v[4];
+	uint32 i, j;
+
+	if ( result == NULL || c == NULL ) return;
+
+	for ( i = 0; i + 4 <= count; i += 4 )
+	{
+		pack_load_uint8( v, (const uint8*)&c[i] );
+
+#ifndef MYLLY_BIG_ENDIAN
+		simd4f_transpose( v[0], v[1], v[2], v[3] );
+		simd4f_transpose( v[3], v[2], v[1], v[0] );
+
+		for ( j = 0; j < 4; j++ )
+			simd4f_storeu( result[i+j].coords, simd4f_div( v[3-j], scale ) );
+#else
+		for ( j = 0; j < 4; j++ )
+			simd4f_storeu( result[i+j].coords, simd4f_div( v[j], scale ) );
+#endif
+	}
+
+	for ( ; i < count; i++ )
+	{
+		result[i].x = c[i].r / 255.0f;
+		result[i].y = c[i].g / 255.0f;
+		result[i].z = c[i].b / 255.0f;
+		result[i].w = c[i].a / 255.0f;
+	}
+}
+
+// --------------------------------------------------
+// Octahedral unit vectors
+// --------------------------------------------------
+
+// Stores four x, y pairs of whole numbers as interleaved int8s, the int8 version of
+// simd4f_store_int16_pairs.
+static MYLLY_INLINE void pack_store_int8_pairs( int8* result, simd4f x, simd4f y )
+{
+#if defined(MYLLY_MATH_SSE2)
+	__m128i xy = _mm_packs_epi32( _mm_cvttps_epi32( x ), _mm_cvttps_epi32( y ) );
+
+	xy = _mm_packs_epi16( xy, xy );
+	_mm_storel_epi64( (__m128i*)result, _mm_unpacklo_epi8( xy, _mm_srli_si128( xy, 4 ) ) );
+#elif defined(MYLLY_MATH_NEON)
+	int8x8_t xy = vmovn_s16( vcombine_s16( vmovn_s32( vcvtq_s32_f32( x ) ), vmovn_s32( vcvtq_s32_f32( y ) ) ) );
+
+	vst1_s8( result, vzip_s8( xy, vext_s8( xy, xy, 4 ) ).val[0] );
+#else
+	uint32 i;
+
+	for ( i = 0; i < 4; i++ )
+	{
+		result[2*i] = (int8)x.f[i];
+		result[2*i+1] = (int8)y.f[i];
+	}
+#endif
+}
+
+static MYLLY_INLINE void pack_load_int16_pairs( simd4f* x, simd4f* y, const int16* packed )
+{
+#if defined(MYLLY_MATH_SSE2)
+	// Each 32 bit lane holds one pair, x in the low half.
+	__m128i p = _mm_loadu_si128( (const __m128i*)packed );
+
+	*x = _mm_cvtepi32_ps( _mm_srai_epi32( _mm_slli_epi32( p, 16 ), 16 ) );
+	*y = _mm_cvtepi32_ps( _mm_srai_epi32( p, 16 ) );
+#elif defined(MYLLY_MATH_NEON)
+	int16x4x2_t p = vld2_s16( packed );
+
+	*x = vcvtq_f32_s32( vmovl_s16( p.val[0] ) );
+	*y = vcvtq_f32_s32( vmovl_s16( p.val[1] ) );
+#else
+	*x = simd4f_set( packed[0], packed[2], packed[4], packed[6] );
+	*y = simd4f_set( packed[1], packed[3], packed[5], packed[7] );
+#endif
+}
+
+static MYLLY_INLINE void pack_load_int8_pairs( simd4f* x, simd4f* y, const int8* packed )
+{
+#if defined(MYLLY_MATH_SSE2)
+	// Widened to int16 pairs, after which it's the same as above.
+	__m128i p = _mm_loadl_epi64( (const __m128i*)packed );
+
+	p = _mm_srai_epi16( _mm_unpacklo_epi8( p, p ), 8 );
+
+	*x = _mm_cvtepi32_ps( _mm_srai_epi32( _mm_slli_epi32( p, 16 ), 16 ) );
+	*y = _mm_cvtepi32_ps( _mm_srai_epi32( p, 16 ) );
+#elif defined(MYLLY_MATH_NEON)
+	int8x8_t b = vld1_s8( packed );
+	int8x8x2_t p = vuzp_s8( b, b );
+
+	*x = vcvtq_f32_s32( vmovl_s16( vget_low_s16( vmovl_s8( p.val[0] ) ) ) );
+	*y = vcvtq_f32_s32( vmovl_s16( vget_low_s16( vmovl_s8( p.val[1] ) ) ) );
+#else
+	*x = simd4f_set( packed[0], packed[2], packed[4], packed[6] );
+	*y = simd4f_set( packed[1], packed[3], packed[5], packed[7] );
+#endif
+}
+
+// Projects four vectors onto the octahedron |x| + |y| + |z| = 1. The lower half (z < 0) is folded
+// over the edges of the upper one, so both end up in the [-1, 1] square.
+static MYLLY_INLINE void oct_encode4( simd4f* px, simd4f* py, const vector3_t* v )
+{
+	simd4f x, y, z, w, sum, fx, fy, one = simd4f_set1( 1.0f ), sign = simd4f_set1( -0.0f ), lower;
+
+	// The fourth load is done separately so nothing past the last vector is read.
+	x = simd4f_loadu( v[0].coords );
+	y = simd4f_loadu( v[1].coords );
+	z = simd4f_loadu( v[2].coords );
+	w = simd4f_set( v[3].x, v[3].y, v[3].z, 0.0f );
+	simd4f_transpose( x, y, z, w );
+
+	sum = simd4f_add( simd4f_add( simd4f_andnot( x, sign ), simd4f_andnot( y, sign ) ), simd4f_andnot( z, sign ) );
+	sum = simd4f_div( one, simd4f_max( sum, simd4f_set1( 1.0e-30f ) ) );
+
+	x = simd4f_mul( x, sum );
+	y = simd4f_mul( y, sum );
+
+	fx = simd4f_mul( simd4f_sub( one, simd4f_andnot( y, sign ) ), simd4f_or( one, simd4f_and( x, sign ) ) );
+	fy = simd4f_mul( simd4f_sub( one, simd4f_andnot( x, sign ) ), simd4f_or( one, simd4f_and( y, sign ) ) );
+
+	lower = simd4f_cmplt( z, simd4f_zero() );
+	*px = simd4f_select( lower, fx, x );
+	*py = simd4f_select( lower, fy, y );
+}
+
+// Inverse of oct_encode4 for points in the [-1, 1] square, the results are normalized.
+static MYLLY_INLINE void oct_decode4( vector3_t* result, simd4f x, simd4f y )
+{
+	simd4f z, w, t, len, sign = simd4f_set1( -0.0f );
+	float tmp[4];
+
+	// Points outside the inner diamond are on the lower half, unfold them.
+	z = simd4f_sub( simd4f_sub( simd4f_set1( 1.0f ), simd4f_andnot( x, sign ) ), simd4f_andnot( y, sign ) );
+	t = simd4f_max( simd4f_sub( simd4f_zero(), z ), simd4f_zero() );
+
+	x = simd4f_sub( x, simd4f_or( t, simd4f_and( x, sign ) ) );
+	y = simd4f_sub( y, simd4f_or( t, simd4f_and( y, sign ) ) );
+
+	len = simd4f_sqrt( simd4f_add( simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) ), simd4f_mul( z, z ) ) );
+	len = simd4f_div( simd4f_set1( 1.0f ), len );
+	x = simd4f_mul( x, len );
+	y = simd4f_mul( y, len );
+	z = simd4f_mul( z, len );
+
+	// Each store writes a float into the next vector, which is overwritten right after.
+	w = simd4f_zero();
+	simd4f_transpose( x, y, z, w );
+
+	simd4f_storeu( result[0].coords, x );
+	simd4f_storeu( result[1].coords, y );
+	simd4f_storeu( result[2].coords, z );
+	simd4f_storeu( tmp, w );
+
+	result[3].x = tmp[0];
+	result[3].y = tmp[1];
+	result[3].z = tmp[2];
+}
+
+// The last group goes through zero padded temporaries, so the tails give the same results.
+void vector3_pack_oct16_array( int16* result, const vector3_t* normals, uint32 count )
+{
+	simd4f lo = simd4f_set1( -1.0f ), hi = simd4f_set1( 1.0f ), scale = simd4f_set1( 32767.0f );
+	simd4f x, y;
+	vector3_t tmp[4];
+	int16 out[8];
+	uint32 i, n;
+
+	if ( result == NULL || normals == NULL ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		n = math_min( count - i, 4 );
+
+		if ( n == 4 )
+		{
+			oct_encode4( &x, &y, &normals[i] );
+			simd4f_store_int16_pairs( result + 2 * i, pack_scale4( x, lo, hi, scale ), pack_scale4( y, lo, hi, scale ) );
+		}
+		else
+		{
+			memset( tmp, 0, sizeof( tmp ) );
+			memcpy( tmp, &normals[i], n * sizeof( vector3_t ) );
+
+			oct_encode4( &x, &y, tmp );
+			simd4f_store_int16_pairs( out, pack_scale4( x, lo, hi, scale ), pack_scale4( y, lo, hi, scale ) );
+
+			memcpy( result + 2 * i, out, 2 * n * sizeof( int16 ) );
+		}
+	}
+}
+
+void vector3_unpack_oct16_array( vector3_t* result, const int16* packed, uint32 count )
+{
+	simd4f lo = simd4f_set1( -1.0f ), scale = simd4f_set1( 1.0f / 32767.0f );
+	simd4f x, y;
+	vector3_t tmp[4];
+	int16 in[8];
+	uint32 i, n;
+
+	if ( result == NULL || packed == NULL ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		n = math_min( count - i, 4 );
+
+		if ( n == 4 )
+		{
+			pack_load_int16_pairs( &x, &y, packed + 2 * i );
+			oct_decode4( &result[i], simd4f_max( simd4f_mul( x, scale ), lo ), simd4f_max( simd4f_mul( y, scale ), lo ) );
+		}
+		else
+		{
+			memset( in, 0, sizeof( in ) );
+			memcpy( in, packed + 2 * i, 2 * n * sizeof( int16 ) );
+
+			pack_load_int16_pairs( &x, &y, in );
+			oct_decode4( tmp, simd4f_max( simd4f_mul( x, scale ), lo ), simd4f_max( simd4f_mul( y, scale ), lo ) );
+
+			memcpy( &result[i], tmp, n * sizeof( vector3_t ) );
+		}
+	}
+}
+
+void vector3_pack_oct8_array( int8* result, const vector3_t* normals, uint32 count )
+{
+	simd4f lo = simd4f_set1( -1.0f ), hi = simd4f_set1( 1.0f ), scale = simd4f_set1( 127.0f );
+	simd4f x, y;
+	vector3_t tmp[4];
+	int8 out[8];
+	uint32 i, n;
+
+	if ( result == NULL || normals == NULL ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		n = math_min( count - i, 4 );
+
+		if ( n == 4 )
+		{
+			oct_encode4( &x, &y, &normals[i] );
+			pack_store_int8_pairs( result + 2 * i, pack_scale4( x, lo, hi, scale ), pack_scale4( y, lo, hi, scale ) );
+		}
+		else
+		{
+			memset( tmp, 0, sizeof( tmp ) );
+			memcpy( tmp, &normals[i], n * sizeof( vector3_t ) );
+
+			oct_encode4( &x, &y, tmp );
+			pack_store_int8_pairs( out, pack_scale4( x, lo, hi, scale ), pack_scale4( y, lo, hi, scale ) );
+
+			memcpy( result + 2 * i, out, 2 * n * sizeof( int8 ) );
+		}
+	}
+}
+
+void vector3_unpack_oct8_array( vector3_t* result, const int8* packed, uint32 count )
+{
+	simd4f lo = simd4f_set1( -1.0f ), scale = simd4f_set1( 1.0f / 127.0f );
+	simd4f x, y;
+	vector3_t tmp[4];
+	int8 in[8];
+	uint32 i, n;
+
+	if ( result == NULL || packed == NULL ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		n = math_min( count - i, 4 );
+
+		if ( n == 4 )
+		{
+			pack_load_int8_pairs( &x, &y, packed + 2 * i );
+			oct_decode4( &result[i], simd4f_max( simd4f_mul( x, scale ), lo ), simd4f_max( simd4f_mul( y, scale ), lo ) );
+		}
+		else
+		{
+			memset( in, 0, sizeof( in ) );
+			memcpy( in, packed + 2 * i, 2 * n * sizeof( int8 ) );
+
+			pack_load_int8_pairs( &x, &y, in );
+			oct_decode4( tmp, simd4f_max( simd4f_mul( x, scale ), lo ), simd4f_max( simd4f_mul( y, scale ), lo ) );
+
+			memcpy( &result[i], tmp, n * sizeof( vector3_t ) );
+		}
+	}
+}
@@ -0,0 +1,65 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		MathPack.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Conversions between floats and packed vertex formats.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_MATHPACK_H
+#define __MYLLY_MATHPACK_H
+
+#include "stdtypes.h"
+#include "Math/Vector3.h"
+#include "Math/Vector4.h"
+#include "Math/Colour.h"
+
+__BEGIN_DECLS
+
+// The array versions work on flat float arrays, vector2_t, vector3_t and vector4_t arrays are
+// converted by passing &v[0].x and two, three or four times the number of vectors as count.
+// Values outside the range of the format are clamped and all packing rounds to the nearest value.
+
+// IEEE 754 half floats. Values too large for a half become infinity. The array versions use the
+// F16C instructions when the CPU has them, all versions give identical results.
+MYLLY_API uint16		math_pack_half				( float value );
+MYLLY_API float			math_unpack_half			( uint16 value );
+MYLLY_API void			math_pack_half_array		( uint16* result, const float* values, uint32 count );
+MYLLY_API void			math_unpack_half_array		( float* result, const uint16* values, uint32 count );
+
+// -1 to 1 <-> -32767 to 32767. -32768 unpacks to -1 as well.
+MYLLY_API void			math_pack_snorm16_array		( int16* result, const float* values, uint32 count );
+MYLLY_API void			math_unpack_snorm16_array	( float* result, const int16* values, uint32 count );
+
+// 0 to 1 <-> 0 to 255
+MYLLY_API void			math_pack_unorm8_array		( uint8* result, const float* values, uint32 count );
+MYLLY_API void			math_unpack_unorm8_array	( float* result, const uint8* values, uint32 count );
+
+// x, y and z as 10 bit unorms in bits 0-29 and w as a 2 bit unorm in bits 30-31, the layout of
+// DXGI_FORMAT_R10G10B10A2_UNORM and GL_UNSIGNED_INT_2_10_10_10_REV.
+MYLLY_API void			vector4_pack_unorm1010102_array		( uint32* result, const vector4_t* v, uint32 count );
+MYLLY_API void			vector4_unpack_unorm1010102_array	( vector4_t* result, const uint32* packed, uint32 count );
+
+// colour_t <-> floats (x = r, y = g, z = b, w = a, all 0-1) without any gamma conversion, see
+// ColourSrgb.h for the linear versions.
+MYLLY_API void			colour_from_float_array		( colour_t* result, const vector4_t* c, uint32 count );
+MYLLY_API void			colour_to_float_array		( vector4_t* result, const colour_t* c, uint32 count );
+
+// Unit vectors in octahedral encoding, two snorms per vector (R16G16_SNORM or R8G8_SNORM) which
+// are written x, y, x, y... The vectors are projected onto an octahedron which is unfolded into a
+// square, this spreads the precision evenly over the sphere. Decoded vectors are normalized and
+// zero vectors decode to (0, 0, 1). Measured over a million random unit vectors, the largest
+// angle between a vector and its decoded version is 0.0037 degrees for 16 bits and 0.95 degrees
+// for 8 bits, 0.0013 and 0.34 degrees on average.
+MYLLY_API void			vector3_pack_oct16_array	( int16* result, const vector3_t* normals, uint32 count );
+MYLLY_API void			vector3_unpack_oct16_array	( vector3_t* result, const int16* packed, uint32 count );
+MYLLY_API void			vector3_pack_oct8_array		( int8* result, const vector3_t* normals, uint32 count );
+MYLLY_API void			vector3_unpack_oct8_array	( vector3_t* result, const int8* packed, uint32 count );
+
+__END_DECLS
+
+#endif /* __MYLLY_MATHPACK_H */
@@ -0,0 +1,127 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		MathSimd.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		SIMD abstraction and CPU feature detection.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/MathSimd.h"
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#if defined(MYLLY_MATH_SSE2) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(MYLLY_MATH_SSE2)
+#include <cpuid.h>
+#endif
+
+// The detected features and a flag telling they have been detected, kept in a single word so that
+// no thread can see the flag without the features.
+#define MATH_CPU_DETECTED	0x80000000
+
+static volatile uint32 cpu_features = 0;
+
+#if defined(MYLLY_MATH_SSE2)
+
+static void math_cpuid( uint32 leaf, uint32 regs[4] )
+{
+#ifdef _MSC_VER
+	__cpuid( (int*)regs, (int)leaf );
+#else
+	__cpuid( leaf, regs[0], regs[1], regs[2], regs[3] );
+#endif
+}
+
+static uint64 math_xgetbv( void )
+{
+#ifdef _MSC_VER
+	return _xgetbv( 0 );
+#else
+	uint32 eax, edx;
+	__asm__ __volatile__ ( "xgetbv" : "=a" (eax), "=d" (edx) : "c" (0) );
+	return ( (uint64)edx << 32 ) | eax;
+#endif
+}
+
+static uint32 math_detect_features( void )
+{
+	uint32 regs[4], features = MATH_CPU_SSE2;
+
+	math_cpuid( 0, regs );
+	if ( regs[0] < 1 ) return features;
+
+	math_cpuid( 1, regs );
+
+	// AVX needs both the CPU flag and the OS saving the YMM state (OSXSAVE + XCR0 bits 1 and 2).
+	// F16C instructions are VEX encoded and have the same requirement.
+	if ( ( regs[2] & ( 1 << 28 ) ) && ( regs[2] & ( 1 << 27 ) ) )
+	{
+		if ( ( math_xgetbv() & 0x6 ) == 0x6 )
+		{
+			features |= MATH_CPU_AVX;
+			if ( regs[2] & ( 1 << 29 ) ) features |= MATH_CPU_F16C;
+		}
+	}
+
+	return features;
+}
+
+#elif defined(MYLLY_MATH_NEON)
+
+static uint32 math_detect_features( void )
+{
+	// NEON is a mandatory part of AArch64.
+	return MATH_CPU_NEON;
+}
+
+#else
+
+static uint32 math_detect_features( void )
+{
+	return 0;
+}
+
+#endif
+
+uint32 math_cpu_features( void )
+{
+	uint32 features = math_atomic_load( &cpu_features );
+
+	// Threads calling this at the same time for the first time all detect the same features.
+	if ( !( features & MATH_CPU_DETECTED ) )
+	{
+		features = math_detect_features() | MATH_CPU_DETECTED;
+		math_atomic_store( &cpu_features, features );
+	}
+
+	return features & ~MATH_CPU_DETECTED;
+}
+
+void* math_aligned_alloc( size_t size, size_t alignment )
+{
+#ifdef _WIN32
+	return _aligned_malloc( size, alignment );
+#else
+	void* ptr;
+	if ( posix_memalign( &ptr, alignment, size ) != 0 ) return NULL;
+	return ptr;
+#endif
+}
+
+void math_aligned_free( void* ptr )
+{
+	if ( ptr == NULL ) return;
+
+#ifdef _WIN32
+	_aligned_free( ptr );
+#else
+	free( ptr );
+#endif
+}
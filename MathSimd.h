@@ -0,0 +1,298 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		MathSimd.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		SIMD abstraction and CPU feature detection.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_MATH_SIMD_H
+#define __MYLLY_MATH_SIMD_H
+
+#include "stdtypes.h"
+#include "Math/MathUtils.h"
+
+// Select the instruction set used by the simd4f wrappers. Define MYLLY_MATH_NO_SIMD to force the scalar versions.
+#ifndef MYLLY_MATH_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define MYLLY_MATH_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MYLLY_MATH_NEON
+#endif
+#endif
+
+// AVX kernels are compiled per function and only called when the CPU supports them.
+#if defined(MYLLY_MATH_SSE2) && ( defined(__GNUC__) || defined(__clang__) )
+#define MYLLY_MATH_AVX
+#define MYLLY_MATH_F16C
+#define MATH_TARGET_AVX __attribute__(( target( "avx" ) ))
+#define MATH_TARGET_F16C __attribute__(( target( "avx,f16c" ) ))
+#elif defined(MYLLY_MATH_SSE2) && defined(_MSC_VER)
+#define MYLLY_MATH_AVX
+#define MYLLY_MATH_F16C
+#define MATH_TARGET_AVX
+#define MATH_TARGET_F16C
+#endif
+
+#if defined(MYLLY_MATH_AVX)
+#include <immintrin.h>
+#elif defined(MYLLY_MATH_SSE2)
+#include <emmintrin.h>
+#elif defined(MYLLY_MATH_NEON)
+#include <arm_neon.h>
+#endif
+
+// CPU feature flags returned by math_cpu_features()
+#define MATH_CPU_SSE2		0x01
+#define MATH_CPU_AVX		0x02
+#define MATH_CPU_NEON		0x04
+#define MATH_CPU_F16C		0x08	// Half float conversions, only reported together with AVX
+
+// Loads and stores of a single pointer sized or smaller variable which are safe to race with each
+// other, used for the kernels that are picked on their first call. The variables must be declared
+// volatile, which is what the fallback relies on: every thread works out the same value so only the
+// atomicity of the access matters, and aligned volatile accesses of this size are atomic on the
+// targets MSVC supports.
+#if defined(__GNUC__) || defined(__clang__)
+#define math_atomic_load(ptr)			__atomic_load_n( ptr, __ATOMIC_ACQUIRE )
+#define math_atomic_store(ptr, value)	__atomic_store_n( ptr, value, __ATOMIC_RELEASE )
+#else
+#define math_atomic_load(ptr)			( *(ptr) )
+#define math_atomic_store(ptr, value)	( *(ptr) = (value) )
+#endif
+
+__BEGIN_DECLS
+
+// Can be called from any number of threads at once.
+MYLLY_API uint32		math_cpu_features		( void );
+
+MYLLY_API void*			math_aligned_alloc		( size_t size, size_t alignment );
+MYLLY_API void			math_aligned_free		( void* ptr );
+
+__END_DECLS
+
+// --------------------------------------------------
+// simd4f - four packed floats. Comparisons return a mask with all bits of a lane set when true.
+// --------------------------------------------------
+
+#if defined(MYLLY_MATH_SSE2)
+
+typedef __m128 simd4f;
+
+#define simd4f_load(p)			_mm_load_ps( p )
+#define simd4f_loadu(p)			_mm_loadu_ps( p )
+#define simd4f_store(p, a)		_mm_store_ps( p, a )
+#define simd4f_storeu(p, a)		_mm_storeu_ps( p, a )
+#define simd4f_set1(f)			_mm_set1_ps( f )
+#define simd4f_set(x, y, z, w)	_mm_setr_ps( x, y, z, w )
+#define simd4f_zero()			_mm_setzero_ps()
+
+#define simd4f_add(a, b)		_mm_add_ps( a, b )
+#define simd4f_sub(a, b)		_mm_sub_ps( a, b )
+#define simd4f_mul(a, b)		_mm_mul_ps( a, b )
+#define simd4f_div(a, b)		_mm_div_ps( a, b )
+#define simd4f_min(a, b)		_mm_min_ps( a, b )
+#define simd4f_max(a, b)		_mm_max_ps( a, b )
+#define simd4f_sqrt(a)			_mm_sqrt_ps( a )
+#define simd4f_rsqrt_est(a)		_mm_rsqrt_ps( a )
+
+#define simd4f_cmplt(a, b)		_mm_cmplt_ps( a, b )
+#define simd4f_cmple(a, b)		_mm_cmple_ps( a, b )
+#define simd4f_cmpgt(a, b)		_mm_cmpgt_ps( a, b )
+#define simd4f_cmpge(a, b)		_mm_cmpge_ps( a, b )
+#define simd4f_cmpeq(a, b)		_mm_cmpeq_ps( a, b )
+
+#define simd4f_and(a, b)		_mm_and_ps( a, b )
+#define simd4f_andnot(a, b)		_mm_andnot_ps( b, a )	// a & ~b
+#define simd4f_or(a, b)			_mm_or_ps( a, b )
+#define simd4f_xor(a, b)		_mm_xor_ps( a, b )
+#define simd4f_movemask(a)		( (uint32)_mm_movemask_ps( a ) )
+
+#define simd4f_transpose(r0, r1, r2, r3) _MM_TRANSPOSE4_PS( r0, r1, r2, r3 )
+
+#elif defined(MYLLY_MATH_NEON)
+
+typedef float32x4_t simd4f;
+
+#define simd4f_load(p)			vld1q_f32( p )
+#define simd4f_loadu(p)			vld1q_f32( p )
+#define simd4f_store(p, a)		vst1q_f32( p, a )
+#define simd4f_storeu(p, a)		vst1q_f32( p, a )
+#define simd4f_set1(f)			vdupq_n_f32( f )
+#define simd4f_zero()			vdupq_n_f32( 0.0f )
+
+#define simd4f_add(a, b)		vaddq_f32( a, b )
+#define simd4f_sub(a, b)		vsubq_f32( a, b )
+#define simd4f_mul(a, b)		vmulq_f32( a, b )
+#define simd4f_div(a, b)		vdivq_f32( a, b )
+#define simd4f_min(a, b)		vminq_f32( a, b )
+#define simd4f_max(a, b)		vmaxq_f32( a, b )
+#define simd4f_sqrt(a)			vsqrtq_f32( a )
+#define simd4f_rsqrt_est(a)		vrsqrteq_f32( a )
+
+#define simd4f_cmplt(a, b)		vreinterpretq_f32_u32( vcltq_f32( a, b ) )
+#define simd4f_cmple(a, b)		vreinterpretq_f32_u32( vcleq_f32( a, b ) )
+#define simd4f_cmpgt(a, b)		vreinterpretq_f32_u32( vcgtq_f32( a, b ) )
+#define simd4f_cmpge(a, b)		vreinterpretq_f32_u32( vcgeq_f32( a, b ) )
+#define simd4f_cmpeq(a, b)		vreinterpretq_f32_u32( vceqq_f32( a, b ) )
+
+#define simd4f_and(a, b)		vreinterpretq_f32_u32( vandq_u32( vreinterpretq_u32_f32( a ), vreinterpretq_u32_f32( b ) ) )
+#define simd4f_andnot(a, b)		vreinterpretq_f32_u32( vbicq_u32( vreinterpretq_u32_f32( a ), vreinterpretq_u32_f32( b ) ) )
+#define simd4f_or(a, b)			vreinterpretq_f32_u32( vorrq_u32( vreinterpretq_u32_f32( a ), vreinterpretq_u32_f32( b ) ) )
+#define simd4f_xor(a, b)		vreinterpretq_f32_u32( veorq_u32( vreinterpretq_u32_f32( a ), vreinterpretq_u32_f32( b ) ) )
+
+static MYLLY_INLINE simd4f simd4f_set( float x, float y, float z, float w )
+{
+	float tmp[4];
+	tmp[0] = x; tmp[1] = y; tmp[2] = z; tmp[3] = w;
+	return vld1q_f32( tmp );
+}
+
+static MYLLY_INLINE uint32 simd4f_movemask( simd4f a )
+{
+	static const int32 shift[4] = { 0, 1, 2, 3 };
+	uint32x4_t bits = vshrq_n_u32( vreinterpretq_u32_f32( a ), 31 );
+	return vaddvq_u32( vshlq_u32( bits, vld1q_s32( shift ) ) );
+}
+
+#define simd4f_transpose(r0, r1, r2, r3) \
+{ \
+	float32x4x2_t t01 = vtrnq_f32( r0, r1 ); \
+	float32x4x2_t t23 = vtrnq_f32( r2, r3 ); \
+	r0 = vcombine_f32( vget_low_f32( t01.val[0] ), vget_low_f32( t23.val[0] ) ); \
+	r1 = vcombine_f32( vget_low_f32( t01.val[1] ), vget_low_f32( t23.val[1] ) ); \
+	r2 = vcombine_f32( vget_high_f32( t01.val[0] ), vget_high_f32( t23.val[0] ) ); \
+	r3 = vcombine_f32( vget_high_f32( t01.val[1] ), vget_high_f32( t23.val[1] ) ); \
+}
+
+#else
+
+#include <math.h>
+
+// Plain C fallback, one lane at a time
+typedef union {
+	float f[4];
+	uint32 u[4];
+} simd4f;
+
+#define SIMD4F_OP(a, b, op) \
+	int32 i; simd4f r; \
+	for ( i = 0; i < 4; i++ ) r.f[i] = a.f[i] op b.f[i]; \
+	return r;
+
+#define SIMD4F_CMP(a, b, op) \
+	int32 i; simd4f r; \
+	for ( i = 0; i < 4; i++ ) r.u[i] = a.f[i] op b.f[i] ? 0xFFFFFFFF : 0; \
+	return r;
+
+#define SIMD4F_BITOP(a, b, op) \
+	int32 i; simd4f r; \
+	for ( i = 0; i < 4; i++ ) r.u[i] = a.u[i] op b.u[i]; \
+	return r;
+
+static MYLLY_INLINE simd4f simd4f_set( float x, float y, float z, float w ) { simd4f r; r.f[0] = x; r.f[1] = y; r.f[2] = z; r.f[3] = w; return r; }
+static MYLLY_INLINE simd4f simd4f_set1( float f ) { return simd4f_set( f, f, f, f ); }
+static MYLLY_INLINE simd4f simd4f_zero( void ) { return simd4f_set1( 0.0f ); }
+static MYLLY_INLINE simd4f simd4f_loadu( const float* p ) { return simd4f_set( p[0], p[1], p[2], p[3] ); }
+static MYLLY_INLINE void simd4f_storeu( float* p, simd4f a ) { p[0] = a.f[0]; p[1] = a.f[1]; p[2] = a.f[2]; p[3] = a.f[3]; }
+
+#define simd4f_load(p)			simd4f_loadu( p )
+#define simd4f_store(p, a)		simd4f_storeu( p, a )
+
+static MYLLY_INLINE simd4f simd4f_add( simd4f a, simd4f b ) { SIMD4F_OP( a, b, + ) }
+static MYLLY_INLINE simd4f simd4f_sub( simd4f a, simd4f b ) { SIMD4F_OP( a, b, - ) }
+static MYLLY_INLINE simd4f simd4f_mul( simd4f a, simd4f b ) { SIMD4F_OP( a, b, * ) }
+static MYLLY_INLINE simd4f simd4f_div( simd4f a, simd4f b ) { SIMD4F_OP( a, b, / ) }
+
+static MYLLY_INLINE simd4f simd4f_min( simd4f a, simd4f b ) { int32 i; simd4f r; for ( i = 0; i < 4; i++ ) r.f[i] = a.f[i] < b.f[i] ? a.f[i] : b.f[i]; return r; }
+static MYLLY_INLINE simd4f simd4f_max( simd4f a, simd4f b ) { int32 i; simd4f r; for ( i = 0; i < 4; i++ ) r.f[i] = a.f[i] > b.f[i] ? a.f[i] : b.f[i]; return r; }
+static MYLLY_INLINE simd4f simd4f_sqrt( simd4f a ) { int32 i; simd4f r; for ( i = 0; i < 4; i++ ) r.f[i] = (float)sqrt( a.f[i] ); return r; }
+static MYLLY_INLINE simd4f simd4f_rsqrt_est( simd4f a ) { int32 i; simd4f r; for ( i = 0; i < 4; i++ ) r.f[i] = 1.0f / (float)sqrt( a.f[i] ); return r; }
+
+static MYLLY_INLINE simd4f simd4f_cmplt( simd4f a, simd4f b ) { SIMD4F_CMP( a, b, < ) }
+static MYLLY_INLINE simd4f simd4f_cmple( simd4f a, simd4f b ) { SIMD4F_CMP( a, b, <= ) }
+static MYLLY_INLINE simd4f simd4f_cmpgt( simd4f a, simd4f b ) { SIMD4F_CMP( a, b, > ) }
+static MYLLY_INLINE simd4f simd4f_cmpge( simd4f a, simd4f b ) { SIMD4F_CMP( a, b, >= ) }
+static MYLLY_INLINE simd4f simd4f_cmpeq( simd4f a, simd4f b ) { SIMD4F_CMP( a, b, == ) }
+
+static MYLLY_INLINE simd4f simd4f_and( simd4f a, simd4f b ) { SIMD4F_BITOP( a, b, & ) }
+static MYLLY_INLINE simd4f simd4f_andnot( simd4f a, simd4f b ) { SIMD4F_BITOP( a, b, & ~ ) }
+static MYLLY_INLINE simd4f simd4f_or( simd4f a, simd4f b ) { SIMD4F_BITOP( a, b, | ) }
+static MYLLY_INLINE simd4f simd4f_xor( simd4f a, simd4f b ) { SIMD4F_BITOP( a, b, ^ ) }
+
+static MYLLY_INLINE uint32 simd4f_movemask( simd4f a )
+{
+	return ( a.u[0] >> 31 ) | ( ( a.u[1] >> 31 ) << 1 ) | ( ( a.u[2] >> 31 ) << 2 ) | ( ( a.u[3] >> 31 ) << 3 );
+}
+
+#define simd4f_transpose(r0, r1, r2, r3) \
+{ \
+	float t; \
+	t = r0.f[1]; r0.f[1] = r1.f[0]; r1.f[0] = t; \
+	t = r0.f[2]; r0.f[2] = r2.f[0]; r2.f[0] = t; \
+	t = r0.f[3]; r0.f[3] = r3.f[0]; r3.f[0] = t; \
+	t = r1.f[2]; r1.f[2] = r2.f[1]; r2.f[1] = t; \
+	t = r1.f[3]; r1.f[3] = r3.f[1]; r3.f[1] = t; \
+	t = r2.f[3]; r2.f[3] = r3.f[2]; r3.f[2] = t; \
+}
+
+#endif
+
+// Returns a where mask is set, b elsewhere.
+#define simd4f_select(mask, a, b)	simd4f_or( simd4f_and( mask, a ), simd4f_andnot( b, mask ) )
+
+// Rounds to the nearest integer, ties to even. Same range limit as math_roundf_fast.
+static MYLLY_INLINE simd4f simd4f_round( simd4f a )
+{
+	simd4f magic = simd4f_set1( MATH_ROUND_MAGIC );
+	return simd4f_sub( simd4f_add( a, magic ), magic );
+}
+
+// Truncates four x, y pairs to integers and stores them as interleaved int16s: x0, y0, x1, y1...
+// The values must already be within the int16 range.
+static MYLLY_INLINE void simd4f_store_int16_pairs( int16* result, simd4f x, simd4f y )
+{
+#if defined(MYLLY_MATH_SSE2)
+	__m128i xy = _mm_packs_epi32( _mm_cvttps_epi32( x ), _mm_cvttps_epi32( y ) );
+
+	_mm_storeu_si128( (__m128i*)result, _mm_unpacklo_epi16( xy, _mm_srli_si128( xy, 8 ) ) );
+#elif defined(MYLLY_MATH_NEON)
+	int16x4x2_t xy;
+
+	xy.val[0] = vmovn_s32( vcvtq_s32_f32( x ) );
+	xy.val[1] = vmovn_s32( vcvtq_s32_f32( y ) );
+
+	vst2_s16( result, xy );
+#else
+	uint32 i;
+
+	for ( i = 0; i < 4; i++ )
+	{
+		result[2*i] = (int16)x.f[i];
+		result[2*i+1] = (int16)y.f[i];
+	}
+#endif
+}
+
+// Reciprocal square root estimate refined with Newton-Raphson, y' = y * ( 1.5 - 0.5 * x * y * y ).
+// One step is enough for the 12 bit SSE estimate, the NEON one only has 8 bits and gets two.
+// Returns infinity or NaN for zero, mask those lanes out.
+static MYLLY_INLINE simd4f simd4f_rsqrt( simd4f x )
+{
+	simd4f half_x = simd4f_mul( simd4f_set1( 0.5f ), x );
+	simd4f three_halves = simd4f_set1( 1.5f );
+	simd4f y = simd4f_rsqrt_est( x );
+
+	y = simd4f_mul( y, simd4f_sub( three_halves, simd4f_mul( half_x, simd4f_mul( y, y ) ) ) );
+#if defined(MYLLY_MATH_NEON)
+	y = simd4f_mul( y, simd4f_sub( three_halves, simd4f_mul( half_x, simd4f_mul( y, y ) ) ) );
+#endif
+
+	return y;
+}
+
+#endif /* __MYLLY_MATH_SIMD_H */
@@ -0,0 +1,383 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		MathThreads.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Worker pool for splitting batch operations across threads.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/MathThreads.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef MYLLY_MATH_NO_THREADS
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#endif
+
+#define POOL_MAX_THREADS		64
+#define POOL_CACHE_LINE			64
+#define POOL_TRANSFORM_CHUNK	4096	// Vertices per chunk, large enough to amortise the atomic
+#define POOL_MAX_CHUNKS			0x40000000	// Chunks per job, leaves room for the slice counters to run past the end
+
+// --------------------------------------------------
+// Atomics and threading primitives
+// --------------------------------------------------
+
+#if defined(MYLLY_MATH_NO_THREADS)
+
+#define pool_atomic_fetch_add(ptr, value) ( *(ptr) += (value), *(ptr) - (value) )
+
+#elif defined(_WIN32)
+
+typedef HANDLE				pool_thread_t;
+typedef CRITICAL_SECTION	pool_mutex_t;
+typedef CONDITION_VARIABLE	pool_cond_t;
+
+#define pool_atomic_fetch_add(ptr, value) InterlockedExchangeAdd( (volatile LONG*)(ptr), (LONG)(value) )
+
+#define pool_mutex_init(m)		InitializeCriticalSection( m )
+#define pool_mutex_destroy(m)	DeleteCriticalSection( m )
+#define pool_mutex_lock(m)		EnterCriticalSection( m )
+#define pool_mutex_unlock(m)	LeaveCriticalSection( m )
+#define pool_cond_init(c)		InitializeConditionVariable( c )
+#define pool_cond_destroy(c)	( (void)0 )
+#define pool_cond_wait(c, m)	SleepConditionVariableCS( c, m, INFINITE )
+#define pool_cond_broadcast(c)	WakeAllConditionVariable( c )
+#define pool_cond_signal(c)		WakeConditionVariable( c )
+
+#else
+
+typedef pthread_t			pool_thread_t;
+typedef pthread_mutex_t		pool_mutex_t;
+typedef pthread_cond_t		pool_cond_t;
+
+#define pool_atomic_fetch_add(ptr, value) __sync_fetch_and_add( ptr, value )
+
+#define pool_mutex_init(m)		pthread_mutex_init( m, NULL )
+#define pool_mutex_destroy(m)	pthread_mutex_destroy( m )
+#define pool_mutex_lock(m)		pthread_mutex_lock( m )
+#define pool_mutex_unlock(m)	pthread_mutex_unlock( m )
+#define pool_cond_init(c)		pthread_cond_init( c, NULL )
+#define pool_cond_destroy(c)	pthread_cond_destroy( c )
+#define pool_cond_wait(c, m)	pthread_cond_wait( c, m )
+#define pool_cond_broadcast(c)	pthread_cond_broadcast( c )
+#define pool_cond_signal(c)		pthread_cond_signal( c )
+
+#endif
+
+// --------------------------------------------------
+// Pool
+// --------------------------------------------------
+
+// The chunks owned by one thread. Each is on its own cache line so the owner's counter doesn't
+// bounce between cores until someone starts stealing from it.
+typedef union
+{
+	struct {
+		volatile int32	next;	// Next unclaimed chunk, may run past end
+		int32			end;
+	};
+	uint8 pad[POOL_CACHE_LINE];
+} pool_slice_t;
+
+struct math_pool_s
+{
+	pool_slice_t	slices[POOL_MAX_THREADS];
+	uint32			num_threads;
+
+	// The current job
+	math_task_t		task;
+	void*			context;
+	uint32			count;
+	uint32			chunk_size;
+
+#ifndef MYLLY_MATH_NO_THREADS
+	pool_thread_t	threads[POOL_MAX_THREADS];
+	pool_mutex_t	mutex;
+	pool_cond_t		work_cond;		// Signalled when a new job is posted or the pool is shutting down
+	pool_cond_t		done_cond;		// Signalled when the last worker finishes a job
+	uint32			generation;		// Incremented for every job
+	uint32			busy;			// Number of workers still running the current job
+	bool			quit;
+#endif
+};
+
+static void pool_run_chunks( math_pool_t* pool, uint32 self )
+{
+	pool_slice_t* slice;
+	uint32 i, begin, end;
+	int32 chunk;
+
+	// Drain our own slice first, then go round the others and steal what's left.
+	for ( i = 0; i < pool->num_threads; i++ )
+	{
+		slice = &pool->slices[( self + i ) % pool->num_threads];
+
+		for ( ;; )
+		{
+			chunk = pool_atomic_fetch_add( &slice->next, 1 );
+			if ( chunk >= slice->end ) break;
+
+			// The end of the last chunk may be past the range of uint32.
+			begin = (uint32)chunk * pool->chunk_size;
+			end = (uint64)begin + pool->chunk_size < pool->count ? begin + pool->chunk_size : pool->count;
+
+			pool->task( pool->context, begin, end );
+		}
+	}
+}
+
+#ifndef MYLLY_MATH_NO_THREADS
+
+typedef struct
+{
+	math_pool_t*	pool;
+	uint32			index;
+} pool_worker_t;
+
+static void pool_worker_loop( math_pool_t* pool, uint32 index )
+{
+	uint32 generation = 0;
+
+	for ( ;; )
+	{
+		pool_mutex_lock( &pool->mutex );
+
+		while ( !pool->quit && pool->generation == generation )
+			pool_cond_wait( &pool->work_cond, &pool->mutex );
+
+		if ( pool->quit )
+		{
+			pool_mutex_unlock( &pool->mutex );
+			return;
+		}
+
+		generation = pool->generation;
+		pool_mutex_unlock( &pool->mutex );
+
+		pool_run_chunks( pool, index );
+
+		pool_mutex_lock( &pool->mutex );
+		if ( --pool->busy == 0 ) pool_cond_signal( &pool->done_cond );
+		pool_mutex_unlock( &pool->mutex );
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI pool_worker_main( LPVOID arg )
+#else
+static void* pool_worker_main( void* arg )
+#endif
+{
+	pool_worker_t worker = *(pool_worker_t*)arg;
+
+	free( arg );
+	pool_worker_loop( worker.pool, worker.index );
+
+	return 0;
+}
+
+static bool pool_start_thread( math_pool_t* pool, uint32 index )
+{
+	pool_worker_t* worker = (pool_worker_t*)malloc( sizeof( pool_worker_t ) );
+
+	if ( worker == NULL ) return false;
+
+	worker->pool = pool;
+	worker->index = index;
+
+#ifdef _WIN32
+	pool->threads[index] = CreateThread( NULL, 0, pool_worker_main, worker, 0, NULL );
+	if ( pool->threads[index] != NULL ) return true;
+#else
+	if ( pthread_create( &pool->threads[index], NULL, pool_worker_main, worker ) == 0 ) return true;
+#endif
+
+	free( worker );
+	return false;
+}
+
+static void pool_join_thread( math_pool_t* pool, uint32 index )
+{
+#ifdef _WIN32
+	WaitForSingleObject( pool->threads[index], INFINITE );
+	CloseHandle( pool->threads[index] );
+#else
+	pthread_join( pool->threads[index], NULL );
+#endif
+}
+
+static uint32 pool_num_cpus( void )
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo( &info );
+	return (uint32)info.dwNumberOfProcessors;
+#else
+	long n = sysconf( _SC_NPROCESSORS_ONLN );
+	return n > 0 ? (uint32)n : 1;
+#endif
+}
+
+#endif /* MYLLY_MATH_NO_THREADS */
+
+math_pool_t* math_pool_create( uint32 num_threads )
+{
+	math_pool_t* pool;
+	uint32 i;
+
+	pool = (math_pool_t*)calloc( 1, sizeof( math_pool_t ) );
+	if ( pool == NULL ) return NULL;
+
+#ifdef MYLLY_MATH_NO_THREADS
+	(void)num_threads; (void)i;
+	pool->num_threads = 1;
+#else
+	if ( num_threads == 0 ) num_threads = pool_num_cpus();
+	if ( num_threads > POOL_MAX_THREADS ) num_threads = POOL_MAX_THREADS;
+
+	pool_mutex_init( &pool->mutex );
+	pool_cond_init( &pool->work_cond );
+	pool_cond_init( &pool->done_cond );
+
+	// Thread 0 is the caller of math_pool_run. If a thread fails to start just use fewer.
+	pool->num_threads = 1;
+
+	for ( i = 1; i < num_threads; i++ )
+	{
+		if ( !pool_start_thread( pool, i ) ) break;
+		pool->num_threads++;
+	}
+#endif
+
+	return pool;
+}
+
+void math_pool_destroy( math_pool_t* pool )
+{
+	uint32 i;
+
+	if ( pool == NULL ) return;
+
+#ifndef MYLLY_MATH_NO_THREADS
+	pool_mutex_lock( &pool->mutex );
+	pool->quit = true;
+	pool_cond_broadcast( &pool->work_cond );
+	pool_mutex_unlock( &pool->mutex );
+
+	for ( i = 1; i < pool->num_threads; i++ )
+		pool_join_thread( pool, i );
+
+	pool_cond_destroy( &pool->done_cond );
+	pool_cond_destroy( &pool->work_cond );
+	pool_mutex_destroy( &pool->mutex );
+#else
+	(void)i;
+#endif
+
+	free( pool );
+}
+
+uint32 math_pool_num_threads( const math_pool_t* pool )
+{
+	return pool != NULL ? pool->num_threads : 1;
+}
+
+void math_pool_run( math_pool_t* pool, uint32 count, uint32 chunk_size, math_task_t task, void* context )
+{
+	uint32 i, num_chunks, num_threads;
+
+	if ( task == NULL || count == 0 ) return;
+	if ( chunk_size == 0 ) chunk_size = 1;
+
+	num_chunks = ( count - 1 ) / chunk_size + 1;
+
+	// Use larger chunks if there would be too many to count with the int32 slice counters.
+	if ( num_chunks > POOL_MAX_CHUNKS )
+	{
+		chunk_size = ( count - 1 ) / POOL_MAX_CHUNKS + 1;
+		num_chunks = ( count - 1 ) / chunk_size + 1;
+	}
+
+	// Not worth waking anyone up for a single chunk.
+	if ( pool == NULL || pool->num_threads == 1 || num_chunks == 1 )
+	{
+		task( context, 0, count );
+		return;
+	}
+
+	num_threads = pool->num_threads;
+
+	pool->task = task;
+	pool->context = context;
+	pool->count = count;
+	pool->chunk_size = chunk_size;
+
+	for ( i = 0; i < num_threads; i++ )
+	{
+		pool->slices[i].next = (int32)( (uint64)num_chunks * i / num_threads );
+		pool->slices[i].end = (int32)( (uint64)num_chunks * ( i + 1 ) / num_threads );
+	}
+
+#ifndef MYLLY_MATH_NO_THREADS
+	pool_mutex_lock( &pool->mutex );
+	pool->busy = num_threads - 1;
+	pool->generation++;
+	pool_cond_broadcast( &pool->work_cond );
+	pool_mutex_unlock( &pool->mutex );
+
+	pool_run_chunks( pool, 0 );
+
+	pool_mutex_lock( &pool->mutex );
+	while ( pool->busy != 0 )
+		pool_cond_wait( &pool->done_cond, &pool->mutex );
+	pool_mutex_unlock( &pool->mutex );
+#else
+	pool_run_chunks( pool, 0 );
+#endif
+}
+
+// --------------------------------------------------
+// Parallel kernels
+// --------------------------------------------------
+
+typedef struct
+{
+	vector3_t*			result;
+	const vector3_t*	points;
+	uint32				stride;
+	const matrix4_t*	mat;
+} pool_transform_t;
+
+static void pool_transform_task( void* context, uint32 begin, uint32 end )
+{
+	pool_transform_t* job = (pool_transform_t*)context;
+	size_t offset = (size_t)begin * job->stride;
+
+	vector3_transform_coord_array( (vector3_t*)( (uint8*)job->result + offset ),
+								   (const vector3_t*)( (const uint8*)job->points + offset ),
+								   end - begin, job->stride, job->mat );
+}
+
+void math_pool_transform_coord_array( math_pool_t* pool, vector3_t* result, const vector3_t* points, uint32 count, uint32 stride, const matrix4_t* mat )
+{
+	pool_transform_t job;
+
+	if ( result == NULL || points == NULL || mat == NULL ) return;
+
+	job.result = result;
+	job.points = points;
+	job.stride = stride ? stride : sizeof( vector3_t );
+	job.mat = mat;
+
+	math_pool_run( pool, count, POOL_TRANSFORM_CHUNK, pool_transform_task, &job );
+}
@@ -0,0 +1,49 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		MathThreads.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Worker pool for splitting batch operations across threads.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_MATH_THREADS_H
+#define __MYLLY_MATH_THREADS_H
+
+#include "stdtypes.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+
+// Define MYLLY_MATH_NO_THREADS to build the pool without thread support. Everything then runs on
+// the calling thread.
+
+// Processes the items [begin, end).
+typedef void ( *math_task_t )( void* context, uint32 begin, uint32 end );
+
+typedef struct math_pool_s math_pool_t;
+
+__BEGIN_DECLS
+
+// Creates a pool using num_threads threads in total, including the calling thread. Passing 0 uses
+// one thread per CPU core.
+MYLLY_API math_pool_t*	math_pool_create				( uint32 num_threads );
+MYLLY_API void			math_pool_destroy				( math_pool_t* pool );
+MYLLY_API uint32		math_pool_num_threads			( const math_pool_t* pool );
+
+// Runs task over [0, count) split into chunks of chunk_size items and returns once every chunk is
+// done. The chunks are divided evenly between the threads up front, a thread which runs out of
+// work steals chunks from the others. Every item is processed exactly once, so as long as the
+// task writes each item independently the result doesn't depend on the number of threads.
+// Larger chunks are used if there would be more than 2^30 of them.
+// Only one thread may run tasks on a pool at a time. pool may be NULL to run on the calling thread.
+MYLLY_API void			math_pool_run					( math_pool_t* pool, uint32 count, uint32 chunk_size, math_task_t task, void* context );
+
+// Parallel version of vector3_transform_coord_array.
+MYLLY_API void			math_pool_transform_coord_array	( math_pool_t* pool, vector3_t* result, const vector3_t* points, uint32 count, uint32 stride, const matrix4_t* mat );
+
+__END_DECLS
+
+#endif /* __MYLLY_MATH_THREADS_H */
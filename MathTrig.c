@@ -0,0 +1,88 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		MathTrig.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Fast sine and cosine approximations.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/MathTrig.h"
+#include "Math/MathSimd.h"
+
+// Four lane version of math_sincos_fast. There are no integer vectors in the simd4f wrappers so the
+// quadrant logic is done on the rounded quotient as floats, which is exact for these magnitudes.
+static MYLLY_INLINE void math_sincos4( simd4f rad, simd4f* s, simd4f* c )
+{
+	simd4f quarter = simd4f_set1( 0.25f );
+	simd4f half = simd4f_set1( 0.5f );
+	simd4f sign = simd4f_set1( -0.0f );
+	simd4f q, r, r2, ps, pc, k, odd, neg_s, neg_c;
+
+	q = simd4f_round( simd4f_mul( rad, simd4f_set1( MATH_TRIG_2_OVER_PI ) ) );
+
+	r = simd4f_sub( rad, simd4f_mul( q, simd4f_set1( MATH_TRIG_PI_2_HI ) ) );
+	r = simd4f_sub( r, simd4f_mul( q, simd4f_set1( MATH_TRIG_PI_2_MID ) ) );
+	r = simd4f_sub( r, simd4f_mul( q, simd4f_set1( MATH_TRIG_PI_2_LO ) ) );
+	r2 = simd4f_mul( r, r );
+
+	ps = simd4f_add( simd4f_set1( MATH_TRIG_SIN2 ), simd4f_mul( r2, simd4f_set1( MATH_TRIG_SIN3 ) ) );
+	ps = simd4f_add( simd4f_set1( MATH_TRIG_SIN1 ), simd4f_mul( r2, ps ) );
+	ps = simd4f_add( r, simd4f_mul( simd4f_mul( r, r2 ), ps ) );
+
+	pc = simd4f_add( simd4f_set1( MATH_TRIG_COS2 ), simd4f_mul( r2, simd4f_set1( MATH_TRIG_COS3 ) ) );
+	pc = simd4f_add( simd4f_set1( MATH_TRIG_COS1 ), simd4f_mul( r2, pc ) );
+	pc = simd4f_add( simd4f_sub( simd4f_set1( 1.0f ), simd4f_mul( half, r2 ) ), simd4f_mul( simd4f_mul( r2, r2 ), pc ) );
+
+	// Fraction of q/4 tells the quadrant: 0, 0.25, 0.5 or 0.75. floor(q/4) = round(q/4 - 0.375).
+	k = simd4f_mul( q, quarter );
+	k = simd4f_sub( k, simd4f_round( simd4f_sub( k, simd4f_set1( 0.375f ) ) ) );
+
+	odd = simd4f_or( simd4f_cmpeq( k, quarter ), simd4f_cmpeq( k, simd4f_set1( 0.75f ) ) );
+	neg_s = simd4f_cmpge( k, half );
+	neg_c = simd4f_and( simd4f_cmpge( k, quarter ), simd4f_cmple( k, half ) );
+
+	*s = simd4f_or( simd4f_and( odd, pc ), simd4f_andnot( ps, odd ) );
+	*c = simd4f_or( simd4f_and( odd, ps ), simd4f_andnot( pc, odd ) );
+
+	*s = simd4f_xor( *s, simd4f_and( neg_s, sign ) );
+	*c = simd4f_xor( *c, simd4f_and( neg_c, sign ) );
+}
+
+void math_sincos_array( float* sin_result, float* cos_result, const float* angles, uint32 count )
+{
+	simd4f s, c;
+	uint32 i = 0;
+
+	if ( angles == NULL ) return;
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		math_sincos4( simd4f_loadu( &angles[i] ), &s, &c );
+
+		if ( sin_result != NULL ) simd4f_storeu( &sin_result[i], s );
+		if ( cos_result != NULL ) simd4f_storeu( &cos_result[i], c );
+	}
+
+	for ( ; i < count; i++ )
+	{
+		float fs, fc;
+
+		math_sincos_fast( angles[i], &fs, &fc );
+
+		if ( sin_result != NULL ) sin_result[i] = fs;
+		if ( cos_result != NULL ) cos_result[i] = fc;
+	}
+}
+
+void math_sin_array( float* result, const float* angles, uint32 count )
+{
+	math_sincos_array( result, NULL, angles, count );
+}
+
+void math_cos_array( float* result, const float* angles, uint32 count )
+{
+	math_sincos_array( NULL, result, angles, count );
+}
@@ -0,0 +1,81 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		MathTrig.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Fast sine and cosine approximations.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_MATH_TRIG_H
+#define __MYLLY_MATH_TRIG_H
+
+#include "stdtypes.h"
+#include "Math/MathUtils.h"
+#include <math.h>
+
+// The approximation reduces the angle to [-pi/4, pi/4] around the nearest multiple of pi/2 and
+// evaluates minimax polynomials for sine and cosine there. The absolute error is below 1e-7 for
+// |rad| < 8192 and grows with the size of the angle beyond that (1e-6 at 1e5), it isn't meant for
+// angles past 2^20.
+#define MATH_TRIG_2_OVER_PI		0.636619772367581343f
+#define MATH_TRIG_PI_2_HI		1.5703125f					// pi/2 split into three parts so that
+#define MATH_TRIG_PI_2_MID		4.837512969970703125e-4f	// q * part is exact for the first two
+#define MATH_TRIG_PI_2_LO		7.54978995489188216e-8f
+
+#define MATH_TRIG_SIN1			-1.6666654611e-1f
+#define MATH_TRIG_SIN2			8.3321608736e-3f
+#define MATH_TRIG_SIN3			-1.9515295891e-4f
+#define MATH_TRIG_COS1			4.166664568298827e-2f
+#define MATH_TRIG_COS2			-1.388731625493765e-3f
+#define MATH_TRIG_COS3			2.443315711809948e-5f
+
+__BEGIN_DECLS
+
+// Sine and cosine of count angles using the approximation above, four at a time with SIMD.
+// The results are identical to math_sincos_fast. sin_result or cos_result can be NULL.
+MYLLY_API void			math_sincos_array		( float* sin_result, float* cos_result, const float* angles, uint32 count );
+MYLLY_API void			math_sin_array			( float* result, const float* angles, uint32 count );
+MYLLY_API void			math_cos_array			( float* result, const float* angles, uint32 count );
+
+__END_DECLS
+
+// Polynomial sine and cosine of the same angle.
+static MYLLY_INLINE void math_sincos_fast( float rad, float* s, float* c )
+{
+	float q, r, r2, ps, pc;
+	uint32 quadrant;
+
+	q = math_roundf_fast( rad * MATH_TRIG_2_OVER_PI );
+	quadrant = (uint32)(int32)q;
+
+	r = ( ( rad - q * MATH_TRIG_PI_2_HI ) - q * MATH_TRIG_PI_2_MID ) - q * MATH_TRIG_PI_2_LO;
+	r2 = r * r;
+
+	ps = r + r * r2 * ( MATH_TRIG_SIN1 + r2 * ( MATH_TRIG_SIN2 + r2 * MATH_TRIG_SIN3 ) );
+	pc = 1.0f - 0.5f * r2 + r2 * r2 * ( MATH_TRIG_COS1 + r2 * ( MATH_TRIG_COS2 + r2 * MATH_TRIG_COS3 ) );
+
+	// sin(r + q*pi/2) cycles through sin(r), cos(r), -sin(r), -cos(r)
+	*s = ( quadrant & 1 ) ? pc : ps;
+	*c = ( quadrant & 1 ) ? ps : pc;
+
+	if ( quadrant & 2 ) *s = -*s;
+	if ( ( quadrant + 1 ) & 2 ) *c = -*c;
+}
+
+// Sine and cosine of the same angle. Uses the C library unless MYLLY_MATH_FAST_TRIG is defined, in
+// which case the polynomial approximation is used instead.
+static MYLLY_INLINE void math_sincos( float rad, float* s, float* c )
+{
+#ifdef MYLLY_MATH_FAST_TRIG
+	math_sincos_fast( rad, s, c );
+#else
+	*s = sinf( rad );
+	*c = cosf( rad );
+#endif
+}
+
+#endif /* __MYLLY_MATH_TRIG_H */
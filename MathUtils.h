@@ -31,4 +31,13 @@ static MYLLY_INLINE float math_clampf( float value, float lower, float upper )
 	return value < lower ? lower : value;
 }
 
+// Adding and subtracting 1.5 * 2^23 rounds a float to the nearest integer, ties to even, as long as
+// its magnitude is below 2^22. simd4f_round in MathSimd.h does the same for four floats.
+#define MATH_ROUND_MAGIC	12582912.0f
+
+static MYLLY_INLINE float math_roundf_fast( float value )
+{
+	return ( value + MATH_ROUND_MAGIC ) - MATH_ROUND_MAGIC;
+}
+
 #endif /* __MYLLY_MATH_UTILS_H */
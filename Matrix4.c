@@ -11,9 +11,10 @@
 
 #include "Math/Matrix4.h"
 #include "Math/MathUtils.h"
+#include "Math/MathSimd.h"
+#include "Math/MathTrig.h"
 #include <math.h>
 
-#define SM (8 / sizeof(float))
 #define MATRIX4_EPSILON 0.0001f
 
 void matrix4_add( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 )
@@ -42,42 +43,129 @@ void matrix4_subtract( matrix4_t* result, const matrix4_t* mat1, const matrix4_t
 	}
 }
 
+// Scalar version, used when the CPU has no supported vector unit. The product is computed into a
+// temporary so result may point to either of the inputs.
+static void matrix4_multiply_c( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 )
+{
+	matrix4_t tmp;
+
+	tmp._11 = mat1->_11*mat2->_11 + mat1->_12*mat2->_21 + mat1->_13*mat2->_31 + mat1->_14*mat2->_41;
+	tmp._12 = mat1->_11*mat2->_12 + mat1->_12*mat2->_22 + mat1->_13*mat2->_32 + mat1->_14*mat2->_42;
+	tmp._13 = mat1->_11*mat2->_13 + mat1->_12*mat2->_23 + mat1->_13*mat2->_33 + mat1->_14*mat2->_43;
+	tmp._14 = mat1->_11*mat2->_14 + mat1->_12*mat2->_24 + mat1->_13*mat2->_34 + mat1->_14*mat2->_44;
+
+	tmp._21 = mat1->_21*mat2->_11 + mat1->_22*mat2->_21 + mat1->_23*mat2->_31 + mat1->_24*mat2->_41;
+	tmp._22 = mat1->_21*mat2->_12 + mat1->_22*mat2->_22 + mat1->_23*mat2->_32 + mat1->_24*mat2->_42;
+	tmp._23 = mat1->_21*mat2->_13 + mat1->_22*mat2->_23 + mat1->_23*mat2->_33 + mat1->_24*mat2->_43;
+	tmp._24 = mat1->_21*mat2->_14 + mat1->_22*mat2->_24 + mat1->_23*mat2->_34 + mat1->_24*mat2->_44;
+
+	tmp._31 = mat1->_31*mat2->_11 + mat1->_32*mat2->_21 + mat1->_33*mat2->_31 + mat1->_34*mat2->_41;
+	tmp._32 = mat1->_31*mat2->_12 + mat1->_32*mat2->_22 + mat1->_33*mat2->_32 + mat1->_34*mat2->_42;
+	tmp._33 = mat1->_31*mat2->_13 + mat1->_32*mat2->_23 + mat1->_33*mat2->_33 + mat1->_34*mat2->_43;
+	tmp._34 = mat1->_31*mat2->_14 + mat1->_32*mat2->_24 + mat1->_33*mat2->_34 + mat1->_34*mat2->_44;
+
+	tmp._41 = mat1->_41*mat2->_11 + mat1->_42*mat2->_21 + mat1->_43*mat2->_31 + mat1->_44*mat2->_41;
+	tmp._42 = mat1->_41*mat2->_12 + mat1->_42*mat2->_22 + mat1->_43*mat2->_32 + mat1->_44*mat2->_42;
+	tmp._43 = mat1->_41*mat2->_13 + mat1->_42*mat2->_23 + mat1->_43*mat2->_33 + mat1->_44*mat2->_43;
+	tmp._44 = mat1->_41*mat2->_14 + mat1->_42*mat2->_24 + mat1->_43*mat2->_34 + mat1->_44*mat2->_44;
+
+	*result = tmp;
+}
+
+#if defined(MYLLY_MATH_SSE2) || defined(MYLLY_MATH_NEON)
+
+// Each result row is a linear combination of the rows of mat2. The products are summed in the same
+// order as in the scalar version so both give identical results. All rows are computed before
+// anything is stored, so result may point to either of the inputs.
+static void matrix4_multiply_simd( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 )
+{
+	simd4f row0, row1, row2, row3, r[4];
+	int32 i;
+
+	row0 = simd4f_loadu( mat2->m[0] );
+	row1 = simd4f_loadu( mat2->m[1] );
+	row2 = simd4f_loadu( mat2->m[2] );
+	row3 = simd4f_loadu( mat2->m[3] );
+
+	for ( i = 0; i < 4; i++ )
+	{
+		r[i] = simd4f_mul( simd4f_set1( mat1->m[i][0] ), row0 );
+		r[i] = simd4f_add( r[i], simd4f_mul( simd4f_set1( mat1->m[i][1] ), row1 ) );
+		r[i] = simd4f_add( r[i], simd4f_mul( simd4f_set1( mat1->m[i][2] ), row2 ) );
+		r[i] = simd4f_add( r[i], simd4f_mul( simd4f_set1( mat1->m[i][3] ), row3 ) );
+	}
+
+	for ( i = 0; i < 4; i++ )
+		simd4f_storeu( result->m[i], r[i] );
+}
+
+#endif
+
+#ifdef MYLLY_MATH_AVX
+
+// Same as above but two result rows at a time, one per 128-bit lane.
+MATH_TARGET_AVX static void matrix4_multiply_avx( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 )
+{
+	__m256 row0, row1, row2, row3, a01, a23, r01, r23;
+	__m128 tmp;
+
+	tmp = _mm_loadu_ps( mat2->m[0] ); row0 = _mm256_insertf128_ps( _mm256_castps128_ps256( tmp ), tmp, 1 );
+	tmp = _mm_loadu_ps( mat2->m[1] ); row1 = _mm256_insertf128_ps( _mm256_castps128_ps256( tmp ), tmp, 1 );
+	tmp = _mm_loadu_ps( mat2->m[2] ); row2 = _mm256_insertf128_ps( _mm256_castps128_ps256( tmp ), tmp, 1 );
+	tmp = _mm_loadu_ps( mat2->m[3] ); row3 = _mm256_insertf128_ps( _mm256_castps128_ps256( tmp ), tmp, 1 );
+
+	a01 = _mm256_loadu_ps( mat1->m[0] );
+	a23 = _mm256_loadu_ps( mat1->m[2] );
+
+	r01 = _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, _MM_SHUFFLE( 0, 0, 0, 0 ) ), row0 );
+	r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, _MM_SHUFFLE( 1, 1, 1, 1 ) ), row1 ) );
+	r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, _MM_SHUFFLE( 2, 2, 2, 2 ) ), row2 ) );
+	r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, _MM_SHUFFLE( 3, 3, 3, 3 ) ), row3 ) );
+
+	r23 = _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, _MM_SHUFFLE( 0, 0, 0, 0 ) ), row0 );
+	r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, _MM_SHUFFLE( 1, 1, 1, 1 ) ), row1 ) );
+	r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, _MM_SHUFFLE( 2, 2, 2, 2 ) ), row2 ) );
+	r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, _MM_SHUFFLE( 3, 3, 3, 3 ) ), row3 ) );
+
+	_mm256_storeu_ps( result->m[0], r01 );
+	_mm256_storeu_ps( result->m[2], r23 );
+}
+
+#endif
+
+typedef void ( *matrix4_multiply_func_t )( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 );
+
+static void matrix4_multiply_select( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 );
+static matrix4_multiply_func_t volatile matrix4_multiply_impl = matrix4_multiply_select;
+
+// Picks the best kernel for this CPU on the first call and replaces itself with it. Threads making
+// their first call at the same time all pick the same kernel, the pointer is swapped atomically.
+static void matrix4_multiply_select( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 )
+{
+	uint32 features = math_cpu_features();
+	matrix4_multiply_func_t func = matrix4_multiply_c;
+
+#if defined(MYLLY_MATH_SSE2) || defined(MYLLY_MATH_NEON)
+	if ( features & ( MATH_CPU_SSE2 | MATH_CPU_NEON ) ) func = matrix4_multiply_simd;
+#endif
+#ifdef MYLLY_MATH_AVX
+	if ( features & MATH_CPU_AVX ) func = matrix4_multiply_avx;
+#endif
+
+	(void)features;
+
+	math_atomic_store( &matrix4_multiply_impl, func );
+	func( result, mat1, mat2 );
+}
+
 void matrix4_multiply( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 )
 {
+	matrix4_multiply_func_t func;
+
 	if ( result == NULL || mat1 == NULL || mat2 == NULL ) return;
 
-	result->_11 = mat1->_11*mat2->_11 + mat1->_12*mat2->_21 + mat1->_13*mat2->_31 + mat1->_14*mat2->_41;
-	result->_12 = mat1->_11*mat2->_12 + mat1->_12*mat2->_22 + mat1->_13*mat2->_32 + mat1->_14*mat2->_42;
-	result->_13 = mat1->_11*mat2->_13 + mat1->_12*mat2->_23 + mat1->_13*mat2->_33 + mat1->_14*mat2->_43;
-	result->_14 = mat1->_11*mat2->_14 + mat1->_12*mat2->_24 + mat1->_13*mat2->_34 + mat1->_14*mat2->_44;
-
-	result->_21 = mat1->_21*mat2->_11 + mat1->_22*mat2->_21 + mat1->_23*mat2->_31 + mat1->_24*mat2->_41;
-	result->_22 = mat1->_21*mat2->_12 + mat1->_22*mat2->_22 + mat1->_23*mat2->_32 + mat1->_24*mat2->_42;
-	result->_23 = mat1->_21*mat2->_13 + mat1->_22*mat2->_23 + mat1->_23*mat2->_33 + mat1->_24*mat2->_43;
-	result->_24 = mat1->_21*mat2->_14 + mat1->_22*mat2->_24 + mat1->_23*mat2->_34 + mat1->_24*mat2->_44;
-
-	result->_31 = mat1->_31*mat2->_11 + mat1->_32*mat2->_21 + mat1->_33*mat2->_31 + mat1->_34*mat2->_41;
-	result->_32 = mat1->_31*mat2->_12 + mat1->_32*mat2->_22 + mat1->_33*mat2->_32 + mat1->_34*mat2->_42;
-	result->_33 = mat1->_31*mat2->_13 + mat1->_32*mat2->_23 + mat1->_33*mat2->_33 + mat1->_34*mat2->_43;
-	result->_34 = mat1->_31*mat2->_14 + mat1->_32*mat2->_24 + mat1->_33*mat2->_34 + mat1->_34*mat2->_44;
-
-	result->_41 = mat1->_41*mat2->_11 + mat1->_42*mat2->_21 + mat1->_43*mat2->_31 + mat1->_44*mat2->_41;
-	result->_42 = mat1->_41*mat2->_12 + mat1->_42*mat2->_22 + mat1->_43*mat2->_32 + mat1->_44*mat2->_42;
-	result->_43 = mat1->_41*mat2->_13 + mat1->_42*mat2->_23 + mat1->_43*mat2->_33 + mat1->_44*mat2->_43;
-	result->_44 = mat1->_41*mat2->_14 + mat1->_42*mat2->_24 + mat1->_43*mat2->_34 + mat1->_44*mat2->_44;
-
-	/*// An optimised version found on http://www.akkadia.org/drepper/cpumemory.pdf page 50.
-
-	uint32 i, j, k, i2, j2, k2;
-	float *pres, *pmat1, *pmat2;
-
-	for ( i = 0; i < 4; i += SM )
-		for ( j = 0; j < 4; j += SM )
-			for ( k = 0; k < 4; k += SM )
-				for ( i2 = 0, pres = (float*)&result->m[i][j], pmat1 = (float*)&mat1->m[i][k]; i2 < SM; ++i2, pres += 4, pmat1 += 4 )
-					for ( k2 = 0, pmat2 = (float*)&mat2->m[k][j]; k2 < SM; ++k2, pmat2 += 4 )
-						for ( j2 = 0; j2 < SM; ++j2 )
-							pres[j2] += pmat1[k2] * pmat2[j2];*/
+	func = math_atomic_load( &matrix4_multiply_impl );
+	func( result, mat1, mat2 );
 }
 
 void matrix4_add_scalar( matrix4_t* result, const matrix4_t* mat, float f )
@@ -279,8 +367,7 @@ void matrix4_rotation_x( matrix4_t* mat, float rad )
 
 	mat->_11 = mat->_44 = 1.0f;
 
-	fsin = sinf( rad );
-	fcos = cosf( rad );
+	math_sincos( rad, &fsin, &fcos );
 
 	mat->_22 = fcos; mat->_23 = fsin;
 	mat->_32 = -fsin; mat->_33 = fcos;
@@ -299,8 +386,7 @@ void matrix4_rotation_y( matrix4_t* mat, float rad )
 
 	mat->_22 = mat->_44 = 1.0f;
 
-	fsin = sinf( rad );
-	fcos = cosf( rad );
+	math_sincos( rad, &fsin, &fcos );
 
 	mat->_11 = fcos; mat->_13 = -fsin;
 	mat->_31 = fsin; mat->_33 = fcos;
@@ -319,11 +405,10 @@ void matrix4_rotation_z( matrix4_t* mat, float rad )
 
 	mat->_33 = mat->_44 = 1.0f;
 
-	fsin = sinf( rad );
-	fcos = cosf( rad );
+	math_sincos( rad, &fsin, &fcos );
 
 	mat->_11 = fcos; mat->_12 = fsin;
-	mat->_21 = -fsin; mat->_33 = fcos;
+	mat->_21 = -fsin; mat->_22 = fcos;
 }
 
 void matrix4_scale( matrix4_t* mat, float x_scale, float y_scale, float z_scale )
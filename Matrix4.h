@@ -70,6 +70,7 @@ typedef matrix4_t Matrix4;
 
 __BEGIN_DECLS
 
+// result may point to either of the input matrices.
 void		matrix4_add				( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 );
 void		matrix4_subtract		( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 );
 void		matrix4_multiply		( matrix4_t* result, const matrix4_t* mat1, const matrix4_t* mat2 );
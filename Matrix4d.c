@@ -0,0 +1,295 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Matrix4d.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		A double precision 4x4 matrix for large world coordinates.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/Matrix4d.h"
+#include <math.h>
+
+#define MATRIX4D_EPSILON 1.0e-12
+
+void matrix4d_add( matrix4d_t* result, const matrix4d_t* mat1, const matrix4d_t* mat2 )
+{
+	int32 i;
+
+	for ( i = 0; i < 16; i++ )
+		result->mat[i] = mat1->mat[i] + mat2->mat[i];
+}
+
+void matrix4d_subtract( matrix4d_t* result, const matrix4d_t* mat1, const matrix4d_t* mat2 )
+{
+	int32 i;
+
+	for ( i = 0; i < 16; i++ )
+		result->mat[i] = mat1->mat[i] - mat2->mat[i];
+}
+
+// The rows are computed into a temporary so result may point to either of the inputs.
+void matrix4d_multiply( matrix4d_t* result, const matrix4d_t* mat1, const matrix4d_t* mat2 )
+{
+	matrix4d_t tmp;
+	int32 i;
+
+	for ( i = 0; i < 4; i++ )
+	{
+		tmp.m[i][0] = mat1->m[i][0]*mat2->_11 + mat1->m[i][1]*mat2->_21 + mat1->m[i][2]*mat2->_31 + mat1->m[i][3]*mat2->_41;
+		tmp.m[i][1] = mat1->m[i][0]*mat2->_12 + mat1->m[i][1]*mat2->_22 + mat1->m[i][2]*mat2->_32 + mat1->m[i][3]*mat2->_42;
+		tmp.m[i][2] = mat1->m[i][0]*mat2->_13 + mat1->m[i][1]*mat2->_23 + mat1->m[i][2]*mat2->_33 + mat1->m[i][3]*mat2->_43;
+		tmp.m[i][3] = mat1->m[i][0]*mat2->_14 + mat1->m[i][1]*mat2->_24 + mat1->m[i][2]*mat2->_34 + mat1->m[i][3]*mat2->_44;
+	}
+
+	*result = tmp;
+}
+
+void matrix4d_add_scalar( matrix4d_t* result, const matrix4d_t* mat, double f )
+{
+	int32 i;
+
+	for ( i = 0; i < 16; i++ )
+		result->mat[i] = mat->mat[i] + f;
+}
+
+void matrix4d_subtract_scalar( matrix4d_t* result, const matrix4d_t* mat, double f )
+{
+	int32 i;
+
+	for ( i = 0; i < 16; i++ )
+		result->mat[i] = mat->mat[i] - f;
+}
+
+void matrix4d_multiply_scalar( matrix4d_t* result, const matrix4d_t* mat, double f )
+{
+	int32 i;
+
+	for ( i = 0; i < 16; i++ )
+		result->mat[i] = mat->mat[i] * f;
+}
+
+void matrix4d_divide_scalar( matrix4d_t* result, const matrix4d_t* mat, double f )
+{
+	int32 i;
+
+	if ( f < MATRIX4D_EPSILON ) return;
+
+	for ( i = 0; i < 16; i++ )
+		result->mat[i] = mat->mat[i] / f;
+}
+
+void matrix4d_identity( matrix4d_t* mat )
+{
+	mat->_12 = mat->_13 = mat->_14 =
+	mat->_21 = mat->_23 = mat->_24 =
+	mat->_31 = mat->_32 = mat->_34 =
+	mat->_41 = mat->_42 = mat->_43 = 0.0;
+
+	mat->_11 = mat->_22 = mat->_33 = mat->_44 = 1.0;
+}
+
+void matrix4d_transpose( matrix4d_t* result, const matrix4d_t* mat )
+{
+	int32 i, j;
+	double tmp;
+
+	for ( i = 0; i < 4; i++ )
+	{
+		for ( j = i; j < 4; j++ )
+		{
+			tmp = mat->m[i][j];
+			result->m[i][j] = mat->m[j][i];
+			result->m[j][i] = tmp;
+		}
+	}
+}
+
+// Cofactor expansion using the 2x2 minors of the top two and the bottom two rows. Returns the
+// determinant, the result is left untouched when it is zero.
+double matrix4d_inverse( matrix4d_t* result, const matrix4d_t* mat )
+{
+	double s[6], c[6], det, inv;
+	const double (*a)[4];
+	matrix4d_t tmp;
+
+	if ( result == NULL || mat == NULL ) return 0;
+
+	a = mat->m;
+
+	s[0] = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+	s[1] = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+	s[2] = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+	s[3] = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+	s[4] = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+	s[5] = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+	c[0] = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+	c[1] = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+	c[2] = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+	c[3] = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+	c[4] = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+	c[5] = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+
+	det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+
+	// This matrix can't be inverted
+	if ( det == 0.0 ) return det;
+
+	inv = 1.0 / det;
+
+	tmp._11 = (  a[1][1] * c[5] - a[1][2] * c[4] + a[1][3] * c[3] ) * inv;
+	tmp._12 = ( -a[0][1] * c[5] + a[0][2] * c[4] - a[0][3] * c[3] ) * inv;
+	tmp._13 = (  a[3][1] * s[5] - a[3][2] * s[4] + a[3][3] * s[3] ) * inv;
+	tmp._14 = ( -a[2][1] * s[5] + a[2][2] * s[4] - a[2][3] * s[3] ) * inv;
+
+	tmp._21 = ( -a[1][0] * c[5] + a[1][2] * c[2] - a[1][3] * c[1] ) * inv;
+	tmp._22 = (  a[0][0] * c[5] - a[0][2] * c[2] + a[0][3] * c[1] ) * inv;
+	tmp._23 = ( -a[3][0] * s[5] + a[3][2] * s[2] - a[3][3] * s[1] ) * inv;
+	tmp._24 = (  a[2][0] * s[5] - a[2][2] * s[2] + a[2][3] * s[1] ) * inv;
+
+	tmp._31 = (  a[1][0] * c[4] - a[1][1] * c[2] + a[1][3] * c[0] ) * inv;
+	tmp._32 = ( -a[0][0] * c[4] + a[0][1] * c[2] - a[0][3] * c[0] ) * inv;
+	tmp._33 = (  a[3][0] * s[4] - a[3][1] * s[2] + a[3][3] * s[0] ) * inv;
+	tmp._34 = ( -a[2][0] * s[4] + a[2][1] * s[2] - a[2][3] * s[0] ) * inv;
+
+	tmp._41 = ( -a[1][0] * c[3] + a[1][1] * c[1] - a[1][2] * c[0] ) * inv;
+	tmp._42 = (  a[0][0] * c[3] - a[0][1] * c[1] + a[0][2] * c[0] ) * inv;
+	tmp._43 = ( -a[3][0] * s[3] + a[3][1] * s[1] - a[3][2] * s[0] ) * inv;
+	tmp._44 = (  a[2][0] * s[3] - a[2][1] * s[1] + a[2][2] * s[0] ) * inv;
+
+	*result = tmp;
+
+	return det;
+}
+
+double matrix4d_determinant( const matrix4d_t* mat )
+{
+	double s[6], c[6];
+	const double (*a)[4];
+
+	if ( mat == NULL ) return 0;
+
+	a = mat->m;
+
+	s[0] = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+	s[1] = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+	s[2] = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+	s[3] = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+	s[4] = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+	s[5] = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+	c[0] = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+	c[1] = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+	c[2] = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+	c[3] = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+	c[4] = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+	c[5] = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+
+	return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+}
+
+void matrix4d_translation( matrix4d_t* mat, double x, double y, double z )
+{
+	if ( mat == NULL ) return;
+
+	mat->_12 = mat->_13 = mat->_14 =
+	mat->_21 = mat->_23 = mat->_24 =
+	mat->_31 = mat->_32 = mat->_34 = 0.0;
+
+	mat->_11 = mat->_22 = mat->_33 = mat->_44 = 1.0;
+
+	mat->_41 = x; mat->_42 = y; mat->_43 = z;
+}
+
+void matrix4d_rotation_x( matrix4d_t* mat, double rad )
+{
+	double dsin, dcos;
+
+	if ( mat == NULL ) return;
+
+	mat->_12 = mat->_13 = mat->_14 =
+	mat->_21 = mat->_24 =
+	mat->_31 = mat->_34 =
+	mat->_41 = mat->_42 = mat->_43 = 0.0;
+
+	mat->_11 = mat->_44 = 1.0;
+
+	dsin = sin( rad );
+	dcos = cos( rad );
+
+	mat->_22 = dcos; mat->_23 = dsin;
+	mat->_32 = -dsin; mat->_33 = dcos;
+}
+
+void matrix4d_rotation_y( matrix4d_t* mat, double rad )
+{
+	double dsin, dcos;
+
+	if ( mat == NULL ) return;
+
+	mat->_12 = mat->_14 =
+	mat->_21 = mat->_23 = mat->_24 =
+	mat->_32 = mat->_34 =
+	mat->_41 = mat->_42 = mat->_43 = 0.0;
+
+	mat->_22 = mat->_44 = 1.0;
+
+	dsin = sin( rad );
+	dcos = cos( rad );
+
+	mat->_11 = dcos; mat->_13 = -dsin;
+	mat->_31 = dsin; mat->_33 = dcos;
+}
+
+void matrix4d_rotation_z( matrix4d_t* mat, double rad )
+{
+	double dsin, dcos;
+
+	if ( mat == NULL ) return;
+
+	mat->_13 = mat->_14 =
+	mat->_23 = mat->_24 =
+	mat->_31 = mat->_32 = mat->_34 =
+	mat->_41 = mat->_42 = mat->_43 = 0.0;
+
+	mat->_33 = mat->_44 = 1.0;
+
+	dsin = sin( rad );
+	dcos = cos( rad );
+
+	mat->_11 = dcos; mat->_12 = dsin;
+	mat->_21 = -dsin; mat->_22 = dcos;
+}
+
+void matrix4d_scale( matrix4d_t* mat, double x_scale, double y_scale, double z_scale )
+{
+	if ( mat == NULL ) return;
+
+	mat->_12 = mat->_13 = mat->_14 =
+	mat->_21 = mat->_23 = mat->_24 =
+	mat->_31 = mat->_32 = mat->_34 =
+	mat->_41 = mat->_42 = mat->_43 = 0.0;
+
+	mat->_44 = 1.0;
+
+	mat->_11 = x_scale; mat->_22 = y_scale; mat->_33 = z_scale;
+}
+
+void matrix4d_from_matrix4( matrix4d_t* result, const matrix4_t* mat )
+{
+	int32 i;
+
+	for ( i = 0; i < 16; i++ )
+		result->mat[i] = (double)mat->mat[i];
+}
+
+void matrix4d_to_matrix4( matrix4_t* result, const matrix4d_t* mat )
+{
+	int32 i;
+
+	for ( i = 0; i < 16; i++ )
+		result->mat[i] = (float)mat->mat[i];
+}
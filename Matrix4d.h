@@ -0,0 +1,91 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Matrix4d.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		A double precision 4x4 matrix for large world coordinates.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_MATRIX4D_H
+#define __MYLLY_MATRIX4D_H
+
+#include "stdtypes.h"
+#include "Math/Matrix4.h"
+
+#ifdef __cplusplus
+
+// A matrix implementation for C++
+union matrix4d_t
+{
+public:
+	matrix4d_t()
+	{
+		_11 = _12 = _13 = _14 = 0.0;
+		_21 = _22 = _23 = _24 = 0.0;
+		_31 = _32 = _33 = _34 = 0.0;
+		_41 = _42 = _43 = _44 = 0.0;
+	}
+
+public:
+	struct {
+		double _11, _12, _13, _14;
+		double _21, _22, _23, _24;
+		double _31, _32, _33, _34;
+		double _41, _42, _43, _44;
+	};
+	double m[4][4];
+	double mat[16];
+};
+
+#else
+
+// Pure C version of the struct
+typedef union
+{
+	struct {
+		double _11, _12, _13, _14;
+		double _21, _22, _23, _24;
+		double _31, _32, _33, _34;
+		double _41, _42, _43, _44;
+	};
+	double m[4][4];
+	double mat[16];
+} matrix4d_t;
+
+#endif
+
+typedef matrix4d_t Matrix4d;
+
+__BEGIN_DECLS
+
+MYLLY_API void			matrix4d_add				( matrix4d_t* result, const matrix4d_t* mat1, const matrix4d_t* mat2 );
+MYLLY_API void			matrix4d_subtract			( matrix4d_t* result, const matrix4d_t* mat1, const matrix4d_t* mat2 );
+MYLLY_API void			matrix4d_multiply			( matrix4d_t* result, const matrix4d_t* mat1, const matrix4d_t* mat2 );
+
+MYLLY_API void			matrix4d_add_scalar			( matrix4d_t* result, const matrix4d_t* mat, double f );
+MYLLY_API void			matrix4d_subtract_scalar	( matrix4d_t* result, const matrix4d_t* mat, double f );
+MYLLY_API void			matrix4d_multiply_scalar	( matrix4d_t* result, const matrix4d_t* mat, double f );
+MYLLY_API void			matrix4d_divide_scalar		( matrix4d_t* result, const matrix4d_t* mat, double f );
+
+MYLLY_API void			matrix4d_identity			( matrix4d_t* mat );
+MYLLY_API void			matrix4d_transpose			( matrix4d_t* result, const matrix4d_t* mat );
+MYLLY_API double		matrix4d_inverse			( matrix4d_t* result, const matrix4d_t* mat );
+MYLLY_API double		matrix4d_determinant		( const matrix4d_t* mat );
+
+MYLLY_API void			matrix4d_translation		( matrix4d_t* mat, double x, double y, double z );
+MYLLY_API void			matrix4d_rotation_x			( matrix4d_t* mat, double rad );
+MYLLY_API void			matrix4d_rotation_y			( matrix4d_t* mat, double rad );
+MYLLY_API void			matrix4d_rotation_z			( matrix4d_t* mat, double rad );
+MYLLY_API void			matrix4d_scale				( matrix4d_t* mat, double x_scale, double y_scale, double z_scale );
+
+// Conversions between the single and double precision matrices.
+MYLLY_API void			matrix4d_from_matrix4		( matrix4d_t* result, const matrix4_t* mat );
+MYLLY_API void			matrix4d_to_matrix4			( matrix4_t* result, const matrix4d_t* mat );
+
+__END_DECLS
+
+#endif /* __MYLLY_MATRIX4D_H */
@@ -0,0 +1,369 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Quaternion.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Rotation quaternion.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/Quaternion.h"
+#include "Math/MathSimd.h"
+#include "Math/MathTrig.h"
+#include <math.h>
+
+// Below this the quaternions are so close slerp falls back to nlerp to avoid dividing by sin(~0).
+#define SLERP_THRESHOLD 0.9995f
+
+void quaternion_identity( quaternion_t* q )
+{
+	if ( q == NULL ) return;
+
+	q->x = q->y = q->z = 0.0f;
+	q->w = 1.0f;
+}
+
+void quaternion_multiply( quaternion_t* result, const quaternion_t* q1, const quaternion_t* q2 )
+{
+	float x, y, z, w;
+
+	if ( result == NULL || q1 == NULL || q2 == NULL ) return;
+
+	// Hamilton product q2 * q1
+	x = q2->w * q1->x + q2->x * q1->w + q2->y * q1->z - q2->z * q1->y;
+	y = q2->w * q1->y - q2->x * q1->z + q2->y * q1->w + q2->z * q1->x;
+	z = q2->w * q1->z + q2->x * q1->y - q2->y * q1->x + q2->z * q1->w;
+	w = q2->w * q1->w - q2->x * q1->x - q2->y * q1->y - q2->z * q1->z;
+
+	result->x = x;
+	result->y = y;
+	result->z = z;
+	result->w = w;
+}
+
+void quaternion_conjugate( quaternion_t* result, const quaternion_t* q )
+{
+	if ( result == NULL || q == NULL ) return;
+
+	result->x = -q->x;
+	result->y = -q->y;
+	result->z = -q->z;
+	result->w = q->w;
+}
+
+void quaternion_inverse( quaternion_t* result, const quaternion_t* q )
+{
+	float len;
+
+	if ( result == NULL || q == NULL ) return;
+
+	len = quaternion_dot( q, q );
+	if ( len == 0.0f ) return;
+
+	len = 1.0f / len;
+
+	result->x = -q->x * len;
+	result->y = -q->y * len;
+	result->z = -q->z * len;
+	result->w = q->w * len;
+}
+
+float quaternion_dot( const quaternion_t* q1, const quaternion_t* q2 )
+{
+	return q1->x * q2->x + q1->y * q2->y + q1->z * q2->z + q1->w * q2->w;
+}
+
+float quaternion_length( const quaternion_t* q )
+{
+	return sqrtf( quaternion_dot( q, q ) );
+}
+
+void quaternion_normalize( quaternion_t* q )
+{
+	float len;
+
+	if ( q == NULL ) return;
+
+	len = quaternion_length( q );
+	if ( len == 0.0f ) return;
+
+	len = 1.0f / len;
+
+	q->x *= len;
+	q->y *= len;
+	q->z *= len;
+	q->w *= len;
+}
+
+void quaternion_nlerp( quaternion_t* result, const quaternion_t* q1, const quaternion_t* q2, float t )
+{
+	float t1 = 1.0f - t;
+
+	if ( result == NULL || q1 == NULL || q2 == NULL ) return;
+
+	// q and -q are the same rotation, flip q2 to the same hemisphere to take the short way round.
+	if ( quaternion_dot( q1, q2 ) < 0.0f ) t = -t;
+
+	result->x = q1->x * t1 + q2->x * t;
+	result->y = q1->y * t1 + q2->y * t;
+	result->z = q1->z * t1 + q2->z * t;
+	result->w = q1->w * t1 + q2->w * t;
+
+	quaternion_normalize( result );
+}
+
+void quaternion_slerp( quaternion_t* result, const quaternion_t* q1, const quaternion_t* q2, float t )
+{
+	float cosom, omega, sinom, s1, s2, sign = 1.0f;
+
+	if ( result == NULL || q1 == NULL || q2 == NULL ) return;
+
+	cosom = quaternion_dot( q1, q2 );
+
+	if ( cosom < 0.0f )
+	{
+		cosom = -cosom;
+		sign = -1.0f;
+	}
+
+	if ( cosom > SLERP_THRESHOLD )
+	{
+		quaternion_nlerp( result, q1, q2, t );
+		return;
+	}
+
+	omega = acosf( cosom );
+	sinom = 1.0f / sinf( omega );
+
+	s1 = sinf( ( 1.0f - t ) * omega ) * sinom;
+	s2 = sign * sinf( t * omega ) * sinom;
+
+	result->x = q1->x * s1 + q2->x * s2;
+	result->y = q1->y * s1 + q2->y * s2;
+	result->z = q1->z * s1 + q2->z * s2;
+	result->w = q1->w * s1 + q2->w * s2;
+}
+
+void quaternion_rotation_axis( quaternion_t* result, const vector3_t* axis, float rad )
+{
+	float s, c;
+
+	if ( result == NULL || axis == NULL ) return;
+
+	math_sincos( rad * 0.5f, &s, &c );
+
+	result->x = axis->x * s;
+	result->y = axis->y * s;
+	result->z = axis->z * s;
+	result->w = c;
+}
+
+void quaternion_to_axis_angle( const quaternion_t* q, vector3_t* axis, float* rad )
+{
+	float s;
+
+	if ( q == NULL ) return;
+
+	// sin(angle / 2) is the length of the vector part.
+	s = sqrtf( q->x * q->x + q->y * q->y + q->z * q->z );
+
+	if ( axis != NULL )
+	{
+		if ( s > 0.0f )
+		{
+			axis->x = q->x / s;
+			axis->y = q->y / s;
+			axis->z = q->z / s;
+		}
+		else
+		{
+			// No rotation, any axis will do.
+			axis->x = 1.0f;
+			axis->y = axis->z = 0.0f;
+		}
+	}
+
+	if ( rad != NULL ) *rad = 2.0f * atan2f( s, q->w );
+}
+
+void quaternion_rotation_yaw_pitch_roll( quaternion_t* result, float yaw, float pitch, float roll )
+{
+	float sy, cy, sp, cp, sr, cr;
+
+	if ( result == NULL ) return;
+
+	math_sincos( yaw * 0.5f, &sy, &cy );
+	math_sincos( pitch * 0.5f, &sp, &cp );
+	math_sincos( roll * 0.5f, &sr, &cr );
+
+	// Expanded roll * pitch * yaw
+	result->x = cy * sp * cr + sy * cp * sr;
+	result->y = sy * cp * cr - cy * sp * sr;
+	result->z = cy * cp * sr - sy * sp * cr;
+	result->w = cy * cp * cr + sy * sp * sr;
+}
+
+void quaternion_to_matrix4( matrix4_t* result, const quaternion_t* q )
+{
+	float xx, yy, zz, xy, xz, yz, wx, wy, wz;
+
+	if ( result == NULL || q == NULL ) return;
+
+	xx = q->x * q->x; yy = q->y * q->y; zz = q->z * q->z;
+	xy = q->x * q->y; xz = q->x * q->z; yz = q->y * q->z;
+	wx = q->w * q->x; wy = q->w * q->y; wz = q->w * q->z;
+
+	result->_11 = 1.0f - 2.0f * ( yy + zz );
+	result->_12 = 2.0f * ( xy + wz );
+	result->_13 = 2.0f * ( xz - wy );
+	result->_14 = 0.0f;
+
+	result->_21 = 2.0f * ( xy - wz );
+	result->_22 = 1.0f - 2.0f * ( xx + zz );
+	result->_23 = 2.0f * ( yz + wx );
+	result->_24 = 0.0f;
+
+	result->_31 = 2.0f * ( xz + wy );
+	result->_32 = 2.0f * ( yz - wx );
+	result->_33 = 1.0f - 2.0f * ( xx + yy );
+	result->_34 = 0.0f;
+
+	result->_41 = result->_42 = result->_43 = 0.0f;
+	result->_44 = 1.0f;
+}
+
+void quaternion_from_matrix4( quaternion_t* result, const matrix4_t* mat )
+{
+	float trace, s;
+
+	if ( result == NULL || mat == NULL ) return;
+
+	// Shepperd's method: solve for the largest component first to keep the division well conditioned.
+	trace = mat->_11 + mat->_22 + mat->_33;
+
+	if ( trace > 0.0f )
+	{
+		s = 2.0f * sqrtf( trace + 1.0f );
+		result->w = 0.25f * s;
+		s = 1.0f / s;
+		result->x = ( mat->_23 - mat->_32 ) * s;
+		result->y = ( mat->_31 - mat->_13 ) * s;
+		result->z = ( mat->_12 - mat->_21 ) * s;
+	}
+	else if ( mat->_11 > mat->_22 && mat->_11 > mat->_33 )
+	{
+		s = 2.0f * sqrtf( 1.0f + mat->_11 - mat->_22 - mat->_33 );
+		result->x = 0.25f * s;
+		s = 1.0f / s;
+		result->y = ( mat->_12 + mat->_21 ) * s;
+		result->z = ( mat->_13 + mat->_31 ) * s;
+		result->w = ( mat->_23 - mat->_32 ) * s;
+	}
+	else if ( mat->_22 > mat->_33 )
+	{
+		s = 2.0f * sqrtf( 1.0f + mat->_22 - mat->_11 - mat->_33 );
+		result->y = 0.25f * s;
+		s = 1.0f / s;
+		result->x = ( mat->_12 + mat->_21 ) * s;
+		result->z = ( mat->_23 + mat->_32 ) * s;
+		result->w = ( mat->_31 - mat->_13 ) * s;
+	}
+	else
+	{
+		s = 2.0f * sqrtf( 1.0f + mat->_33 - mat->_11 - mat->_22 );
+		result->z = 0.25f * s;
+		s = 1.0f / s;
+		result->x = ( mat->_13 + mat->_31 ) * s;
+		result->y = ( mat->_23 + mat->_32 ) * s;
+		result->w = ( mat->_12 - mat->_21 ) * s;
+	}
+}
+
+void quaternion_to_matrix4_array( matrix4_t* result, const quaternion_t* q, uint32 count )
+{
+	uint32 i = 0;
+	simd4f x, y, z, w, two, one, zero, xx, yy, zz, xy, xz, yz, wx, wy, wz;
+	simd4f r0, r1, r2, r3;
+
+	if ( result == NULL || q == NULL ) return;
+
+	two = simd4f_set1( 2.0f );
+	one = simd4f_set1( 1.0f );
+	zero = simd4f_zero();
+
+	// Four quaternions at a time: transpose to x/y/z/w vectors, compute each matrix element for
+	// all four and transpose the rows back.
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		x = simd4f_loadu( q[i].q );
+		y = simd4f_loadu( q[i+1].q );
+		z = simd4f_loadu( q[i+2].q );
+		w = simd4f_loadu( q[i+3].q );
+		simd4f_transpose( x, y, z, w );
+
+		xx = simd4f_mul( x, x ); yy = simd4f_mul( y, y ); zz = simd4f_mul( z, z );
+		xy = simd4f_mul( x, y ); xz = simd4f_mul( x, z ); yz = simd4f_mul( y, z );
+		wx = simd4f_mul( w, x ); wy = simd4f_mul( w, y ); wz = simd4f_mul( w, z );
+
+		r0 = simd4f_sub( one, simd4f_mul( two, simd4f_add( yy, zz ) ) );
+		r1 = simd4f_mul( two, simd4f_add( xy, wz ) );
+		r2 = simd4f_mul( two, simd4f_sub( xz, wy ) );
+		r3 = zero;
+		simd4f_transpose( r0, r1, r2, r3 );
+		simd4f_storeu( result[i].m[0], r0 );
+		simd4f_storeu( result[i+1].m[0], r1 );
+		simd4f_storeu( result[i+2].m[0], r2 );
+		simd4f_storeu( result[i+3].m[0], r3 );
+
+		r0 = simd4f_mul( two, simd4f_sub( xy, wz ) );
+		r1 = simd4f_sub( one, simd4f_mul( two, simd4f_add( xx, zz ) ) );
+		r2 = simd4f_mul( two, simd4f_add( yz, wx ) );
+		r3 = zero;
+		simd4f_transpose( r0, r1, r2, r3 );
+		simd4f_storeu( result[i].m[1], r0 );
+		simd4f_storeu( result[i+1].m[1], r1 );
+		simd4f_storeu( result[i+2].m[1], r2 );
+		simd4f_storeu( result[i+3].m[1], r3 );
+
+		r0 = simd4f_mul( two, simd4f_add( xz, wy ) );
+		r1 = simd4f_mul( two, simd4f_sub( yz, wx ) );
+		r2 = simd4f_sub( one, simd4f_mul( two, simd4f_add( xx, yy ) ) );
+		r3 = zero;
+		simd4f_transpose( r0, r1, r2, r3 );
+		simd4f_storeu( result[i].m[2], r0 );
+		simd4f_storeu( result[i+1].m[2], r1 );
+		simd4f_storeu( result[i+2].m[2], r2 );
+		simd4f_storeu( result[i+3].m[2], r3 );
+
+		r0 = simd4f_set( 0.0f, 0.0f, 0.0f, 1.0f );
+		simd4f_storeu( result[i].m[3], r0 );
+		simd4f_storeu( result[i+1].m[3], r0 );
+		simd4f_storeu( result[i+2].m[3], r0 );
+		simd4f_storeu( result[i+3].m[3], r0 );
+	}
+
+	for ( ; i < count; i++ )
+		quaternion_to_matrix4( &result[i], &q[i] );
+}
+
+void quaternion_transform_vector( vector3_t* result, const vector3_t* v, const quaternion_t* q )
+{
+	float tx, ty, tz, x, y, z;
+
+	if ( result == NULL || v == NULL || q == NULL ) return;
+
+	// v' = v + w * t + u x t where u = q.xyz and t = 2 * ( u x v ), same as v * quaternion_to_matrix4( q ).
+	tx = 2.0f * ( q->y * v->z - q->z * v->y );
+	ty = 2.0f * ( q->z * v->x - q->x * v->z );
+	tz = 2.0f * ( q->x * v->y - q->y * v->x );
+
+	x = v->x + q->w * tx + ( q->y * tz - q->z * ty );
+	y = v->y + q->w * ty + ( q->z * tx - q->x * tz );
+	z = v->z + q->w * tz + ( q->x * ty - q->y * tx );
+
+	result->x = x;
+	result->y = y;
+	result->z = z;
+}
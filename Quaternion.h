@@ -0,0 +1,63 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Quaternion.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Rotation quaternion.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_QUATERNION_H
+#define __MYLLY_QUATERNION_H
+
+#include "stdtypes.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+
+// Follows the same conventions as matrix4_t: quaternion_multiply( q1, q2 ) is the rotation q1
+// followed by q2, so quaternion_to_matrix4( q1 * q2 ) == matrix4_multiply( q1, q2 ).
+typedef union
+{
+	struct {
+		float x;
+		float y;
+		float z;
+		float w;
+	};
+	float q[4];
+} quaternion_t;
+
+__BEGIN_DECLS
+
+MYLLY_API void			quaternion_identity				( quaternion_t* q );
+MYLLY_API void			quaternion_multiply				( quaternion_t* result, const quaternion_t* q1, const quaternion_t* q2 );
+MYLLY_API void			quaternion_conjugate			( quaternion_t* result, const quaternion_t* q );
+MYLLY_API void			quaternion_inverse				( quaternion_t* result, const quaternion_t* q );
+
+MYLLY_API float			quaternion_dot					( const quaternion_t* q1, const quaternion_t* q2 );
+MYLLY_API float			quaternion_length				( const quaternion_t* q );
+MYLLY_API void			quaternion_normalize			( quaternion_t* q );
+
+// Both interpolate along the shortest path. nlerp is much cheaper but doesn't have a constant angular velocity.
+MYLLY_API void			quaternion_slerp				( quaternion_t* result, const quaternion_t* q1, const quaternion_t* q2, float t );
+MYLLY_API void			quaternion_nlerp				( quaternion_t* result, const quaternion_t* q1, const quaternion_t* q2, float t );
+
+// The axis must be normalized. Angles are in radians with the same sign as matrix4_rotation_x/y/z.
+MYLLY_API void			quaternion_rotation_axis		( quaternion_t* result, const vector3_t* axis, float rad );
+MYLLY_API void			quaternion_to_axis_angle		( const quaternion_t* q, vector3_t* axis, float* rad );
+// Roll around z, then pitch around x, then yaw around y.
+MYLLY_API void			quaternion_rotation_yaw_pitch_roll	( quaternion_t* result, float yaw, float pitch, float roll );
+
+// Conversion from a matrix uses the upper 3x3 part which must be a pure rotation.
+MYLLY_API void			quaternion_to_matrix4			( matrix4_t* result, const quaternion_t* q );
+MYLLY_API void			quaternion_from_matrix4			( quaternion_t* result, const matrix4_t* mat );
+MYLLY_API void			quaternion_to_matrix4_array		( matrix4_t* result, const quaternion_t* q, uint32 count );
+
+MYLLY_API void			quaternion_transform_vector		( vector3_t* result, const vector3_t* v, const quaternion_t* q );
+
+__END_DECLS
+
+#endif /* __MYLLY_QUATERNION_H */
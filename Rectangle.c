@@ -10,6 +10,8 @@
  **********************************************************************/
 
 #include "Math/Rectangle.h"
+#include "Math/MathSimd.h"
+#include <string.h>
 
 bool rect_is_point_in( const rectangle_t* r, uint16 x, uint16 y )
 {
@@ -31,3 +33,177 @@ bool rect_equals( const rectangle_t* r1, const rectangle_t* r2 )
 {
 	return ( r1->x == r2->x && r1->y == r2->y && r1->w == r2->w && r1->h == r2->h );
 }
+
+// Widths and heights are treated as unsigned and all edges are computed with 32-bit integers
+// so x + w can't overflow. Clipping keeps the area [x, x + w) x [y, y + h) inside the clip rectangle.
+bool rect_clip( rectangle_t* result, const rectangle_t* r, const rectangle_t* clip )
+{
+	int32 x1 = r->x > clip->x ? r->x : clip->x;
+	int32 y1 = r->y > clip->y ? r->y : clip->y;
+	int32 x2 = (int32)r->x + r->uw;
+	int32 y2 = (int32)r->y + r->uh;
+	int32 cx2 = (int32)clip->x + clip->uw;
+	int32 cy2 = (int32)clip->y + clip->uh;
+
+	if ( cx2 < x2 ) x2 = cx2;
+	if ( cy2 < y2 ) y2 = cy2;
+
+	result->x = (int16)x1;
+	result->y = (int16)y1;
+
+	if ( x2 <= x1 || y2 <= y1 )
+	{
+		result->uw = 0;
+		result->uh = 0;
+		return false;
+	}
+
+	result->uw = (uint16)( x2 - x1 );
+	result->uh = (uint16)( y2 - y1 );
+
+	return true;
+}
+
+#if defined(MYLLY_MATH_SSE2)
+
+// SSE2 has no 32-bit integer min/max.
+static MYLLY_INLINE __m128i rect_max_epi32( __m128i a, __m128i b )
+{
+	__m128i gt = _mm_cmpgt_epi32( a, b );
+	return _mm_or_si128( _mm_and_si128( gt, a ), _mm_andnot_si128( gt, b ) );
+}
+
+static MYLLY_INLINE __m128i rect_min_epi32( __m128i a, __m128i b )
+{
+	__m128i gt = _mm_cmpgt_epi32( a, b );
+	return _mm_or_si128( _mm_and_si128( gt, b ), _mm_andnot_si128( gt, a ) );
+}
+
+// Packs the low 16 bits of each lane without saturating.
+static MYLLY_INLINE __m128i rect_pack_epi32( __m128i a, __m128i b )
+{
+	a = _mm_srai_epi32( _mm_slli_epi32( a, 16 ), 16 );
+	b = _mm_srai_epi32( _mm_slli_epi32( b, 16 ), 16 );
+
+	return _mm_packs_epi32( a, b );
+}
+
+#endif
+
+uint32 rect_clip_array( rectangle_t* result, uint32* visible, const rectangle_t* rects, uint32 count, const rectangle_t* clip )
+{
+	uint32 i = 0, num_visible = 0;
+
+	if ( result == NULL || visible == NULL || rects == NULL || clip == NULL ) return 0;
+
+	memset( visible, 0, ( ( count + 31 ) / 32 ) * sizeof( uint32 ) );
+
+#if defined(MYLLY_MATH_SSE2)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i cx1 = _mm_set1_epi32( clip->x );
+		__m128i cy1 = _mm_set1_epi32( clip->y );
+		__m128i cx2 = _mm_set1_epi32( (int32)clip->x + clip->uw );
+		__m128i cy2 = _mm_set1_epi32( (int32)clip->y + clip->uh );
+
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			__m128i a = _mm_loadu_si128( (const __m128i*)&rects[i] );
+			__m128i b = _mm_loadu_si128( (const __m128i*)&rects[i+2] );
+			__m128i t0, t1, xy, wh, x1, y1, x2, y2, w, h, vis;
+			uint32 bits;
+
+			// Deinterleave into x0-3 y0-3 and w0-3 h0-3.
+			t0 = _mm_unpacklo_epi16( a, b );
+			t1 = _mm_unpackhi_epi16( a, b );
+			xy = _mm_unpacklo_epi16( t0, t1 );
+			wh = _mm_unpackhi_epi16( t0, t1 );
+
+			// Sign extend the positions, zero extend the sizes.
+			x1 = _mm_srai_epi32( _mm_unpacklo_epi16( xy, xy ), 16 );
+			y1 = _mm_srai_epi32( _mm_unpackhi_epi16( xy, xy ), 16 );
+			x2 = _mm_add_epi32( x1, _mm_unpacklo_epi16( wh, zero ) );
+			y2 = _mm_add_epi32( y1, _mm_unpackhi_epi16( wh, zero ) );
+
+			x1 = rect_max_epi32( x1, cx1 );
+			y1 = rect_max_epi32( y1, cy1 );
+			x2 = rect_min_epi32( x2, cx2 );
+			y2 = rect_min_epi32( y2, cy2 );
+
+			w = _mm_sub_epi32( x2, x1 );
+			h = _mm_sub_epi32( y2, y1 );
+			vis = _mm_and_si128( _mm_cmpgt_epi32( w, zero ), _mm_cmpgt_epi32( h, zero ) );
+			w = _mm_and_si128( w, vis );
+			h = _mm_and_si128( h, vis );
+
+			// Interleave back to x y w h.
+			t0 = rect_pack_epi32( x1, w );
+			t1 = rect_pack_epi32( y1, h );
+			xy = _mm_unpacklo_epi16( t0, t1 );
+			wh = _mm_unpackhi_epi16( t0, t1 );
+
+			_mm_storeu_si128( (__m128i*)&result[i], _mm_unpacklo_epi32( xy, wh ) );
+			_mm_storeu_si128( (__m128i*)&result[i+2], _mm_unpackhi_epi32( xy, wh ) );
+
+			bits = (uint32)_mm_movemask_ps( _mm_castsi128_ps( vis ) );
+			visible[i / 32] |= bits << ( i % 32 );
+			num_visible += ( bits & 1 ) + ( ( bits >> 1 ) & 1 ) + ( ( bits >> 2 ) & 1 ) + ( bits >> 3 );
+		}
+	}
+#elif defined(MYLLY_MATH_NEON)
+	{
+		static const uint32 lane_bits[4] = { 1, 2, 4, 8 };
+		uint32x4_t lanes = vld1q_u32( lane_bits );
+		int32x4_t zero = vdupq_n_s32( 0 );
+		int32x4_t cx1 = vdupq_n_s32( clip->x );
+		int32x4_t cy1 = vdupq_n_s32( clip->y );
+		int32x4_t cx2 = vdupq_n_s32( (int32)clip->x + clip->uw );
+		int32x4_t cy2 = vdupq_n_s32( (int32)clip->y + clip->uh );
+
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			int16x4x4_t r = vld4_s16( (const int16*)&rects[i] );
+			int32x4_t x1, y1, x2, y2, w, h;
+			uint32x4_t vis;
+			uint32 bits;
+
+			x1 = vmovl_s16( r.val[0] );
+			y1 = vmovl_s16( r.val[1] );
+			x2 = vaddq_s32( x1, vreinterpretq_s32_u32( vmovl_u16( vreinterpret_u16_s16( r.val[2] ) ) ) );
+			y2 = vaddq_s32( y1, vreinterpretq_s32_u32( vmovl_u16( vreinterpret_u16_s16( r.val[3] ) ) ) );
+
+			x1 = vmaxq_s32( x1, cx1 );
+			y1 = vmaxq_s32( y1, cy1 );
+			x2 = vminq_s32( x2, cx2 );
+			y2 = vminq_s32( y2, cy2 );
+
+			w = vsubq_s32( x2, x1 );
+			h = vsubq_s32( y2, y1 );
+			vis = vandq_u32( vcgtq_s32( w, zero ), vcgtq_s32( h, zero ) );
+			w = vandq_s32( w, vreinterpretq_s32_u32( vis ) );
+			h = vandq_s32( h, vreinterpretq_s32_u32( vis ) );
+
+			r.val[0] = vmovn_s32( x1 );
+			r.val[1] = vmovn_s32( y1 );
+			r.val[2] = vmovn_s32( w );
+			r.val[3] = vmovn_s32( h );
+			vst4_s16( (int16*)&result[i], r );
+
+			bits = vaddvq_u32( vandq_u32( vis, lanes ) );
+			visible[i / 32] |= bits << ( i % 32 );
+			num_visible += ( bits & 1 ) + ( ( bits >> 1 ) & 1 ) + ( ( bits >> 2 ) & 1 ) + ( bits >> 3 );
+		}
+	}
+#endif
+
+	for ( ; i < count; i++ )
+	{
+		if ( rect_clip( &result[i], &rects[i], clip ) )
+		{
+			visible[i / 32] |= 1u << ( i % 32 );
+			num_visible++;
+		}
+	}
+
+	return num_visible;
+}
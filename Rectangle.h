@@ -58,6 +58,14 @@ MYLLY_API bool			rect_is_point_in		( const rectangle_t* r, uint16 x, uint16 y );
 MYLLY_API bool			rect_is_in				( const rectangle_t* r1, const rectangle_t* r2 );
 MYLLY_API bool			rect_equals				( const rectangle_t* r1, const rectangle_t* r2 );
 
+// Clips r against clip and returns true if anything is left. Rectangles that are clipped away
+// entirely get zero width and height.
+MYLLY_API bool			rect_clip				( rectangle_t* result, const rectangle_t* r, const rectangle_t* clip );
+
+// Clips count rectangles against clip. Bit i % 32 of visible[i / 32] is set if rectangle i is still
+// visible, visible must hold ( count + 31 ) / 32 words. Returns the number of visible rectangles.
+MYLLY_API uint32		rect_clip_array			( rectangle_t* result, uint32* visible, const rectangle_t* rects, uint32 count, const rectangle_t* clip );
+
 __END_DECLS
 
 #endif /* __MYLLY_RECTANGLE_H */
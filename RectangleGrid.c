@@ -0,0 +1,340 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		RectangleGrid.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		A uniform grid spatial index for rectangles.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/RectangleGrid.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Range of cells covered by a rectangle.
+typedef struct
+{
+	uint32 x0, y0, x1, y1;
+} cell_range_t;
+
+static MYLLY_INLINE uint32 grid_cell_coord( int32 coord, int32 origin, uint32 cell_size, uint32 num_cells )
+{
+	int32 c = ( coord - origin ) / (int32)cell_size;
+
+	if ( coord < origin ) return 0;
+	return (uint32)c >= num_cells ? num_cells - 1 : (uint32)c;
+}
+
+// Sizes are read unsigned so that rectangles wider or taller than 32767 work.
+static void grid_cell_range( const rect_grid_t* grid, const rectangle_t* r, cell_range_t* range )
+{
+	range->x0 = grid_cell_coord( r->x, grid->bounds.x, grid->cell_size, grid->cols );
+	range->y0 = grid_cell_coord( r->y, grid->bounds.y, grid->cell_size, grid->rows );
+	range->x1 = grid_cell_coord( r->x + (int32)r->uw, grid->bounds.x, grid->cell_size, grid->cols );
+	range->y1 = grid_cell_coord( r->y + (int32)r->uh, grid->bounds.y, grid->cell_size, grid->rows );
+}
+
+static MYLLY_INLINE bool grid_rects_overlap( const rectangle_t* a, const rectangle_t* b )
+{
+	return ( a->x <= b->x + (int32)b->uw &&
+			 b->x <= a->x + (int32)a->uw &&
+			 a->y <= b->y + (int32)b->uh &&
+			 b->y <= a->y + (int32)a->uh );
+}
+
+static bool grid_cell_add( rect_grid_cell_t* cell, uint32 handle )
+{
+	uint32* items;
+	uint32 capacity;
+
+	if ( cell->count == cell->capacity )
+	{
+		capacity = cell->capacity ? cell->capacity * 2 : 8;
+		items = (uint32*)realloc( cell->items, capacity * sizeof( uint32 ) );
+
+		if ( items == NULL ) return false;
+
+		cell->items = items;
+		cell->capacity = capacity;
+	}
+
+	cell->items[cell->count++] = handle;
+	return true;
+}
+
+static void grid_cell_remove( rect_grid_cell_t* cell, uint32 handle )
+{
+	uint32 i;
+
+	for ( i = 0; i < cell->count; i++ )
+	{
+		if ( cell->items[i] == handle )
+		{
+			cell->items[i] = cell->items[--cell->count];
+			return;
+		}
+	}
+}
+
+static void grid_unlink( rect_grid_t* grid, uint32 handle, const cell_range_t* range )
+{
+	uint32 x, y;
+
+	for ( y = range->y0; y <= range->y1; y++ )
+		for ( x = range->x0; x <= range->x1; x++ )
+			grid_cell_remove( &grid->cells[y * grid->cols + x], handle );
+}
+
+static bool grid_link( rect_grid_t* grid, uint32 handle )
+{
+	cell_range_t range;
+	uint32 x, y;
+
+	grid_cell_range( grid, &grid->items[handle].rect, &range );
+
+	for ( y = range.y0; y <= range.y1; y++ )
+	{
+		for ( x = range.x0; x <= range.x1; x++ )
+		{
+			if ( !grid_cell_add( &grid->cells[y * grid->cols + x], handle ) )
+			{
+				// Undo the partial insert. The cell we failed on doesn't contain the handle,
+				// removing from it does nothing.
+				range.y1 = y;
+				grid_unlink( grid, handle, &range );
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static MYLLY_INLINE bool grid_valid_handle( const rect_grid_t* grid, uint32 handle )
+{
+	return handle < grid->num_items && grid->items[handle].used;
+}
+
+static MYLLY_INLINE uint32 grid_report( rect_grid_t* grid, uint32 handle, uint32* results, uint32 max_results, uint32 hits )
+{
+	if ( grid->items[handle].stamp == grid->stamp ) return hits;
+
+	grid->items[handle].stamp = grid->stamp;
+
+	if ( hits < max_results ) results[hits] = handle;
+	return hits + 1;
+}
+
+static void grid_next_stamp( rect_grid_t* grid )
+{
+	uint32 i;
+
+	// When the counter wraps reset the stamps so old values can't match.
+	if ( ++grid->stamp == 0 )
+	{
+		for ( i = 0; i < grid->num_items; i++ )
+			grid->items[i].stamp = 0;
+
+		grid->stamp = 1;
+	}
+}
+
+bool rect_grid_create( rect_grid_t* grid, const rectangle_t* bounds, uint16 cell_size )
+{
+	if ( grid == NULL || bounds == NULL || cell_size == 0 ) return false;
+
+	memset( grid, 0, sizeof( *grid ) );
+
+	grid->bounds = *bounds;
+	grid->cell_size = cell_size;
+	grid->cols = (uint32)bounds->uw / cell_size + 1;
+	grid->rows = (uint32)bounds->uh / cell_size + 1;
+	grid->free_list = RECT_GRID_INVALID;
+
+	grid->cells = (rect_grid_cell_t*)calloc( grid->cols * grid->rows, sizeof( rect_grid_cell_t ) );
+
+	return grid->cells != NULL;
+}
+
+void rect_grid_destroy( rect_grid_t* grid )
+{
+	uint32 i;
+
+	if ( grid == NULL ) return;
+
+	if ( grid->cells != NULL )
+	{
+		for ( i = 0; i < grid->cols * grid->rows; i++ )
+			free( grid->cells[i].items );
+
+		free( grid->cells );
+	}
+
+	free( grid->items );
+	memset( grid, 0, sizeof( *grid ) );
+}
+
+void rect_grid_clear( rect_grid_t* grid )
+{
+	uint32 i;
+
+	if ( grid == NULL ) return;
+
+	for ( i = 0; i < grid->cols * grid->rows; i++ )
+		grid->cells[i].count = 0;
+
+	grid->num_items = 0;
+	grid->free_list = RECT_GRID_INVALID;
+}
+
+uint32 rect_grid_insert( rect_grid_t* grid, const rectangle_t* r, void* data )
+{
+	rect_grid_item_t* items;
+	uint32 handle, capacity;
+
+	if ( grid == NULL || r == NULL ) return RECT_GRID_INVALID;
+
+	if ( grid->free_list != RECT_GRID_INVALID )
+	{
+		handle = grid->free_list;
+	}
+	else
+	{
+		if ( grid->num_items == grid->max_items )
+		{
+			capacity = grid->max_items ? grid->max_items * 2 : 64;
+			items = (rect_grid_item_t*)realloc( grid->items, capacity * sizeof( rect_grid_item_t ) );
+
+			if ( items == NULL ) return RECT_GRID_INVALID;
+
+			grid->items = items;
+			grid->max_items = capacity;
+		}
+
+		handle = grid->num_items;
+	}
+
+	grid->items[handle].rect = *r;
+	grid->items[handle].data = data;
+	grid->items[handle].stamp = 0;
+
+	if ( !grid_link( grid, handle ) ) return RECT_GRID_INVALID;
+
+	// Only take the slot once the item is linked, a failed insert leaves the grid unchanged.
+	if ( handle == grid->free_list ) grid->free_list = grid->items[handle].next;
+	else grid->num_items++;
+
+	grid->items[handle].next = RECT_GRID_INVALID;
+	grid->items[handle].used = true;
+
+	return handle;
+}
+
+bool rect_grid_remove( rect_grid_t* grid, uint32 handle )
+{
+	cell_range_t range;
+
+	if ( grid == NULL || !grid_valid_handle( grid, handle ) ) return false;
+
+	grid_cell_range( grid, &grid->items[handle].rect, &range );
+	grid_unlink( grid, handle, &range );
+
+	grid->items[handle].used = false;
+	grid->items[handle].data = NULL;
+	grid->items[handle].next = grid->free_list;
+	grid->free_list = handle;
+
+	return true;
+}
+
+bool rect_grid_update( rect_grid_t* grid, uint32 handle, const rectangle_t* r )
+{
+	cell_range_t old_range, new_range;
+	rectangle_t old;
+
+	if ( grid == NULL || r == NULL || !grid_valid_handle( grid, handle ) ) return false;
+
+	old = grid->items[handle].rect;
+	grid_cell_range( grid, &old, &old_range );
+	grid_cell_range( grid, r, &new_range );
+
+	grid->items[handle].rect = *r;
+
+	// Most updates are small moves within the same cells.
+	if ( memcmp( &old_range, &new_range, sizeof( cell_range_t ) ) == 0 ) return true;
+
+	grid_unlink( grid, handle, &old_range );
+
+	if ( !grid_link( grid, handle ) )
+	{
+		// Out of memory, the old cells had room for the item so this can't fail.
+		grid->items[handle].rect = old;
+		grid_link( grid, handle );
+		return false;
+	}
+
+	return true;
+}
+
+void* rect_grid_get_data( const rect_grid_t* grid, uint32 handle )
+{
+	if ( grid == NULL || !grid_valid_handle( grid, handle ) ) return NULL;
+	return grid->items[handle].data;
+}
+
+uint32 rect_grid_query_point( rect_grid_t* grid, uint16 x, uint16 y, uint32* results, uint32 max_results )
+{
+	const rect_grid_cell_t* cell;
+	uint32 i, handle, hits = 0;
+
+	if ( grid == NULL || grid->cells == NULL ) return 0;
+
+	cell = &grid->cells[grid_cell_coord( y, grid->bounds.y, grid->cell_size, grid->rows ) * grid->cols +
+						grid_cell_coord( x, grid->bounds.x, grid->cell_size, grid->cols )];
+
+	// A point touches a single cell so there can't be duplicates.
+	for ( i = 0; i < cell->count; i++ )
+	{
+		handle = cell->items[i];
+
+		if ( rect_is_point_in( &grid->items[handle].rect, x, y ) )
+		{
+			if ( hits < max_results ) results[hits] = handle;
+			hits++;
+		}
+	}
+
+	return hits;
+}
+
+uint32 rect_grid_query_rect( rect_grid_t* grid, const rectangle_t* r, uint32* results, uint32 max_results )
+{
+	const rect_grid_cell_t* cell;
+	cell_range_t range;
+	uint32 i, x, y, handle, hits = 0;
+
+	if ( grid == NULL || grid->cells == NULL || r == NULL ) return 0;
+
+	grid_next_stamp( grid );
+	grid_cell_range( grid, r, &range );
+
+	for ( y = range.y0; y <= range.y1; y++ )
+	{
+		for ( x = range.x0; x <= range.x1; x++ )
+		{
+			cell = &grid->cells[y * grid->cols + x];
+
+			for ( i = 0; i < cell->count; i++ )
+			{
+				handle = cell->items[i];
+
+				if ( grid_rects_overlap( &grid->items[handle].rect, r ) )
+					hits = grid_report( grid, handle, results, max_results, hits );
+			}
+		}
+	}
+
+	return hits;
+}
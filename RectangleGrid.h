@@ -0,0 +1,75 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		RectangleGrid.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		A uniform grid spatial index for rectangles.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_RECTANGLEGRID_H
+#define __MYLLY_RECTANGLEGRID_H
+
+#include "stdtypes.h"
+#include "Math/Rectangle.h"
+
+#define RECT_GRID_INVALID	0xFFFFFFFF
+
+// An indexed rectangle. Unused slots are chained into a free list through next.
+typedef struct
+{
+	rectangle_t		rect;
+	void*			data;
+	uint32			stamp;		// Last query that reported this item, used to remove duplicates
+	uint32			next;
+	bool			used;
+} rect_grid_item_t;
+
+// A cell stores the handles of every item overlapping it.
+typedef struct
+{
+	uint32*			items;
+	uint32			count;
+	uint32			capacity;
+} rect_grid_cell_t;
+
+// Rectangles are bucketed into cell_size x cell_size cells covering bounds. Rectangles reaching
+// outside the bounds are kept in the border cells, so they can still be found, just less efficiently.
+typedef struct
+{
+	rect_grid_item_t*	items;
+	uint32				num_items;		// Number of slots in use, including freed ones
+	uint32				max_items;
+	uint32				free_list;
+
+	rect_grid_cell_t*	cells;
+	rectangle_t			bounds;
+	uint32				cell_size;
+	uint32				cols;
+	uint32				rows;
+	uint32				stamp;
+} rect_grid_t;
+
+__BEGIN_DECLS
+
+MYLLY_API bool			rect_grid_create		( rect_grid_t* grid, const rectangle_t* bounds, uint16 cell_size );
+MYLLY_API void			rect_grid_destroy		( rect_grid_t* grid );
+MYLLY_API void			rect_grid_clear			( rect_grid_t* grid );
+
+// Returns a handle to the inserted rectangle or RECT_GRID_INVALID if out of memory.
+MYLLY_API uint32		rect_grid_insert		( rect_grid_t* grid, const rectangle_t* r, void* data );
+MYLLY_API bool			rect_grid_remove		( rect_grid_t* grid, uint32 handle );
+MYLLY_API bool			rect_grid_update		( rect_grid_t* grid, uint32 handle, const rectangle_t* r );
+MYLLY_API void*			rect_grid_get_data		( const rect_grid_t* grid, uint32 handle );
+
+// The queries write up to max_results handles into results and return the total number of hits,
+// which may be larger than max_results. Edges are inclusive like in rect_is_point_in.
+MYLLY_API uint32		rect_grid_query_point	( rect_grid_t* grid, uint16 x, uint16 y, uint32* results, uint32 max_results );
+MYLLY_API uint32		rect_grid_query_rect	( rect_grid_t* grid, const rectangle_t* r, uint32* results, uint32 max_results );
+
+__END_DECLS
+
+#endif /* __MYLLY_RECTANGLEGRID_H */
@@ -0,0 +1,807 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Region.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		A region made of non-overlapping rectangles.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/Region.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define X1(r) ( (int32)(r)->x )
+#define Y1(r) ( (int32)(r)->y )
+#define X2(r) ( (int32)(r)->x + (int32)(r)->uw )
+#define Y2(r) ( (int32)(r)->y + (int32)(r)->uh )
+
+#define MAX(a,b) ( (a) > (b) ? (a) : (b) )
+#define MIN(a,b) ( (a) < (b) ? (a) : (b) )
+
+typedef enum
+{
+	REGION_OP_UNION,
+	REGION_OP_INTERSECT,
+	REGION_OP_SUBTRACT
+} region_op_t;
+
+// --------------------------------------------------
+// Rectangle list helpers
+// --------------------------------------------------
+
+static bool region_reserve( region_t* region, uint32 count )
+{
+	rectangle_t* rects;
+	uint32 capacity;
+
+	if ( count <= region->capacity ) return true;
+
+	capacity = region->capacity ? region->capacity : 8;
+	while ( capacity < count ) capacity *= 2;
+
+	rects = (rectangle_t*)realloc( region->rects, capacity * sizeof( rectangle_t ) );
+	if ( rects == NULL ) return false;
+
+	region->rects = rects;
+	region->capacity = capacity;
+
+	return true;
+}
+
+// Positions and sizes of a rectangle_t have 16 bits, wider ranges can't be stored.
+static MYLLY_INLINE bool region_fits( int32 x1, int32 y1, int32 x2, int32 y2 )
+{
+	return ( x1 >= -32768 && x1 <= 32767 && x2 - x1 <= 65535 &&
+			 y1 >= -32768 && y1 <= 32767 && y2 - y1 <= 65535 );
+}
+
+static MYLLY_INLINE bool region_append( region_t* region, int32 x1, int32 y1, int32 x2, int32 y2 )
+{
+	rectangle_t* r;
+
+	if ( !region_fits( x1, y1, x2, y2 ) ) return false;
+	if ( !region_reserve( region, region->count + 1 ) ) return false;
+
+	r = &region->rects[region->count++];
+	r->x = (int16)x1;
+	r->y = (int16)y1;
+	r->uw = (uint16)( x2 - x1 );
+	r->uh = (uint16)( y2 - y1 );
+
+	return true;
+}
+
+// Returns the end of the band starting at r.
+static MYLLY_INLINE const rectangle_t* region_band_end( const rectangle_t* r, const rectangle_t* end )
+{
+	int32 y = r->y;
+	while ( r < end && r->y == y ) r++;
+	return r;
+}
+
+// Merges the band starting at cur with the previous band if they are identical and touch.
+// Returns the start of the last band.
+static uint32 region_coalesce( region_t* region, uint32 prev, uint32 cur )
+{
+	rectangle_t* rects = region->rects;
+	uint32 i, count = region->count - cur;
+
+	if ( count == 0 ) return prev;
+	if ( prev == cur || cur - prev != count || Y2( &rects[prev] ) != rects[cur].y ) return cur;
+
+	for ( i = 0; i < count; i++ )
+	{
+		if ( rects[prev+i].x != rects[cur+i].x || rects[prev+i].uw != rects[cur+i].uw )
+			return cur;
+	}
+
+	for ( i = 0; i < count; i++ )
+		rects[prev+i].uh = (uint16)( rects[prev+i].uh + rects[cur+i].uh );
+
+	region->count = cur;
+	return prev;
+}
+
+// Returns false if the bounding rectangle is too large to be stored, the extents are left as is then.
+static bool region_update_extents( region_t* region )
+{
+	const rectangle_t* r;
+	int32 x1, x2, y1, y2;
+	uint32 i;
+
+	if ( region->count == 0 )
+	{
+		memset( &region->extents, 0, sizeof( region->extents ) );
+		return true;
+	}
+
+	x1 = X1( &region->rects[0] );
+	x2 = X2( &region->rects[0] );
+
+	for ( i = 1; i < region->count; i++ )
+	{
+		r = &region->rects[i];
+		x1 = MIN( x1, X1( r ) );
+		x2 = MAX( x2, X2( r ) );
+	}
+
+	y1 = Y1( &region->rects[0] );
+	y2 = Y2( &region->rects[region->count-1] );
+
+	if ( !region_fits( x1, y1, x2, y2 ) ) return false;
+
+	region->extents.x = (int16)x1;
+	region->extents.y = (int16)y1;
+	region->extents.uw = (uint16)( x2 - x1 );
+	region->extents.uh = (uint16)( y2 - y1 );
+
+	return true;
+}
+
+// --------------------------------------------------
+// Band operations, each produces the rectangles of a single band spanning [y1, y2)
+// --------------------------------------------------
+
+static bool region_band_copy( region_t* result, const rectangle_t* r, const rectangle_t* end, int32 y1, int32 y2 )
+{
+	for ( ; r < end; r++ )
+	{
+		if ( !region_append( result, X1( r ), y1, X2( r ), y2 ) ) return false;
+	}
+
+	return true;
+}
+
+static bool region_band_union( region_t* result, const rectangle_t* r1, const rectangle_t* end1,
+							   const rectangle_t* r2, const rectangle_t* end2, int32 y1, int32 y2 )
+{
+	const rectangle_t* r;
+	int32 x1, x2;
+
+	// Merge the two sorted span lists, joining spans that overlap or touch.
+	x1 = x2 = 0;
+
+	while ( r1 < end1 || r2 < end2 )
+	{
+		if ( r2 >= end2 || ( r1 < end1 && r1->x < r2->x ) ) r = r1++;
+		else r = r2++;
+
+		if ( x2 > x1 && X1( r ) <= x2 )
+		{
+			x2 = MAX( x2, X2( r ) );
+			continue;
+		}
+
+		if ( x2 > x1 && !region_append( result, x1, y1, x2, y2 ) ) return false;
+
+		x1 = X1( r );
+		x2 = X2( r );
+	}
+
+	if ( x2 > x1 && !region_append( result, x1, y1, x2, y2 ) ) return false;
+
+	return true;
+}
+
+static bool region_band_intersect( region_t* result, const rectangle_t* r1, const rectangle_t* end1,
+								   const rectangle_t* r2, const rectangle_t* end2, int32 y1, int32 y2 )
+{
+	int32 x1, x2;
+
+	while ( r1 < end1 && r2 < end2 )
+	{
+		x1 = MAX( X1( r1 ), X1( r2 ) );
+		x2 = MIN( X2( r1 ), X2( r2 ) );
+
+		if ( x1 < x2 && !region_append( result, x1, y1, x2, y2 ) ) return false;
+
+		// Advance whichever span ends first.
+		if ( X2( r1 ) == x2 ) r1++;
+		if ( X2( r2 ) == x2 ) r2++;
+	}
+
+	return true;
+}
+
+static bool region_band_subtract( region_t* result, const rectangle_t* r1, const rectangle_t* end1,
+								  const rectangle_t* r2, const rectangle_t* end2, int32 y1, int32 y2 )
+{
+	int32 x1;
+
+	for ( ; r1 < end1; r1++ )
+	{
+		x1 = X1( r1 );
+
+		// Skip subtrahends left of the span.
+		while ( r2 < end2 && X2( r2 ) <= x1 ) r2++;
+
+		// Cut the subtrahends out of the span. The last one may reach into the next span so it isn't consumed.
+		while ( r2 < end2 && X1( r2 ) < X2( r1 ) )
+		{
+			if ( X1( r2 ) > x1 && !region_append( result, x1, y1, X1( r2 ), y2 ) ) return false;
+
+			x1 = X2( r2 );
+			if ( x1 >= X2( r1 ) ) break;
+			r2++;
+		}
+
+		if ( x1 < X2( r1 ) && !region_append( result, x1, y1, X2( r1 ), y2 ) ) return false;
+	}
+
+	return true;
+}
+
+// --------------------------------------------------
+// Generic region operation
+// --------------------------------------------------
+
+static bool region_op( region_t* result, const region_t* reg1, const region_t* reg2, region_op_t op )
+{
+	region_t out;
+	const rectangle_t *r1, *r2, *end1, *end2, *band1, *band2;
+	int32 ytop, ybot, top, bot;
+	uint32 prev = 0, cur;
+	bool append1, append2, ok = true;
+
+	// Parts of the first region not in the second one are kept by union and subtract,
+	// parts of the second region not in the first one only by union.
+	append1 = ( op != REGION_OP_INTERSECT );
+	append2 = ( op == REGION_OP_UNION );
+
+	region_init( &out );
+
+	r1 = reg1->rects; end1 = r1 + reg1->count;
+	r2 = reg2->rects; end2 = r2 + reg2->count;
+
+	ybot = MIN( Y1( r1 ), Y1( r2 ) );
+
+	while ( ok && r1 < end1 && r2 < end2 )
+	{
+		band1 = region_band_end( r1, end1 );
+		band2 = region_band_end( r2, end2 );
+
+		// Handle the part of the upper band that doesn't overlap the other region.
+		cur = out.count;
+
+		if ( Y1( r1 ) < Y1( r2 ) )
+		{
+			top = MAX( Y1( r1 ), ybot );
+			bot = MIN( Y2( r1 ), Y1( r2 ) );
+
+			if ( append1 && top < bot ) ok = region_band_copy( &out, r1, band1, top, bot );
+			ytop = Y1( r2 );
+		}
+		else if ( Y1( r2 ) < Y1( r1 ) )
+		{
+			top = MAX( Y1( r2 ), ybot );
+			bot = MIN( Y2( r2 ), Y1( r1 ) );
+
+			if ( append2 && top < bot ) ok = region_band_copy( &out, r2, band2, top, bot );
+			ytop = Y1( r1 );
+		}
+		else
+		{
+			ytop = Y1( r1 );
+		}
+
+		prev = region_coalesce( &out, prev, cur );
+
+		// Then the part where the bands overlap.
+		ybot = MIN( Y2( r1 ), Y2( r2 ) );
+		cur = out.count;
+
+		if ( ok && ybot > ytop )
+		{
+			switch ( op )
+			{
+			case REGION_OP_UNION: ok = region_band_union( &out, r1, band1, r2, band2, ytop, ybot ); break;
+			case REGION_OP_INTERSECT: ok = region_band_intersect( &out, r1, band1, r2, band2, ytop, ybot ); break;
+			case REGION_OP_SUBTRACT: ok = region_band_subtract( &out, r1, band1, r2, band2, ytop, ybot ); break;
+			}
+		}
+
+		prev = region_coalesce( &out, prev, cur );
+
+		if ( Y2( r1 ) == ybot ) r1 = band1;
+		if ( Y2( r2 ) == ybot ) r2 = band2;
+	}
+
+	// Whatever is left of either region no longer overlaps anything.
+	if ( ok && r1 < end1 && append1 )
+	{
+		cur = out.count;
+		band1 = region_band_end( r1, end1 );
+		ok = region_band_copy( &out, r1, band1, MAX( Y1( r1 ), ybot ), Y2( r1 ) );
+		prev = region_coalesce( &out, prev, cur );
+
+		for ( r1 = band1; ok && r1 < end1; r1 = band1 )
+		{
+			cur = out.count;
+			band1 = region_band_end( r1, end1 );
+			ok = region_band_copy( &out, r1, band1, Y1( r1 ), Y2( r1 ) );
+			prev = region_coalesce( &out, prev, cur );
+		}
+	}
+	else if ( ok && r2 < end2 && append2 )
+	{
+		cur = out.count;
+		band2 = region_band_end( r2, end2 );
+		ok = region_band_copy( &out, r2, band2, MAX( Y1( r2 ), ybot ), Y2( r2 ) );
+		prev = region_coalesce( &out, prev, cur );
+
+		for ( r2 = band2; ok && r2 < end2; r2 = band2 )
+		{
+			cur = out.count;
+			band2 = region_band_end( r2, end2 );
+			ok = region_band_copy( &out, r2, band2, Y1( r2 ), Y2( r2 ) );
+			prev = region_coalesce( &out, prev, cur );
+		}
+	}
+
+	if ( ok ) ok = region_update_extents( &out );
+
+	if ( !ok )
+	{
+		region_destroy( &out );
+		return false;
+	}
+
+	region_destroy( result );
+	*result = out;
+
+	return true;
+}
+
+// Wraps a rectangle into a temporary single rectangle region.
+static MYLLY_INLINE void region_from_rect( region_t* region, const rectangle_t* r )
+{
+	region->rects = (rectangle_t*)r;
+	region->count = ( r->uw != 0 && r->uh != 0 ) ? 1 : 0;
+	region->capacity = 0;
+	region->extents = *r;
+}
+
+// --------------------------------------------------
+// Public API
+// --------------------------------------------------
+
+void region_init( region_t* region )
+{
+	memset( region, 0, sizeof( *region ) );
+}
+
+bool region_init_rect( region_t* region, const rectangle_t* r )
+{
+	region_init( region );
+
+	if ( r == NULL || r->uw == 0 || r->uh == 0 ) return true;
+	if ( !region_reserve( region, 1 ) ) return false;
+
+	region->rects[0] = *r;
+	region->count = 1;
+	region->extents = *r;
+
+	return true;
+}
+
+void region_destroy( region_t* region )
+{
+	if ( region == NULL ) return;
+
+	free( region->rects );
+	region_init( region );
+}
+
+void region_clear( region_t* region )
+{
+	if ( region == NULL ) return;
+
+	region->count = 0;
+	memset( &region->extents, 0, sizeof( region->extents ) );
+}
+
+bool region_copy( region_t* result, const region_t* src )
+{
+	if ( result == NULL || src == NULL ) return false;
+	if ( result == src ) return true;
+
+	if ( !region_reserve( result, src->count ) ) return false;
+
+	if ( src->count ) memcpy( result->rects, src->rects, src->count * sizeof( rectangle_t ) );
+	result->count = src->count;
+	result->extents = src->extents;
+
+	return true;
+}
+
+bool region_union( region_t* result, const region_t* r1, const region_t* r2 )
+{
+	if ( result == NULL || r1 == NULL || r2 == NULL ) return false;
+
+	if ( r1->count == 0 ) return region_copy( result, r2 );
+	if ( r2->count == 0 ) return region_copy( result, r1 );
+
+	// If one of the regions is a single rectangle covering the other, the result is that rectangle.
+	if ( r1->count == 1 && rect_is_in( &r1->extents, &r2->extents ) ) return region_copy( result, r1 );
+	if ( r2->count == 1 && rect_is_in( &r2->extents, &r1->extents ) ) return region_copy( result, r2 );
+
+	return region_op( result, r1, r2, REGION_OP_UNION );
+}
+
+bool region_intersect( region_t* result, const region_t* r1, const region_t* r2 )
+{
+	if ( result == NULL || r1 == NULL || r2 == NULL ) return false;
+
+	if ( r1->count == 0 || r2->count == 0 ||
+		 X2( &r1->extents ) <= X1( &r2->extents ) || X2( &r2->extents ) <= X1( &r1->extents ) ||
+		 Y2( &r1->extents ) <= Y1( &r2->extents ) || Y2( &r2->extents ) <= Y1( &r1->extents ) )
+	{
+		region_clear( result );
+		return true;
+	}
+
+	return region_op( result, r1, r2, REGION_OP_INTERSECT );
+}
+
+bool region_subtract( region_t* result, const region_t* r1, const region_t* r2 )
+{
+	if ( result == NULL || r1 == NULL || r2 == NULL ) return false;
+
+	if ( r1->count == 0 || r2->count == 0 ||
+		 X2( &r1->extents ) <= X1( &r2->extents ) || X2( &r2->extents ) <= X1( &r1->extents ) ||
+		 Y2( &r1->extents ) <= Y1( &r2->extents ) || Y2( &r2->extents ) <= Y1( &r1->extents ) )
+	{
+		return region_copy( result, r1 );
+	}
+
+	return region_op( result, r1, r2, REGION_OP_SUBTRACT );
+}
+
+bool region_union_rect( region_t* result, const region_t* region, const rectangle_t* r )
+{
+	region_t tmp;
+
+	if ( r == NULL ) return false;
+
+	region_from_rect( &tmp, r );
+	return region_union( result, region, &tmp );
+}
+
+bool region_intersect_rect( region_t* result, const region_t* region, const rectangle_t* r )
+{
+	region_t tmp;
+
+	if ( r == NULL ) return false;
+
+	region_from_rect( &tmp, r );
+	return region_intersect( result, region, &tmp );
+}
+
+bool region_subtract_rect( region_t* result, const region_t* region, const rectangle_t* r )
+{
+	region_t tmp;
+
+	if ( r == NULL ) return false;
+
+	region_from_rect( &tmp, r );
+	return region_subtract( result, region, &tmp );
+}
+
+bool region_is_empty( const region_t* region )
+{
+	return region == NULL || region->count == 0;
+}
+
+bool region_contains_point( const region_t* region, int16 x, int16 y )
+{
+	const rectangle_t* r;
+	uint32 i;
+
+	if ( region == NULL || region->count == 0 ) return false;
+
+	if ( x < X1( &region->extents ) || x >= X2( &region->extents ) ||
+		 y < Y1( &region->extents ) || y >= Y2( &region->extents ) )
+		return false;
+
+	for ( i = 0; i < region->count; i++ )
+	{
+		r = &region->rects[i];
+
+		if ( y >= Y2( r ) ) continue;	// Band above the point
+		if ( y < Y1( r ) ) break;		// Past the point, the rectangles are sorted by y
+		if ( x < X1( r ) ) break;		// Past the point within the band
+		if ( x < X2( r ) ) return true;
+	}
+
+	return false;
+}
+
+uint32 region_test_rect( const region_t* region, const rectangle_t* rect )
+{
+	const rectangle_t *r, *end;
+	int32 x, y, rx1, ry1, rx2, ry2;
+	bool part_in = false, part_out = false;
+
+	if ( region == NULL || rect == NULL || region->count == 0 || rect->uw == 0 || rect->uh == 0 )
+		return REGION_OUT;
+
+	rx1 = X1( rect ); ry1 = Y1( rect );
+	rx2 = X2( rect ); ry2 = Y2( rect );
+
+	if ( X2( &region->extents ) <= rx1 || rx2 <= X1( &region->extents ) ||
+		 Y2( &region->extents ) <= ry1 || ry2 <= Y1( &region->extents ) )
+		return REGION_OUT;
+
+	// Walk the region from the top left corner of the rectangle, x and y track the part not yet
+	// known to be covered.
+	x = rx1;
+	y = ry1;
+
+	for ( r = region->rects, end = r + region->count; r < end && y < ry2; r++ )
+	{
+		if ( Y2( r ) <= y ) continue;	// Band above the rectangle
+
+		if ( Y1( r ) > y )
+		{
+			// Gap above the band.
+			part_out = true;
+			if ( part_in || Y1( r ) >= ry2 ) break;
+			y = Y1( r );
+		}
+
+		if ( X2( r ) <= x ) continue;	// Left of the rectangle
+
+		if ( X1( r ) > x )
+		{
+			// Gap before the span.
+			part_out = true;
+			if ( part_in ) break;
+		}
+
+		if ( X1( r ) < rx2 )
+		{
+			part_in = true;
+			if ( part_out ) break;
+		}
+
+		if ( X2( r ) >= rx2 )
+		{
+			// The band covers the rest of the row, move down to the next band.
+			y = Y2( r );
+			if ( y >= ry2 ) break;
+			x = rx1;
+		}
+		else
+		{
+			// Gap after the span.
+			part_out = true;
+			break;
+		}
+	}
+
+	if ( !part_in ) return REGION_OUT;
+
+	return ( part_out || y < ry2 ) ? REGION_PARTIAL : REGION_IN;
+}
+
+// --------------------------------------------------
+// Simplification helpers
+// --------------------------------------------------
+
+static uint32 region_band_area( const rectangle_t* r, const rectangle_t* end )
+{
+	uint32 area = 0;
+
+	for ( ; r < end; r++ )
+		area += (uint32)r->uw * r->uh;
+
+	return area;
+}
+
+// Total width covered by the rectangles of two bands when they are put on top of each other.
+static uint32 region_band_width( const rectangle_t* r1, const rectangle_t* end1, const rectangle_t* r2, const rectangle_t* end2 )
+{
+	const rectangle_t* r;
+	uint32 width = 0;
+	int32 x1 = 0, x2 = 0;
+	bool first = true;
+
+	while ( r1 < end1 || r2 < end2 )
+	{
+		if ( r2 == end2 || ( r1 < end1 && r1->x < r2->x ) ) r = r1++;
+		else r = r2++;
+
+		if ( first || X1( r ) > x2 )
+		{
+			width += (uint32)( x2 - x1 );
+			x1 = X1( r );
+			x2 = X2( r );
+			first = false;
+		}
+		else
+		{
+			x2 = MAX( x2, X2( r ) );
+		}
+	}
+
+	return width + (uint32)( x2 - x1 );
+}
+
+// Finds the horizontally closest pair of rectangles from two bands and returns the gap between
+// them, 0 if some rectangles overlap or touch. Whichever rectangle ends first can't be closer to
+// anything further along the other band, so only that one is advanced.
+static int32 region_band_gap( const rectangle_t* r1, const rectangle_t* end1, const rectangle_t* r2, const rectangle_t* end2,
+							  const rectangle_t** a, const rectangle_t** b )
+{
+	int32 gap, best = -1;
+
+	while ( r1 < end1 && r2 < end2 )
+	{
+		gap = MAX( 0, MAX( X1( r1 ), X1( r2 ) ) - MIN( X2( r1 ), X2( r2 ) ) );
+
+		if ( best < 0 || gap < best )
+		{
+			best = gap;
+			*a = r1;
+			*b = r2;
+		}
+
+		if ( X2( r1 ) < X2( r2 ) ) r1++;
+		else r2++;
+	}
+
+	return best;
+}
+
+// Joins the rectangle at index i with the one after it in the same band.
+static void region_merge_neighbours( region_t* region, uint32 i )
+{
+	rectangle_t* rects = region->rects;
+
+	rects[i].uw = (uint16)( X2( &rects[i+1] ) - X1( &rects[i] ) );
+
+	memmove( &rects[i+1], &rects[i+2], ( region->count - i - 2 ) * sizeof( rectangle_t ) );
+	region->count--;
+}
+
+// Turns the bands [first, second) and [second, end) into a single band spanning both. The
+// rectangle at index a is stretched over the one at index b, after which rectangles that overlap
+// or touch are combined.
+static void region_merge_bands( region_t* region, uint32 first, uint32 second, uint32 end, uint32 a, uint32 b )
+{
+	rectangle_t* rects = region->rects;
+	rectangle_t tmp;
+	int32 x1, x2, y1 = rects[first].y, h = Y2( &rects[second] ) - rects[first].y;
+	uint32 i, j, w;
+
+	x1 = MIN( X1( &rects[a] ), X1( &rects[b] ) );
+	x2 = MAX( X2( &rects[a] ), X2( &rects[b] ) );
+
+	rects[a].x = (int16)x1;
+	rects[a].uw = (uint16)( x2 - x1 );
+
+	for ( i = first; i < end; i++ )
+	{
+		rects[i].y = (int16)y1;
+		rects[i].uh = (uint16)h;
+	}
+
+	// Both halves are already sorted and usually short.
+	for ( i = second; i < end; i++ )
+	{
+		tmp = rects[i];
+		for ( j = i; j > first && rects[j-1].x > tmp.x; j-- )
+			rects[j] = rects[j-1];
+		rects[j] = tmp;
+	}
+
+	for ( w = first, i = first + 1; i < end; i++ )
+	{
+		if ( X1( &rects[i] ) <= X2( &rects[w] ) )
+		{
+			x2 = MAX( X2( &rects[w] ), X2( &rects[i] ) );
+			rects[w].uw = (uint16)( x2 - X1( &rects[w] ) );
+		}
+		else
+		{
+			rects[++w] = rects[i];
+		}
+	}
+
+	w++;
+	memmove( &rects[w], &rects[end], ( region->count - end ) * sizeof( rectangle_t ) );
+	region->count -= end - w;
+}
+
+// Merges every band with the one above it when they are identical and touch.
+static void region_coalesce_all( region_t* region )
+{
+	rectangle_t* rects = region->rects;
+	const rectangle_t *band, *next, *end = rects + region->count;
+	uint32 prev = 0, cur;
+
+	region->count = 0;
+
+	for ( band = rects; band < end; band = next )
+	{
+		next = region_band_end( band, end );
+		cur = region->count;
+
+		memmove( &rects[cur], band, ( next - band ) * sizeof( rectangle_t ) );
+		region->count += (uint32)( next - band );
+
+		prev = region_coalesce( region, prev, cur );
+	}
+}
+
+void region_simplify( region_t* region, uint32 max_rects )
+{
+	const rectangle_t *rects, *end, *band, *next, *next_end, *r, *a, *b, *best_a, *best_b;
+	uint32 cost, best_cost, best_first, best_second, best_end;
+	int32 gap;
+
+	if ( region == NULL || region->count <= max_rects ) return;
+	if ( max_rects == 0 ) max_rects = 1;
+
+	// Merge the pair of rectangles that adds the least area until there are few enough. A pair is
+	// either two neighbours in a band or the closest rectangles of two vertically adjacent bands.
+	// A rectangle can't be taller than the rest of its band, so the latter merges the whole bands.
+	while ( region->count > max_rects )
+	{
+		rects = region->rects;
+		end = rects + region->count;
+
+		a = b = best_a = best_b = NULL;
+		best_cost = 0;
+		best_first = best_second = best_end = 0;
+
+		for ( band = rects; band < end; band = next )
+		{
+			next = region_band_end( band, end );
+
+			for ( r = band; r + 1 < next; r++ )
+			{
+				cost = (uint32)( X1( r + 1 ) - X2( r ) ) * r->uh;
+
+				if ( best_a == NULL || cost < best_cost )
+				{
+					best_cost = cost;
+					best_a = r;
+					best_b = r + 1;
+				}
+			}
+
+			if ( next == end ) break;
+
+			next_end = region_band_end( next, end );
+			gap = region_band_gap( band, next, next, next_end, &a, &b );
+
+			cost = (uint32)( Y2( next ) - Y1( band ) ) * ( region_band_width( band, next, next, next_end ) + (uint32)gap ) -
+				   region_band_area( band, next ) - region_band_area( next, next_end );
+
+			if ( best_a == NULL || cost < best_cost )
+			{
+				best_cost = cost;
+				best_a = a;
+				best_b = b;
+				best_first = (uint32)( band - rects );
+				best_second = (uint32)( next - rects );
+				best_end = (uint32)( next_end - rects );
+			}
+		}
+
+		if ( best_a->y == best_b->y )
+			region_merge_neighbours( region, (uint32)( best_a - rects ) );
+		else
+			region_merge_bands( region, best_first, best_second, best_end, (uint32)( best_a - rects ), (uint32)( best_b - rects ) );
+
+		// The merged band may now match the one above or below it.
+		region_coalesce_all( region );
+	}
+
+	// The merged rectangles stay inside the old extents, so these always fit.
+	region_update_extents( region );
+}
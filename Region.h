@@ -0,0 +1,69 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Region.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		A region made of non-overlapping rectangles.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_REGION_H
+#define __MYLLY_REGION_H
+
+#include "stdtypes.h"
+#include "Math/Rectangle.h"
+
+// The rectangles are stored as y-x banded lists: they are sorted top to bottom and left to right,
+// every rectangle in a band has the same y and h, rectangles never overlap or touch horizontally
+// and identical vertically adjacent bands are coalesced. Unlike rect_is_point_in, regions cover
+// the area [x, x + w) x [y, y + h), so rectangles with zero width or height are empty.
+typedef struct
+{
+	rectangle_t*	rects;
+	uint32			count;
+	uint32			capacity;
+	rectangle_t		extents;	// Bounding rectangle of the region, all zero when empty
+} region_t;
+
+// Return values of region_test_rect
+enum
+{
+	REGION_OUT,		// The rectangle is not in the region
+	REGION_IN,		// The rectangle is entirely in the region
+	REGION_PARTIAL	// The rectangle is partially in the region
+};
+
+__BEGIN_DECLS
+
+MYLLY_API void			region_init				( region_t* region );
+MYLLY_API bool			region_init_rect		( region_t* region, const rectangle_t* r );
+MYLLY_API void			region_destroy			( region_t* region );
+MYLLY_API void			region_clear			( region_t* region );
+MYLLY_API bool			region_copy				( region_t* result, const region_t* src );
+
+// The result may be one of the sources. On failure the result is left unchanged, the operations fail
+// when out of memory or when a rectangle of the result would not fit in a rectangle_t (a union of
+// rectangles far apart can be wider than 65535).
+MYLLY_API bool			region_union			( region_t* result, const region_t* r1, const region_t* r2 );
+MYLLY_API bool			region_intersect		( region_t* result, const region_t* r1, const region_t* r2 );
+MYLLY_API bool			region_subtract			( region_t* result, const region_t* r1, const region_t* r2 );
+MYLLY_API bool			region_union_rect		( region_t* result, const region_t* region, const rectangle_t* r );
+MYLLY_API bool			region_intersect_rect	( region_t* result, const region_t* region, const rectangle_t* r );
+MYLLY_API bool			region_subtract_rect	( region_t* result, const region_t* region, const rectangle_t* r );
+
+MYLLY_API bool			region_is_empty			( const region_t* region );
+MYLLY_API bool			region_contains_point	( const region_t* region, int16 x, int16 y );
+MYLLY_API uint32		region_test_rect		( const region_t* region, const rectangle_t* r );
+
+// Merges rectangles until there are at most max_rects left, the region can only grow. Every step
+// makes the merge that adds the least area: two neighbours in a band, or the closest rectangles of
+// two vertically adjacent bands which turns the bands into one. Stops as soon as the count is low
+// enough. Useful for keeping dirty regions cheap to redraw.
+MYLLY_API void			region_simplify			( region_t* region, uint32 max_rects );
+
+__END_DECLS
+
+#endif /* __MYLLY_REGION_H */
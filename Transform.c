@@ -0,0 +1,253 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Transform.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Transform hierarchy with cached world matrices.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/Transform.h"
+#include "Math/MathSimd.h"
+#include <string.h>
+
+#define TRANSFORM_ALIGNMENT 16
+
+// Moves count elements into a newly allocated array of capacity elements.
+static bool transform_grow( void** ptr, uint32 count, uint32 capacity, size_t size )
+{
+	void* data = math_aligned_alloc( capacity * size, TRANSFORM_ALIGNMENT );
+
+	if ( data == NULL ) return false;
+
+	if ( *ptr != NULL )
+	{
+		memcpy( data, *ptr, count * size );
+		math_aligned_free( *ptr );
+	}
+
+	*ptr = data;
+	return true;
+}
+
+static bool transform_tree_reserve( transform_tree_t* tree, uint32 capacity )
+{
+	bool ok;
+
+	if ( capacity <= tree->capacity ) return true;
+
+	// The arrays that were grown before a failure are simply larger than needed.
+	ok = transform_grow( (void**)&tree->position, tree->count, capacity, sizeof( vector3_t ) ) &&
+		 transform_grow( (void**)&tree->rotation, tree->count, capacity, sizeof( quaternion_t ) ) &&
+		 transform_grow( (void**)&tree->scale, tree->count, capacity, sizeof( vector3_t ) ) &&
+		 transform_grow( (void**)&tree->parent, tree->count, capacity, sizeof( uint32 ) ) &&
+		 transform_grow( (void**)&tree->first_child, tree->count, capacity, sizeof( uint32 ) ) &&
+		 transform_grow( (void**)&tree->next_sibling, tree->count, capacity, sizeof( uint32 ) ) &&
+		 transform_grow( (void**)&tree->world, tree->count, capacity, sizeof( matrix4_t ) ) &&
+		 transform_grow( (void**)&tree->dirty, tree->count, capacity, sizeof( uint8 ) ) &&
+		 transform_grow( (void**)&tree->dirty_nodes, tree->dirty_count, capacity, sizeof( uint32 ) );
+
+	if ( ok ) tree->capacity = capacity;
+	return ok;
+}
+
+// Every node is in the dirty list at most once, so the list never needs more than capacity entries.
+static MYLLY_INLINE void transform_tree_mark( transform_tree_t* tree, uint32 node )
+{
+	if ( tree->dirty[node] ) return;
+
+	tree->dirty[node] = 1;
+	tree->dirty_nodes[tree->dirty_count++] = node;
+}
+
+// Builds scale * rotation * translation.
+static void transform_local_matrix( matrix4_t* result, const vector3_t* position, const quaternion_t* rotation, const vector3_t* scale )
+{
+	quaternion_to_matrix4( result, rotation );
+
+	result->_11 *= scale->x; result->_12 *= scale->x; result->_13 *= scale->x;
+	result->_21 *= scale->y; result->_22 *= scale->y; result->_23 *= scale->y;
+	result->_31 *= scale->z; result->_32 *= scale->z; result->_33 *= scale->z;
+
+	result->_41 = position->x;
+	result->_42 = position->y;
+	result->_43 = position->z;
+}
+
+bool transform_tree_create( transform_tree_t* tree, uint32 capacity )
+{
+	if ( tree == NULL ) return false;
+
+	memset( tree, 0, sizeof( *tree ) );
+
+	if ( capacity == 0 ) return true;
+	if ( transform_tree_reserve( tree, capacity ) ) return true;
+
+	transform_tree_destroy( tree );
+	return false;
+}
+
+void transform_tree_destroy( transform_tree_t* tree )
+{
+	if ( tree == NULL ) return;
+
+	math_aligned_free( tree->position );
+	math_aligned_free( tree->rotation );
+	math_aligned_free( tree->scale );
+	math_aligned_free( tree->parent );
+	math_aligned_free( tree->first_child );
+	math_aligned_free( tree->next_sibling );
+	math_aligned_free( tree->world );
+	math_aligned_free( tree->dirty );
+	math_aligned_free( tree->dirty_nodes );
+
+	memset( tree, 0, sizeof( *tree ) );
+}
+
+void transform_tree_clear( transform_tree_t* tree )
+{
+	if ( tree == NULL ) return;
+
+	tree->count = 0;
+	tree->dirty_count = 0;
+}
+
+uint32 transform_tree_add( transform_tree_t* tree, uint32 parent )
+{
+	uint32 node;
+
+	if ( tree == NULL ) return TRANSFORM_INVALID;
+	if ( parent != TRANSFORM_NO_PARENT && parent >= tree->count ) return TRANSFORM_INVALID;
+
+	if ( tree->count == tree->capacity &&
+		 !transform_tree_reserve( tree, tree->capacity ? tree->capacity * 2 : 64 ) )
+		return TRANSFORM_INVALID;
+
+	node = tree->count++;
+
+	tree->position[node].x = tree->position[node].y = tree->position[node].z = 0.0f;
+	tree->scale[node].x = tree->scale[node].y = tree->scale[node].z = 1.0f;
+	quaternion_identity( &tree->rotation[node] );
+	matrix4_identity( &tree->world[node] );
+
+	tree->parent[node] = parent;
+	tree->first_child[node] = TRANSFORM_INVALID;
+	tree->next_sibling[node] = TRANSFORM_INVALID;
+	tree->dirty[node] = 0;
+
+	// A new node inherits its parent's world transform.
+	if ( parent != TRANSFORM_NO_PARENT )
+	{
+		tree->next_sibling[node] = tree->first_child[parent];
+		tree->first_child[parent] = node;
+
+		transform_tree_mark( tree, node );
+	}
+
+	return node;
+}
+
+void transform_tree_set_position( transform_tree_t* tree, uint32 node, const vector3_t* position )
+{
+	transform_tree_set_local( tree, node, position, NULL, NULL );
+}
+
+void transform_tree_set_rotation( transform_tree_t* tree, uint32 node, const quaternion_t* rotation )
+{
+	transform_tree_set_local( tree, node, NULL, rotation, NULL );
+}
+
+void transform_tree_set_scale( transform_tree_t* tree, uint32 node, const vector3_t* scale )
+{
+	transform_tree_set_local( tree, node, NULL, NULL, scale );
+}
+
+void transform_tree_set_local( transform_tree_t* tree, uint32 node, const vector3_t* position, const quaternion_t* rotation, const vector3_t* scale )
+{
+	if ( tree == NULL || node >= tree->count ) return;
+
+	if ( position != NULL ) tree->position[node] = *position;
+	if ( rotation != NULL ) tree->rotation[node] = *rotation;
+	if ( scale != NULL ) tree->scale[node] = *scale;
+
+	transform_tree_mark( tree, node );
+}
+
+// Recomputes the world matrices of a node and all of its descendants in depth first order, which
+// visits parents before their children. Returns the number of matrices updated.
+static uint32 transform_tree_update_subtree( transform_tree_t* tree, uint32 root )
+{
+	matrix4_t local;
+	uint32 node = root, parent, updated = 0;
+
+	for ( ;; )
+	{
+		parent = tree->parent[node];
+
+		if ( parent == TRANSFORM_NO_PARENT )
+		{
+			transform_local_matrix( &tree->world[node], &tree->position[node], &tree->rotation[node], &tree->scale[node] );
+		}
+		else
+		{
+			transform_local_matrix( &local, &tree->position[node], &tree->rotation[node], &tree->scale[node] );
+			matrix4_multiply( &tree->world[node], &local, &tree->world[parent] );
+		}
+
+		tree->dirty[node] = 0;
+		updated++;
+
+		if ( tree->first_child[node] != TRANSFORM_INVALID )
+		{
+			node = tree->first_child[node];
+			continue;
+		}
+
+		while ( node != root && tree->next_sibling[node] == TRANSFORM_INVALID )
+			node = tree->parent[node];
+
+		if ( node == root ) break;
+		node = tree->next_sibling[node];
+	}
+
+	return updated;
+}
+
+uint32 transform_tree_update( transform_tree_t* tree )
+{
+	uint32 i, node, parent, roots = 0, updated = 0;
+	uint32* nodes;
+
+	if ( tree == NULL || tree->dirty_count == 0 ) return 0;
+
+	nodes = tree->dirty_nodes;
+
+	// Nodes with a dirty ancestor are updated along with the ancestor's subtree, keep only the rest.
+	// The subtrees left are disjoint and everything above them is up to date, so any order works.
+	for ( i = 0; i < tree->dirty_count; i++ )
+	{
+		node = nodes[i];
+
+		for ( parent = tree->parent[node]; parent != TRANSFORM_NO_PARENT; parent = tree->parent[parent] )
+		{
+			if ( tree->dirty[parent] ) break;
+		}
+
+		if ( parent == TRANSFORM_NO_PARENT ) nodes[roots++] = node;
+	}
+
+	for ( i = 0; i < roots; i++ )
+		updated += transform_tree_update_subtree( tree, nodes[i] );
+
+	tree->dirty_count = 0;
+
+	return updated;
+}
+
+const matrix4_t* transform_tree_world( const transform_tree_t* tree, uint32 node )
+{
+	if ( tree == NULL || node >= tree->count ) return NULL;
+	return &tree->world[node];
+}
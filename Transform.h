@@ -0,0 +1,68 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Transform.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Transform hierarchy with cached world matrices.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_TRANSFORM_H
+#define __MYLLY_TRANSFORM_H
+
+#include "stdtypes.h"
+#include "Math/Matrix4.h"
+#include "Math/Quaternion.h"
+#include "Math/Vector3.h"
+
+#define TRANSFORM_NO_PARENT	0xFFFFFFFF
+#define TRANSFORM_INVALID	0xFFFFFFFF
+
+// Nodes are stored in flat arrays. A node can only be added after its parent, and every node links
+// to its first child and next sibling. The local transform is scale, then rotation, then translation.
+// World matrices are only recomputed for nodes whose local transform or one of whose ancestors
+// changed since the last update. Changed nodes are collected into a list and the update only walks
+// their subtrees, so it costs time in proportion to the number of matrices updated (plus the depth
+// of each changed node) rather than the size of the tree.
+typedef struct
+{
+	vector3_t*		position;
+	quaternion_t*	rotation;
+	vector3_t*		scale;
+	uint32*			parent;
+	uint32*			first_child;	// TRANSFORM_INVALID for leaves
+	uint32*			next_sibling;	// TRANSFORM_INVALID for the last child
+	matrix4_t*		world;			// World matrices for every node, valid after transform_tree_update
+	uint8*			dirty;
+	uint32*			dirty_nodes;	// Nodes changed since the last update, in the order they changed
+
+	uint32			count;
+	uint32			capacity;
+	uint32			dirty_count;
+} transform_tree_t;
+
+__BEGIN_DECLS
+
+MYLLY_API bool			transform_tree_create		( transform_tree_t* tree, uint32 capacity );
+MYLLY_API void			transform_tree_destroy		( transform_tree_t* tree );
+MYLLY_API void			transform_tree_clear		( transform_tree_t* tree );
+
+// Adds a node with an identity local transform. Returns the node index or TRANSFORM_INVALID if the
+// parent doesn't exist or we ran out of memory.
+MYLLY_API uint32		transform_tree_add			( transform_tree_t* tree, uint32 parent );
+
+MYLLY_API void			transform_tree_set_position	( transform_tree_t* tree, uint32 node, const vector3_t* position );
+MYLLY_API void			transform_tree_set_rotation	( transform_tree_t* tree, uint32 node, const quaternion_t* rotation );
+MYLLY_API void			transform_tree_set_scale	( transform_tree_t* tree, uint32 node, const vector3_t* scale );
+MYLLY_API void			transform_tree_set_local	( transform_tree_t* tree, uint32 node, const vector3_t* position, const quaternion_t* rotation, const vector3_t* scale );
+
+// Recomputes the world matrices of dirty nodes and their descendants. Returns the number of matrices updated.
+MYLLY_API uint32		transform_tree_update		( transform_tree_t* tree );
+MYLLY_API const matrix4_t*	transform_tree_world	( const transform_tree_t* tree, uint32 node );
+
+__END_DECLS
+
+#endif /* __MYLLY_TRANSFORM_H */
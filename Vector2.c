@@ -9,99 +9,136 @@
  *
  **********************************************************************/
 
+// Always build the out-of-line versions into the library, see MathInline.h
+#define MYLLY_MATH_BUILD
+
 #include "Math/Vector2.h"
-#include <math.h>
+#include "Math/Vector2.inl"
+#include "Math/MathSimd.h"
+#include <string.h>
 
-#define VECTOR2_EPSILON 0.001f
+#if defined(MYLLY_MATH_SSE2) || defined(MYLLY_MATH_NEON)
 
-void vector2_add( vector2_t* result, const vector2_t* v1, const vector2_t* v2 )
+// Normalizes four packed vectors, see vector3_normalize4. The eight floats are two loads and the
+// scale factors are spread over them in pairs.
+static MYLLY_INLINE void vector2_normalize4( vector2_t* result, const vector2_t* v, bool fast )
 {
-	result->x = v1->x + v2->x;
-	result->y = v1->y + v2->y;
+	simd4f x, y, sq, factor, keep, one = simd4f_set1( 1.0f );
+	float f[4];
+	const float* src = v->coords;
+	float* dst = result->coords;
+
+	x = simd4f_set( v[0].x, v[1].x, v[2].x, v[3].x );
+	y = simd4f_set( v[0].y, v[1].y, v[2].y, v[3].y );
+
+	sq = simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) );
+
+	if ( fast )
+	{
+		keep = simd4f_cmplt( sq, simd4f_set1( VECTOR2_EPSILON * VECTOR2_EPSILON ) );
+		simd4f_storeu( f, simd4f_select( keep, one, simd4f_rsqrt( sq ) ) );
+
+		x = simd4f_mul( simd4f_loadu( src ), simd4f_set( f[0], f[0], f[1], f[1] ) );
+		y = simd4f_mul( simd4f_loadu( src + 4 ), simd4f_set( f[2], f[2], f[3], f[3] ) );
+	}
+	else
+	{
+		factor = simd4f_sqrt( sq );
+		keep = simd4f_cmplt( factor, simd4f_set1( VECTOR2_EPSILON ) );
+		simd4f_storeu( f, simd4f_select( keep, one, factor ) );
+
+		x = simd4f_div( simd4f_loadu( src ), simd4f_set( f[0], f[0], f[1], f[1] ) );
+		y = simd4f_div( simd4f_loadu( src + 4 ), simd4f_set( f[2], f[2], f[3], f[3] ) );
+	}
+
+	simd4f_storeu( dst, x );
+	simd4f_storeu( dst + 4, y );
 }
 
-void vector2_subtract( vector2_t* result, const vector2_t* v1, const vector2_t* v2 )
+static void vector2_normalize_array_internal( vector2_t* result, const vector2_t* vectors, uint32 count, bool fast )
 {
-	result->x = v1->x - v2->x;
-	result->y = v1->y - v2->y;
-}
+	vector2_t tmp[4];
+	uint32 i, n;
 
-void vector2_multiply( vector2_t* result, const vector2_t* v, float value )
-{
-	result->x = v->x * value;
-	result->y = v->y * value;
-}
+	if ( result == NULL || vectors == NULL ) return;
 
-void vector2_divide( vector2_t* result, const vector2_t* v, float value )
-{
-	result->x = v->x / value;
-	result->y = v->y / value;
-}
+	for ( i = 0; i + 4 <= count; i += 4 )
+		vector2_normalize4( &result[i], &vectors[i], fast );
 
-void vector2_add_scalar( vector2_t* result, const vector2_t* v, float value )
-{
-	result->x = v->x + value;
-	result->y = v->y + value;
-}
+	if ( i < count )
+	{
+		n = count - i;
+		memset( tmp, 0, sizeof( tmp ) );
+		memcpy( tmp, &vectors[i], n * sizeof( vector2_t ) );
 
-void vector2_subtract_scalar( vector2_t* result, const vector2_t* v, float value )
-{
-	result->x = v->x - value;
-	result->y = v->y - value;
+		vector2_normalize4( tmp, tmp, fast );
+		memcpy( &result[i], tmp, n * sizeof( vector2_t ) );
+	}
 }
 
-float vector2_dot( const vector2_t* v1, const vector2_t* v2 )
-{
-	return v1->x*v2->x + v1->y*v2->y;
-}
+#else
 
-float vector2_angle( const vector2_t* v1, const vector2_t* v2 )
+// Without a vector unit the vectors are normalized one at a time, see vector3_normalize_array_internal.
+static void vector2_normalize_array_internal( vector2_t* result, const vector2_t* vectors, uint32 count, bool fast )
 {
-	return acosf( vector2_dot( v1, v2 ) / vector2_length( v1 ) / vector2_length( v2 ) );
+	vector2_t* v;
+	float sq, factor;
+	uint32 i;
+
+	if ( result == NULL || vectors == NULL ) return;
+
+	for ( i = 0; i < count; i++ )
+	{
+		v = &result[i];
+		*v = vectors[i];
+
+		if ( !fast )
+		{
+			vector2_normalize( v );
+			continue;
+		}
+
+		sq = v->x*v->x + v->y*v->y;
+
+		if ( sq >= VECTOR2_EPSILON * VECTOR2_EPSILON )
+		{
+			factor = 1.0f / sqrtf( sq );
+			v->x *= factor;
+			v->y *= factor;
+		}
+	}
 }
 
-float vector2_length( const vector2_t* v )
-{
-	return sqrtf( v->x*v->x + v->y*v->y );
-}
+#endif
 
-float vector2_length_sq( const vector2_t* v )
+void vector2_normalize_array( vector2_t* result, const vector2_t* vectors, uint32 count )
 {
-	return v->x*v->x + v->y*v->y;
+	vector2_normalize_array_internal( result, vectors, count, false );
 }
 
-float vector2_distance( const vector2_t* v1, const vector2_t* v2 )
+void vector2_normalize_array_fast( vector2_t* result, const vector2_t* vectors, uint32 count )
 {
-	float x, y;
-
-	x = v2->x - v1->x;
-	y = v2->y - v1->y;
-
-	return sqrtf( x*x + y*y );
+	vector2_normalize_array_internal( result, vectors, count, true );
 }
 
-float vector2_distance_sq( const vector2_t* v1, const vector2_t* v2 )
+void vector2_length_array( float* result, const vector2_t* vectors, uint32 count )
 {
-	float x, y;
+	const vector2_t* v;
+	simd4f x, y;
+	uint32 i = 0;
 
-	x = v2->x - v1->x;
-	y = v2->y - v1->y;
+	if ( result == NULL || vectors == NULL ) return;
 
-	return x*x + y*y;
-}
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		v = &vectors[i];
 
-void vector2_normalize( vector2_t* v )
-{
-	float factor = sqrtf( v->x*v->x + v->y*v->y );
+		x = simd4f_set( v[0].x, v[1].x, v[2].x, v[3].x );
+		y = simd4f_set( v[0].y, v[1].y, v[2].y, v[3].y );
 
-	if ( factor < VECTOR2_EPSILON ) return;
+		simd4f_storeu( &result[i], simd4f_sqrt( simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) ) ) );
+	}
 
-	v->x /= factor;
-	v->y /= factor;
-}
-
-void vector2_lerp( vector2_t* result, const vector2_t* v1, const vector2_t* v2, float t )
-{
-	result->x = v1->x + ( v2->x - v1->x ) * t;
-	result->y = v1->y + ( v2->y - v1->y ) * t;
+	for ( ; i < count; i++ )
+		result[i] = vector2_length( &vectors[i] );
 }
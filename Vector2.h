@@ -14,6 +14,7 @@
 #define __MYLLY_VECTOR2_H
 
 #include "stdtypes.h"
+#include "Math/MathInline.h"
 
 #ifdef __cplusplus
 
@@ -48,6 +49,8 @@ typedef vector2_t Vector2;
 
 __BEGIN_DECLS
 
+#ifndef MYLLY_MATH_USE_INLINE
+
 MYLLY_API void			vector2_add				( vector2_t* result, const vector2_t* v1, const vector2_t* v2 );
 MYLLY_API void			vector2_subtract		( vector2_t* result, const vector2_t* v1, const vector2_t* v2 );
 MYLLY_API void			vector2_multiply		( vector2_t* result, const vector2_t* v, float value );
@@ -66,6 +69,17 @@ MYLLY_API void			vector2_normalize		( vector2_t* v );
 
 MYLLY_API void			vector2_lerp			( vector2_t* result, const vector2_t* v1, const vector2_t* v2, float t );
 
+#endif
+
+// Array versions of vector2_length and vector2_normalize, see vector3_normalize_array.
+MYLLY_API void			vector2_length_array		( float* result, const vector2_t* vectors, uint32 count );
+MYLLY_API void			vector2_normalize_array		( vector2_t* result, const vector2_t* vectors, uint32 count );
+MYLLY_API void			vector2_normalize_array_fast	( vector2_t* result, const vector2_t* vectors, uint32 count );
+
 __END_DECLS
 
+#ifdef MYLLY_MATH_USE_INLINE
+#include "Math/Vector2.inl"
+#endif
+
 #endif /* __MYLLY_VECTOR2_H */
@@ -9,145 +9,232 @@
  *
  **********************************************************************/
 
-#include "Math/Vector3.h"
-#include <math.h>
+// Always build the out-of-line versions into the library, see MathInline.h
+#define MYLLY_MATH_BUILD
 
-const float VECTOR3_EPSILON	= 0.001f;
-const float VECTOR3_ERROR	= 0.000001f;
+#include "Math/Vector3.h"
+#include "Math/Vector3.inl"
+#include "Math/MathSimd.h"
+#include <string.h>
 
-void vector3_add( vector3_t* result, const vector3_t* v1, const vector3_t* v2 )
+void vector3_transform_coord( vector3_t* result, const vector3_t* point, const matrix4_t* mat )
 {
-	result->x = v1->x + v2->x;
-	result->y = v1->y + v2->y;
-	result->z = v1->z + v2->z;
-}
+	float norm;
 
-void vector3_subtract( vector3_t* result, const vector3_t* v1, const vector3_t* v2 )
-{
-	result->x = v1->x - v2->x;
-	result->y = v1->y - v2->y;
-	result->z = v1->z - v2->z;
-}
+	norm = mat->_14 * point->x + mat->_24 * point->y + mat->_34 * point->z + mat->_44;
 
-void vector3_multiply( vector3_t* result, const vector3_t* v, float value )
-{
-	result->x = v->x * value;
-	result->y = v->y * value;
-	result->z = v->z * value;
+	result->x = ( mat->_11 * point->x + mat->_21 * point->y + mat->_31 * point->z + mat->_41 ) / norm;
+	result->y = ( mat->_12 * point->x + mat->_22 * point->y + mat->_32 * point->z + mat->_42 ) / norm;
+	result->z = ( mat->_13 * point->x + mat->_23 * point->y + mat->_33 * point->z + mat->_43 ) / norm;
 }
 
-void vector3_divide( vector3_t* result, const vector3_t* v, float value )
+// Transforms count points which are stride bytes apart in both the source and the destination array
+// (0 for tightly packed vectors). Four points are handled per step. When the last column of the
+// matrix is (0,0,0,1) the perspective divide is skipped, which gives the same result as dividing by 1.
+// Without a vector unit the points are transformed one at a time, gathering them into the emulated
+// vectors would only make it slower.
+void vector3_transform_coord_array( vector3_t* result, const vector3_t* points, uint32 count, uint32 stride, const matrix4_t* mat )
+{
+	const uint8* src = (const uint8*)points;
+	uint8* dst = (uint8*)result;
+	uint32 i = 0;
+#if defined(MYLLY_MATH_SSE2) || defined(MYLLY_MATH_NEON)
+	const vector3_t* p[4];
+	vector3_t* r[4];
+	simd4f x, y, z, rx, ry, rz, norm;
+	simd4f m11, m12, m13, m14, m21, m22, m23, m24, m31, m32, m33, m34, m41, m42, m43, m44;
+	float ox[4], oy[4], oz[4];
+	uint32 j;
+	bool affine;
+#endif
+
+	if ( result == NULL || points == NULL || mat == NULL ) return;
+	if ( stride == 0 ) stride = sizeof( vector3_t );
+
+#if defined(MYLLY_MATH_SSE2) || defined(MYLLY_MATH_NEON)
+	affine = ( mat->_14 == 0.0f && mat->_24 == 0.0f && mat->_34 == 0.0f && mat->_44 == 1.0f );
+
+	m11 = simd4f_set1( mat->_11 ); m12 = simd4f_set1( mat->_12 ); m13 = simd4f_set1( mat->_13 ); m14 = simd4f_set1( mat->_14 );
+	m21 = simd4f_set1( mat->_21 ); m22 = simd4f_set1( mat->_22 ); m23 = simd4f_set1( mat->_23 ); m24 = simd4f_set1( mat->_24 );
+	m31 = simd4f_set1( mat->_31 ); m32 = simd4f_set1( mat->_32 ); m33 = simd4f_set1( mat->_33 ); m34 = simd4f_set1( mat->_34 );
+	m41 = simd4f_set1( mat->_41 ); m42 = simd4f_set1( mat->_42 ); m43 = simd4f_set1( mat->_43 ); m44 = simd4f_set1( mat->_44 );
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		for ( j = 0; j < 4; j++ )
+		{
+			p[j] = (const vector3_t*)( src + ( i + j ) * stride );
+			r[j] = (vector3_t*)( dst + ( i + j ) * stride );
+		}
+
+		x = simd4f_set( p[0]->x, p[1]->x, p[2]->x, p[3]->x );
+		y = simd4f_set( p[0]->y, p[1]->y, p[2]->y, p[3]->y );
+		z = simd4f_set( p[0]->z, p[1]->z, p[2]->z, p[3]->z );
+
+		rx = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m11, x ), simd4f_mul( m21, y ) ), simd4f_mul( m31, z ) ), m41 );
+		ry = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m12, x ), simd4f_mul( m22, y ) ), simd4f_mul( m32, z ) ), m42 );
+		rz = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m13, x ), simd4f_mul( m23, y ) ), simd4f_mul( m33, z ) ), m43 );
+
+		if ( !affine )
+		{
+			norm = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( m14, x ), simd4f_mul( m24, y ) ), simd4f_mul( m34, z ) ), m44 );
+
+			rx = simd4f_div( rx, norm );
+			ry = simd4f_div( ry, norm );
+			rz = simd4f_div( rz, norm );
+		}
+
+		simd4f_storeu( ox, rx );
+		simd4f_storeu( oy, ry );
+		simd4f_storeu( oz, rz );
+
+		for ( j = 0; j < 4; j++ )
+		{
+			r[j]->x = ox[j];
+			r[j]->y = oy[j];
+			r[j]->z = oz[j];
+		}
+	}
+#endif
+
+	for ( ; i < count; i++ )
+	{
+		vector3_t tmp = *(const vector3_t*)( src + i * stride );
+		vector3_transform_coord( (vector3_t*)( dst + i * stride ), &tmp, mat );
+	}
+}
+
+#if defined(MYLLY_MATH_SSE2) || defined(MYLLY_MATH_NEON)
+
+// Normalizes four packed vectors. The scale factors are worked out with the vectors split into
+// components, then spread back over the twelve floats so that the vectors can be scaled in place
+// with three loads and stores. Lanes below the epsilon get a factor of 1, which keeps them as is.
+static MYLLY_INLINE void vector3_normalize4( vector3_t* result, const vector3_t* v, bool fast )
 {
-	result->x = v->x / value;
-	result->y = v->y / value;
-	result->z = v->z / value;
-}
+	simd4f x, y, z, sq, factor, keep, one = simd4f_set1( 1.0f );
+	float f[4];
+	const float* src = v->coords;
+	float* dst = result->coords;
 
-void vector3_add_scalar( vector3_t* result, const vector3_t* v, float value )
-{
-	result->x = v->x + value;
-	result->y = v->y + value;
-	result->z = v->z + value;
-}
+	x = simd4f_set( v[0].x, v[1].x, v[2].x, v[3].x );
+	y = simd4f_set( v[0].y, v[1].y, v[2].y, v[3].y );
+	z = simd4f_set( v[0].z, v[1].z, v[2].z, v[3].z );
 
-void vector3_subtract_scalar( vector3_t* result, const vector3_t* v, float value )
-{
-	result->x = v->x - value;
-	result->y = v->y - value;
-	result->z = v->z - value;
-}
+	sq = simd4f_add( simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) ), simd4f_mul( z, z ) );
 
-float vector3_dot( const vector3_t* v1, const vector3_t* v2 )
-{
-	return v1->x*v2->x + v1->y*v2->y + v1->z*v2->z;
-}
+	if ( fast )
+	{
+		keep = simd4f_cmplt( sq, simd4f_set1( VECTOR3_EPSILON * VECTOR3_EPSILON ) );
+		simd4f_storeu( f, simd4f_select( keep, one, simd4f_rsqrt( sq ) ) );
 
-void vector3_cross( vector3_t* result, const vector3_t* v1, const vector3_t* v2 )
-{
-	result->x = v1->y*v2->z - v1->z*v2->y;
-	result->y = v1->z*v2->x - v1->x*v2->z;
-	result->z = v1->x*v2->y - v1->y*v2->x;
-}
+		x = simd4f_mul( simd4f_loadu( src ), simd4f_set( f[0], f[0], f[0], f[1] ) );
+		y = simd4f_mul( simd4f_loadu( src + 4 ), simd4f_set( f[1], f[1], f[2], f[2] ) );
+		z = simd4f_mul( simd4f_loadu( src + 8 ), simd4f_set( f[2], f[3], f[3], f[3] ) );
+	}
+	else
+	{
+		factor = simd4f_sqrt( sq );
+		keep = simd4f_cmplt( factor, simd4f_set1( VECTOR3_EPSILON ) );
+		simd4f_storeu( f, simd4f_select( keep, one, factor ) );
 
-float vector3_angle( const vector3_t* v1, const vector3_t* v2 )
-{
-	return acosf( vector3_dot( v1, v2 ) / vector3_length( v1 ) / vector3_length( v2 ) );
+		x = simd4f_div( simd4f_loadu( src ), simd4f_set( f[0], f[0], f[0], f[1] ) );
+		y = simd4f_div( simd4f_loadu( src + 4 ), simd4f_set( f[1], f[1], f[2], f[2] ) );
+		z = simd4f_div( simd4f_loadu( src + 8 ), simd4f_set( f[2], f[3], f[3], f[3] ) );
+	}
+
+	simd4f_storeu( dst, x );
+	simd4f_storeu( dst + 4, y );
+	simd4f_storeu( dst + 8, z );
 }
 
-bool vector3_is_zero( const vector3_t* v )
+static void vector3_normalize_array_internal( vector3_t* result, const vector3_t* vectors, uint32 count, bool fast )
 {
-	if ( fabsf( v->x ) < VECTOR3_ERROR &&
-		fabsf( v->y ) < VECTOR3_ERROR &&
-		fabsf( v->z ) < VECTOR3_ERROR )
-		return true;
+	vector3_t tmp[4];
+	uint32 i, n;
 
-	return false;
-}
+	if ( result == NULL || vectors == NULL ) return;
 
-float vector3_length( const vector3_t* v )
-{
-	return sqrtf( v->x*v->x + v->y*v->y + v->z*v->z );
-}
+	for ( i = 0; i + 4 <= count; i += 4 )
+		vector3_normalize4( &result[i], &vectors[i], fast );
 
-float vector3_length_sq( const vector3_t* v )
-{
-	return v->x*v->x + v->y*v->y + v->z*v->z;
+	// The last few go through a zero padded block so that they get the same treatment.
+	if ( i < count )
+	{
+		n = count - i;
+		memset( tmp, 0, sizeof( tmp ) );
+		memcpy( tmp, &vectors[i], n * sizeof( vector3_t ) );
+
+		vector3_normalize4( tmp, tmp, fast );
+		memcpy( &result[i], tmp, n * sizeof( vector3_t ) );
+	}
 }
 
-float vector3_distance( const vector3_t* v1, const vector3_t* v2 )
+#else
+
+// Without a vector unit the vectors are normalized one at a time, gathering them into the emulated
+// vectors would only make it slower. The fast version skips the Newton step as the square root is exact.
+static void vector3_normalize_array_internal( vector3_t* result, const vector3_t* vectors, uint32 count, bool fast )
 {
-	float x, y, z;
+	vector3_t* v;
+	float sq, factor;
+	uint32 i;
 
-	x = v2->x - v1->x;
-	y = v2->y - v1->y;
-	z = v2->z - v1->z;
+	if ( result == NULL || vectors == NULL ) return;
 
-	return sqrtf( x*x + y*y + z*z );
-}
+	for ( i = 0; i < count; i++ )
+	{
+		v = &result[i];
+		*v = vectors[i];
 
-float vector3_distance_sq( const vector3_t* v1, const vector3_t* v2 )
-{
-	float x, y, z;
+		if ( !fast )
+		{
+			vector3_normalize( v );
+			continue;
+		}
 
-	x = v2->x - v1->x;
-	y = v2->y - v1->y;
-	z = v2->z - v1->z;
+		sq = v->x*v->x + v->y*v->y + v->z*v->z;
 
-	return x*x + y*y + z*z;
+		if ( sq >= VECTOR3_EPSILON * VECTOR3_EPSILON )
+		{
+			factor = 1.0f / sqrtf( sq );
+			v->x *= factor;
+			v->y *= factor;
+			v->z *= factor;
+		}
+	}
 }
 
-void vector3_difference( vector3_t* result, const vector3_t* v1, const vector3_t* v2 )
-{
-	result->x = v1->x > v2->x ? v1->x - v2->x : v2->x - v1->x;
-	result->y = v1->y > v2->y ? v1->y - v2->y : v2->y - v1->y;
-	result->z = v1->z > v2->z ? v1->z - v2->z : v2->z - v1->z;
-}
+#endif
 
-void vector3_normalize( vector3_t* v )
+void vector3_normalize_array( vector3_t* result, const vector3_t* vectors, uint32 count )
 {
-	float factor = sqrtf( v->x*v->x + v->y*v->y + v->z*v->z );
-
-	if ( factor < VECTOR3_EPSILON ) return;
-
-	v->x /= factor;
-	v->y /= factor;
-	v->z /= factor;
+	vector3_normalize_array_internal( result, vectors, count, false );
 }
 
-void vector3_lerp( vector3_t* result, const vector3_t* v1, const vector3_t* v2, float t )
+void vector3_normalize_array_fast( vector3_t* result, const vector3_t* vectors, uint32 count )
 {
-	result->x = v1->x + ( v2->x - v1->x ) * t;
-	result->y = v1->y + ( v2->y - v1->y ) * t;
-	result->z = v1->z + ( v2->z - v1->z ) * t;
+	vector3_normalize_array_internal( result, vectors, count, true );
 }
 
-void vector3_transform_coord( vector3_t* result, const vector3_t* point, const matrix4_t* mat )
+void vector3_length_array( float* result, const vector3_t* vectors, uint32 count )
 {
-	float norm;
+	const vector3_t* v;
+	simd4f x, y, z;
+	uint32 i = 0;
 
-	norm = mat->_14 * point->x + mat->_24 * point->y + mat->_34 * point->z + mat->_44;
+	if ( result == NULL || vectors == NULL ) return;
 
-	result->x = ( mat->_11 * point->x + mat->_21 * point->y + mat->_31 * point->z + mat->_41 ) / norm;
-	result->y = ( mat->_12 * point->x + mat->_22 * point->y + mat->_32 * point->z + mat->_42 ) / norm;
-	result->z = ( mat->_13 * point->x + mat->_23 * point->y + mat->_33 * point->z + mat->_43 ) / norm;
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		v = &vectors[i];
+
+		x = simd4f_set( v[0].x, v[1].x, v[2].x, v[3].x );
+		y = simd4f_set( v[0].y, v[1].y, v[2].y, v[3].y );
+		z = simd4f_set( v[0].z, v[1].z, v[2].z, v[3].z );
+
+		simd4f_storeu( &result[i], simd4f_sqrt( simd4f_add( simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) ), simd4f_mul( z, z ) ) ) );
+	}
+
+	for ( ; i < count; i++ )
+		result[i] = vector3_length( &vectors[i] );
 }
@@ -14,6 +14,7 @@
 #define __MYLLY_VECTOR3_H
 
 #include "stdtypes.h"
+#include "Math/MathInline.h"
 #include "Math/Matrix4.h"
 
 #ifdef __cplusplus
@@ -51,6 +52,8 @@ typedef vector3_t Vector3;
 
 __BEGIN_DECLS
 
+#ifndef MYLLY_MATH_USE_INLINE
+
 MYLLY_API void			vector3_add					( vector3_t* result, const vector3_t* v1, const vector3_t* v2 );
 MYLLY_API void			vector3_subtract			( vector3_t* result, const vector3_t* v1, const vector3_t* v2 );
 MYLLY_API void			vector3_multiply			( vector3_t* result, const vector3_t* v, float value );
@@ -72,8 +75,23 @@ MYLLY_API void			vector3_normalize			( vector3_t* v );
 
 MYLLY_API void			vector3_lerp				( vector3_t* result, const vector3_t* v1, const vector3_t* v2, float t );
 
+#endif
+
 MYLLY_API void			vector3_transform_coord		( vector3_t* result, const vector3_t* point, const matrix4_t* mat );
+MYLLY_API void			vector3_transform_coord_array	( vector3_t* result, const vector3_t* points, uint32 count, uint32 stride, const matrix4_t* mat );
+
+// Array versions of vector3_length and vector3_normalize, four vectors per step. result can be the
+// same array as vectors. Vectors shorter than the normalize epsilon are left untouched. The exact
+// version matches vector3_normalize bit for bit, the fast one multiplies by a reciprocal square root
+// estimate refined with a Newton step and is within 3e-7 of unit length.
+MYLLY_API void			vector3_length_array		( float* result, const vector3_t* vectors, uint32 count );
+MYLLY_API void			vector3_normalize_array		( vector3_t* result, const vector3_t* vectors, uint32 count );
+MYLLY_API void			vector3_normalize_array_fast	( vector3_t* result, const vector3_t* vectors, uint32 count );
 
 __END_DECLS
 
+#ifdef MYLLY_MATH_USE_INLINE
+#include "Math/Vector3.inl"
+#endif
+
 #endif /* __MYLLY_VECTOR3_H */
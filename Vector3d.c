@@ -0,0 +1,209 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Vector3d.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		A double precision 3D vector for large world coordinates.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/Vector3d.h"
+#include <math.h>
+
+#define VECTOR3D_EPSILON	1.0e-9
+#define VECTOR3D_ERROR		1.0e-12
+
+void vector3d_add( vector3d_t* result, const vector3d_t* v1, const vector3d_t* v2 )
+{
+	result->x = v1->x + v2->x;
+	result->y = v1->y + v2->y;
+	result->z = v1->z + v2->z;
+}
+
+void vector3d_subtract( vector3d_t* result, const vector3d_t* v1, const vector3d_t* v2 )
+{
+	result->x = v1->x - v2->x;
+	result->y = v1->y - v2->y;
+	result->z = v1->z - v2->z;
+}
+
+void vector3d_multiply( vector3d_t* result, const vector3d_t* v, double value )
+{
+	result->x = v->x * value;
+	result->y = v->y * value;
+	result->z = v->z * value;
+}
+
+void vector3d_divide( vector3d_t* result, const vector3d_t* v, double value )
+{
+	result->x = v->x / value;
+	result->y = v->y / value;
+	result->z = v->z / value;
+}
+
+void vector3d_add_scalar( vector3d_t* result, const vector3d_t* v, double value )
+{
+	result->x = v->x + value;
+	result->y = v->y + value;
+	result->z = v->z + value;
+}
+
+void vector3d_subtract_scalar( vector3d_t* result, const vector3d_t* v, double value )
+{
+	result->x = v->x - value;
+	result->y = v->y - value;
+	result->z = v->z - value;
+}
+
+double vector3d_dot( const vector3d_t* v1, const vector3d_t* v2 )
+{
+	return v1->x*v2->x + v1->y*v2->y + v1->z*v2->z;
+}
+
+void vector3d_cross( vector3d_t* result, const vector3d_t* v1, const vector3d_t* v2 )
+{
+	double x, y, z;
+
+	x = v1->y*v2->z - v1->z*v2->y;
+	y = v1->z*v2->x - v1->x*v2->z;
+	z = v1->x*v2->y - v1->y*v2->x;
+
+	result->x = x;
+	result->y = y;
+	result->z = z;
+}
+
+double vector3d_angle( const vector3d_t* v1, const vector3d_t* v2 )
+{
+	return acos( vector3d_dot( v1, v2 ) / vector3d_length( v1 ) / vector3d_length( v2 ) );
+}
+
+bool vector3d_is_zero( const vector3d_t* v )
+{
+	if ( fabs( v->x ) < VECTOR3D_ERROR &&
+		fabs( v->y ) < VECTOR3D_ERROR &&
+		fabs( v->z ) < VECTOR3D_ERROR )
+		return true;
+
+	return false;
+}
+
+double vector3d_length( const vector3d_t* v )
+{
+	return sqrt( v->x*v->x + v->y*v->y + v->z*v->z );
+}
+
+double vector3d_length_sq( const vector3d_t* v )
+{
+	return v->x*v->x + v->y*v->y + v->z*v->z;
+}
+
+double vector3d_distance( const vector3d_t* v1, const vector3d_t* v2 )
+{
+	return sqrt( vector3d_distance_sq( v1, v2 ) );
+}
+
+double vector3d_distance_sq( const vector3d_t* v1, const vector3d_t* v2 )
+{
+	double x, y, z;
+
+	x = v2->x - v1->x;
+	y = v2->y - v1->y;
+	z = v2->z - v1->z;
+
+	return x*x + y*y + z*z;
+}
+
+void vector3d_difference( vector3d_t* result, const vector3d_t* v1, const vector3d_t* v2 )
+{
+	result->x = v1->x > v2->x ? v1->x - v2->x : v2->x - v1->x;
+	result->y = v1->y > v2->y ? v1->y - v2->y : v2->y - v1->y;
+	result->z = v1->z > v2->z ? v1->z - v2->z : v2->z - v1->z;
+}
+
+void vector3d_normalize( vector3d_t* v )
+{
+	double factor = sqrt( v->x*v->x + v->y*v->y + v->z*v->z );
+
+	if ( factor < VECTOR3D_EPSILON ) return;
+
+	v->x /= factor;
+	v->y /= factor;
+	v->z /= factor;
+}
+
+void vector3d_lerp( vector3d_t* result, const vector3d_t* v1, const vector3d_t* v2, double t )
+{
+	result->x = v1->x + ( v2->x - v1->x ) * t;
+	result->y = v1->y + ( v2->y - v1->y ) * t;
+	result->z = v1->z + ( v2->z - v1->z ) * t;
+}
+
+void vector3d_transform_coord( vector3d_t* result, const vector3d_t* point, const matrix4d_t* mat )
+{
+	double x = point->x, y = point->y, z = point->z, norm;
+
+	norm = mat->_14 * x + mat->_24 * y + mat->_34 * z + mat->_44;
+
+	result->x = ( mat->_11 * x + mat->_21 * y + mat->_31 * z + mat->_41 ) / norm;
+	result->y = ( mat->_12 * x + mat->_22 * y + mat->_32 * z + mat->_42 ) / norm;
+	result->z = ( mat->_13 * x + mat->_23 * y + mat->_33 * z + mat->_43 ) / norm;
+}
+
+// Transforms count points which are stride bytes apart in both the source and the destination array
+// (0 for tightly packed vectors).
+void vector3d_transform_coord_array( vector3d_t* result, const vector3d_t* points, uint32 count, uint32 stride, const matrix4d_t* mat )
+{
+	const uint8* src = (const uint8*)points;
+	uint8* dst = (uint8*)result;
+	uint32 i;
+
+	if ( result == NULL || points == NULL || mat == NULL ) return;
+	if ( stride == 0 ) stride = sizeof( vector3d_t );
+
+	for ( i = 0; i < count; i++ )
+		vector3d_transform_coord( (vector3d_t*)( dst + i * stride ), (const vector3d_t*)( src + i * stride ), mat );
+}
+
+void vector3d_from_vector3( vector3d_t* result, const vector3_t* v )
+{
+	result->x = (double)v->x;
+	result->y = (double)v->y;
+	result->z = (double)v->z;
+}
+
+void vector3d_to_vector3( vector3_t* result, const vector3d_t* v )
+{
+	result->x = (float)v->x;
+	result->y = (float)v->y;
+	result->z = (float)v->z;
+}
+
+// The matrix is kept in locals so the loop doesn't reload it after every store through result,
+// which the compiler has to assume may alias the view matrix.
+void vector3d_to_view_array( vector3_t* result, const vector3d_t* points, uint32 count, const matrix4d_t* view )
+{
+	double m11, m12, m13, m21, m22, m23, m31, m32, m33, m41, m42, m43;
+	double x, y, z;
+	uint32 i;
+
+	if ( result == NULL || points == NULL || view == NULL ) return;
+
+	m11 = view->_11; m12 = view->_12; m13 = view->_13;
+	m21 = view->_21; m22 = view->_22; m23 = view->_23;
+	m31 = view->_31; m32 = view->_32; m33 = view->_33;
+	m41 = view->_41; m42 = view->_42; m43 = view->_43;
+
+	for ( i = 0; i < count; i++ )
+	{
+		x = points[i].x;
+		y = points[i].y;
+		z = points[i].z;
+
+		result[i].x = (float)( m11 * x + m21 * y + m31 * z + m41 );
+		result[i].y = (float)( m12 * x + m22 * y + m32 * z + m42 );
+		result[i].z = (float)( m13 * x + m23 * y + m33 * z + m43 );
+	}
+}
@@ -0,0 +1,91 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		Vector3d.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		A double precision 3D vector for large world coordinates.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_VECTOR3D_H
+#define __MYLLY_VECTOR3D_H
+
+#include "stdtypes.h"
+#include "Math/Vector3.h"
+#include "Math/Matrix4d.h"
+
+#ifdef __cplusplus
+
+// A vector implementation for C++
+union vector3d_t
+{
+	vector3d_t() { x = 0.0; y = 0.0; z = 0.0; }
+	vector3d_t( double X, double Y, double Z ) { x = X; y = Y; z = Z; }
+
+	struct {
+		double x;
+		double y;
+		double z;
+	};
+	double coords[3];
+};
+
+#else
+
+// Pure C version of the struct
+typedef union
+{
+	struct {
+		double x;
+		double y;
+		double z;
+	};
+	double coords[3];
+} vector3d_t;
+
+#endif
+
+typedef vector3d_t Vector3d;
+
+__BEGIN_DECLS
+
+MYLLY_API void			vector3d_add				( vector3d_t* result, const vector3d_t* v1, const vector3d_t* v2 );
+MYLLY_API void			vector3d_subtract			( vector3d_t* result, const vector3d_t* v1, const vector3d_t* v2 );
+MYLLY_API void			vector3d_multiply			( vector3d_t* result, const vector3d_t* v, double value );
+MYLLY_API void			vector3d_divide				( vector3d_t* result, const vector3d_t* v, double value );
+MYLLY_API void			vector3d_add_scalar			( vector3d_t* result, const vector3d_t* v, double value );
+MYLLY_API void			vector3d_subtract_scalar	( vector3d_t* result, const vector3d_t* v, double value );
+
+MYLLY_API double		vector3d_dot				( const vector3d_t* v1, const vector3d_t* v2 );
+MYLLY_API void			vector3d_cross				( vector3d_t* result, const vector3d_t* v1, const vector3d_t* v2 );
+MYLLY_API double		vector3d_angle				( const vector3d_t* v1, const vector3d_t* v2 );
+
+MYLLY_API bool			vector3d_is_zero			( const vector3d_t* v );
+MYLLY_API double		vector3d_length				( const vector3d_t* v );
+MYLLY_API double		vector3d_length_sq			( const vector3d_t* v );
+MYLLY_API double		vector3d_distance			( const vector3d_t* v1, const vector3d_t* v2 );
+MYLLY_API double		vector3d_distance_sq		( const vector3d_t* v1, const vector3d_t* v2 );
+MYLLY_API void			vector3d_difference			( vector3d_t* result, const vector3d_t* v1, const vector3d_t* v2 );
+MYLLY_API void			vector3d_normalize			( vector3d_t* v );
+
+MYLLY_API void			vector3d_lerp				( vector3d_t* result, const vector3d_t* v1, const vector3d_t* v2, double t );
+
+MYLLY_API void			vector3d_transform_coord		( vector3d_t* result, const vector3d_t* point, const matrix4d_t* mat );
+MYLLY_API void			vector3d_transform_coord_array	( vector3d_t* result, const vector3d_t* points, uint32 count, uint32 stride, const matrix4d_t* mat );
+
+// Conversions between the single and double precision vectors.
+MYLLY_API void			vector3d_from_vector3		( vector3d_t* result, const vector3_t* v );
+MYLLY_API void			vector3d_to_vector3			( vector3_t* result, const vector3d_t* v );
+
+// Transforms double precision world positions by an affine view matrix (the last column is ignored)
+// and writes the float view space positions. The whole transform is done in double precision, so
+// points near the camera keep their precision however far they are from the world origin, and only
+// the final result is rounded to float.
+MYLLY_API void			vector3d_to_view_array		( vector3_t* result, const vector3d_t* points, uint32 count, const matrix4d_t* view );
+
+__END_DECLS
+
+#endif /* __MYLLY_VECTOR3D_H */
@@ -9,119 +9,145 @@
  *
  **********************************************************************/
 
+// Always build the out-of-line versions into the library, see MathInline.h
+#define MYLLY_MATH_BUILD
+
 #include "Math/Vector4.h"
-#include <math.h>
+#include "Math/Vector4.inl"
+#include "Math/MathSimd.h"
+#include <string.h>
 
-#define VECTOR4_EPSILON 0.001f
+#if defined(MYLLY_MATH_SSE2) || defined(MYLLY_MATH_NEON)
 
-void vector4_add( vector4_t* result, const vector4_t* v1, const vector4_t* v2 )
+// Normalizes four vectors, see vector3_normalize4. Each vector fills a register, so the components
+// come from a transposed copy and the factors are broadcast one vector at a time.
+static MYLLY_INLINE void vector4_normalize4( vector4_t* result, const vector4_t* v, bool fast )
 {
-	result->x = v1->x + v2->x;
-	result->y = v1->y + v2->y;
-	result->z = v1->z + v2->z;
-	result->w = v1->w + v2->w;
+	simd4f r0, r1, r2, r3, x, y, z, w, sq, factor, keep, one = simd4f_set1( 1.0f );
+	float f[4];
+
+	r0 = x = simd4f_loadu( v[0].coords );
+	r1 = y = simd4f_loadu( v[1].coords );
+	r2 = z = simd4f_loadu( v[2].coords );
+	r3 = w = simd4f_loadu( v[3].coords );
+	simd4f_transpose( x, y, z, w );
+
+	sq = simd4f_add( simd4f_add( simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) ), simd4f_mul( z, z ) ), simd4f_mul( w, w ) );
+
+	if ( fast )
+	{
+		keep = simd4f_cmplt( sq, simd4f_set1( VECTOR4_EPSILON * VECTOR4_EPSILON ) );
+		simd4f_storeu( f, simd4f_select( keep, one, simd4f_rsqrt( sq ) ) );
+
+		r0 = simd4f_mul( r0, simd4f_set1( f[0] ) );
+		r1 = simd4f_mul( r1, simd4f_set1( f[1] ) );
+		r2 = simd4f_mul( r2, simd4f_set1( f[2] ) );
+		r3 = simd4f_mul( r3, simd4f_set1( f[3] ) );
+	}
+	else
+	{
+		factor = simd4f_sqrt( sq );
+		keep = simd4f_cmplt( factor, simd4f_set1( VECTOR4_EPSILON ) );
+		simd4f_storeu( f, simd4f_select( keep, one, factor ) );
+
+		r0 = simd4f_div( r0, simd4f_set1( f[0] ) );
+		r1 = simd4f_div( r1, simd4f_set1( f[1] ) );
+		r2 = simd4f_div( r2, simd4f_set1( f[2] ) );
+		r3 = simd4f_div( r3, simd4f_set1( f[3] ) );
+	}
+
+	simd4f_storeu( result[0].coords, r0 );
+	simd4f_storeu( result[1].coords, r1 );
+	simd4f_storeu( result[2].coords, r2 );
+	simd4f_storeu( result[3].coords, r3 );
 }
 
-void vector4_subtract( vector4_t* result, const vector4_t* v1, const vector4_t* v2 )
+static void vector4_normalize_array_internal( vector4_t* result, const vector4_t* vectors, uint32 count, bool fast )
 {
-	result->x = v1->x - v2->x;
-	result->y = v1->y - v2->y;
-	result->z = v1->z - v2->z;
-	result->w = v1->w - v2->w;
-}
+	vector4_t tmp[4];
+	uint32 i, n;
 
-void vector4_multiply( vector4_t* result, const vector4_t* v, float value )
-{
-	result->x = v->x * value;
-	result->y = v->y * value;
-	result->z = v->z * value;
-	result->w = v->w * value;
-}
+	if ( result == NULL || vectors == NULL ) return;
 
-void vector4_divide( vector4_t* result, const vector4_t* v, float value )
-{
-	result->x = v->x / value;
-	result->y = v->y / value;
-	result->z = v->z / value;
-	result->w = v->w / value;
-}
+	for ( i = 0; i + 4 <= count; i += 4 )
+		vector4_normalize4( &result[i], &vectors[i], fast );
 
-void vector4_add_scalar( vector4_t* result, const vector4_t* v, float value )
-{
-	result->x = v->x + value;
-	result->y = v->y + value;
-	result->z = v->z + value;
-	result->w = v->w + value;
-}
+	if ( i < count )
+	{
+		n = count - i;
+		memset( tmp, 0, sizeof( tmp ) );
+		memcpy( tmp, &vectors[i], n * sizeof( vector4_t ) );
 
-void vector4_subtract_scalar( vector4_t* result, const vector4_t* v, float value )
-{
-	result->x = v->x - value;
-	result->y = v->y - value;
-	result->z = v->z - value;
-	result->w = v->w - value;
+		vector4_normalize4( tmp, tmp, fast );
+		memcpy( &result[i], tmp, n * sizeof( vector4_t ) );
+	}
 }
 
-float vector4_dot( const vector4_t* v1, const vector4_t* v2 )
-{
-	return v1->x*v2->x + v1->y*v2->y + v1->z*v2->z + v1->w*v2->w;
-}
+#else
 
-float vector4_angle( const vector4_t* v1, const vector4_t* v2 )
+// Without a vector unit the vectors are normalized one at a time, see vector3_normalize_array_internal.
+static void vector4_normalize_array_internal( vector4_t* result, const vector4_t* vectors, uint32 count, bool fast )
 {
-	return acosf( vector4_dot( v1, v2 ) / vector4_length( v1 ) / vector4_length( v2 ) );
+	vector4_t* v;
+	float sq, factor;
+	uint32 i;
+
+	if ( result == NULL || vectors == NULL ) return;
+
+	for ( i = 0; i < count; i++ )
+	{
+		v = &result[i];
+		*v = vectors[i];
+
+		if ( !fast )
+		{
+			vector4_normalize( v );
+			continue;
+		}
+
+		sq = v->x*v->x + v->y*v->y + v->z*v->z + v->w*v->w;
+
+		if ( sq >= VECTOR4_EPSILON * VECTOR4_EPSILON )
+		{
+			factor = 1.0f / sqrtf( sq );
+			v->x *= factor;
+			v->y *= factor;
+			v->z *= factor;
+			v->w *= factor;
+		}
+	}
 }
 
-float vector4_length( const vector4_t* v )
-{
-	return sqrtf( v->x*v->x + v->y*v->y + v->z*v->z + v->w*v->w );
-}
+#endif
 
-float vector4_length_sq( const vector4_t* v )
+void vector4_normalize_array( vector4_t* result, const vector4_t* vectors, uint32 count )
 {
-	return v->x*v->x + v->y*v->y + v->z*v->z + v->w*v->w;
+	vector4_normalize_array_internal( result, vectors, count, false );
 }
 
-float vector4_distance( const vector4_t* v1, const vector4_t* v2 )
+void vector4_normalize_array_fast( vector4_t* result, const vector4_t* vectors, uint32 count )
 {
-	float x, y, z, w;
-
-	x = v2->x - v1->x;
-	y = v2->y - v1->y;
-	z = v2->z - v1->z;
-	w = v2->w - v1->w;
-
-	return sqrtf( x*x + y*y + z*z + w*w );
+	vector4_normalize_array_internal( result, vectors, count, true );
 }
 
-float vector4_distance_sq( const vector4_t* v1, const vector4_t* v2 )
+void vector4_length_array( float* result, const vector4_t* vectors, uint32 count )
 {
-	float x, y, z, w;
-
-	x = v2->x - v1->x;
-	y = v2->y - v1->y;
-	z = v2->z - v1->z;
-	w = v2->w - v1->w;
+	simd4f x, y, z, w;
+	uint32 i = 0;
 
-	return x*x + y*y + z*z + w*w;
-}
+	if ( result == NULL || vectors == NULL ) return;
 
-void vector4_normalize( vector4_t* v )
-{
-	float factor = sqrtf( v->x*v->x + v->y*v->y + v->z*v->z + v->w*v->w );
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		x = simd4f_loadu( vectors[i].coords );
+		y = simd4f_loadu( vectors[i+1].coords );
+		z = simd4f_loadu( vectors[i+2].coords );
+		w = simd4f_loadu( vectors[i+3].coords );
+		simd4f_transpose( x, y, z, w );
 
-	if ( factor < VECTOR4_EPSILON ) return;
+		simd4f_storeu( &result[i], simd4f_sqrt( simd4f_add( simd4f_add( simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) ), simd4f_mul( z, z ) ), simd4f_mul( w, w ) ) ) );
+	}
 
-	v->x /= factor;
-	v->y /= factor;
-	v->z /= factor;
-	v->w /= factor;
-}
-
-void vector4_lerp( vector4_t* result, const vector4_t* v1, const vector4_t* v2, float t )
-{
-	result->x = v1->x + ( v2->x - v1->x ) * t;
-	result->y = v1->y + ( v2->y - v1->y ) * t;
-	result->z = v1->z + ( v2->z - v1->z ) * t;
-	result->w = v1->w + ( v2->w - v1->w ) * t;
+	for ( ; i < count; i++ )
+		result[i] = vector4_length( &vectors[i] );
 }
@@ -14,6 +14,7 @@
 #define __MYLLY_VECTOR4_H
 
 #include "stdtypes.h"
+#include "Math/MathInline.h"
 
 typedef union
 {
@@ -28,6 +29,8 @@ typedef union
 
 __BEGIN_DECLS
 
+#ifndef MYLLY_MATH_USE_INLINE
+
 MYLLY_API void			vector4_add				( vector4_t* result, const vector4_t* v1, const vector4_t* v2 );
 MYLLY_API void			vector4_subtract		( vector4_t* result, const vector4_t* v1, const vector4_t* v2 );
 MYLLY_API void			vector4_multiply		( vector4_t* result, const vector4_t* v, float value );
@@ -46,6 +49,17 @@ MYLLY_API void			vector4_normalize		( vector4_t* v );
 
 MYLLY_API void			vector4_lerp			( vector4_t* result, const vector4_t* v1, const vector4_t* v2, float t );
 
+#endif
+
+// Array versions of vector4_length and vector4_normalize, see vector3_normalize_array.
+MYLLY_API void			vector4_length_array		( float* result, const vector4_t* vectors, uint32 count );
+MYLLY_API void			vector4_normalize_array		( vector4_t* result, const vector4_t* vectors, uint32 count );
+MYLLY_API void			vector4_normalize_array_fast	( vector4_t* result, const vector4_t* vectors, uint32 count );
+
 __END_DECLS
 
+#ifdef MYLLY_MATH_USE_INLINE
+#include "Math/Vector4.inl"
+#endif
+
 #endif /* __MYLLY_VECTOR4_H */
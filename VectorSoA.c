@@ -0,0 +1,438 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		VectorSoA.c
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Structure-of-arrays vector streams for bulk operations.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#include "Math/VectorSoA.h"
+#include "Math/MathSimd.h"
+#include "Math/MathUtils.h"
+#include <string.h>
+
+#define SOA_ALIGNMENT		16
+#define SOA_PADDED(n)		( ( (n) + 3 ) & ~3u )
+#define SOA_EPSILON			0.001f
+
+static float* soa_alloc_components( uint32 capacity, uint32 components )
+{
+	size_t size = SOA_PADDED( capacity ) * components * sizeof( float );
+	float* data = (float*)math_aligned_alloc( size, SOA_ALIGNMENT );
+
+	if ( data != NULL ) memset( data, 0, size );
+	return data;
+}
+
+// Writes n (<= 4) lanes of a vector into an unpadded array.
+static MYLLY_INLINE void soa_store_partial( float* dst, simd4f v, uint32 n )
+{
+	float tmp[4];
+	uint32 i;
+
+	simd4f_storeu( tmp, v );
+	for ( i = 0; i < n; i++ ) dst[i] = tmp[i];
+}
+
+// --------------------------------------------------
+// vector3_soa_t
+// --------------------------------------------------
+
+bool vector3_soa_create( vector3_soa_t* soa, uint32 capacity )
+{
+	float* data;
+
+	if ( soa == NULL ) return false;
+
+	data = soa_alloc_components( capacity, 3 );
+	if ( data == NULL ) return false;
+
+	soa->x = data;
+	soa->y = data + SOA_PADDED( capacity );
+	soa->z = data + SOA_PADDED( capacity ) * 2;
+	soa->count = 0;
+	soa->capacity = capacity;
+
+	return true;
+}
+
+void vector3_soa_destroy( vector3_soa_t* soa )
+{
+	if ( soa == NULL ) return;
+
+	math_aligned_free( soa->x );
+
+	soa->x = soa->y = soa->z = NULL;
+	soa->count = soa->capacity = 0;
+}
+
+void vector3_soa_pack( vector3_soa_t* soa, const vector3_t* src, uint32 count )
+{
+	uint32 i;
+
+	count = math_min( count, soa->capacity );
+
+	for ( i = 0; i < count; i++ )
+	{
+		soa->x[i] = src[i].x;
+		soa->y[i] = src[i].y;
+		soa->z[i] = src[i].z;
+	}
+
+	soa->count = count;
+}
+
+void vector3_soa_unpack( vector3_t* dst, const vector3_soa_t* soa )
+{
+	uint32 i;
+
+	for ( i = 0; i < soa->count; i++ )
+	{
+		dst[i].x = soa->x[i];
+		dst[i].y = soa->y[i];
+		dst[i].z = soa->z[i];
+	}
+}
+
+void vector3_soa_add( vector3_soa_t* result, const vector3_soa_t* a, const vector3_soa_t* b )
+{
+	uint32 i, count = math_min( a->count, b->count );
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		simd4f_store( result->x + i, simd4f_add( simd4f_load( a->x + i ), simd4f_load( b->x + i ) ) );
+		simd4f_store( result->y + i, simd4f_add( simd4f_load( a->y + i ), simd4f_load( b->y + i ) ) );
+		simd4f_store( result->z + i, simd4f_add( simd4f_load( a->z + i ), simd4f_load( b->z + i ) ) );
+	}
+
+	result->count = count;
+}
+
+void vector3_soa_subtract( vector3_soa_t* result, const vector3_soa_t* a, const vector3_soa_t* b )
+{
+	uint32 i, count = math_min( a->count, b->count );
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		simd4f_store( result->x + i, simd4f_sub( simd4f_load( a->x + i ), simd4f_load( b->x + i ) ) );
+		simd4f_store( result->y + i, simd4f_sub( simd4f_load( a->y + i ), simd4f_load( b->y + i ) ) );
+		simd4f_store( result->z + i, simd4f_sub( simd4f_load( a->z + i ), simd4f_load( b->z + i ) ) );
+	}
+
+	result->count = count;
+}
+
+void vector3_soa_scale( vector3_soa_t* result, const vector3_soa_t* a, float value )
+{
+	uint32 i, count = a->count;
+	simd4f s = simd4f_set1( value );
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		simd4f_store( result->x + i, simd4f_mul( simd4f_load( a->x + i ), s ) );
+		simd4f_store( result->y + i, simd4f_mul( simd4f_load( a->y + i ), s ) );
+		simd4f_store( result->z + i, simd4f_mul( simd4f_load( a->z + i ), s ) );
+	}
+
+	result->count = count;
+}
+
+void vector3_soa_dot( float* result, const vector3_soa_t* a, const vector3_soa_t* b )
+{
+	uint32 i, count = math_min( a->count, b->count );
+	simd4f dot;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		dot = simd4f_mul( simd4f_load( a->x + i ), simd4f_load( b->x + i ) );
+		dot = simd4f_add( dot, simd4f_mul( simd4f_load( a->y + i ), simd4f_load( b->y + i ) ) );
+		dot = simd4f_add( dot, simd4f_mul( simd4f_load( a->z + i ), simd4f_load( b->z + i ) ) );
+
+		if ( i + 4 <= count ) simd4f_storeu( result + i, dot );
+		else soa_store_partial( result + i, dot, count - i );
+	}
+}
+
+void vector3_soa_cross( vector3_soa_t* result, const vector3_soa_t* a, const vector3_soa_t* b )
+{
+	uint32 i, count = math_min( a->count, b->count );
+	simd4f ax, ay, az, bx, by, bz;
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		ax = simd4f_load( a->x + i ); ay = simd4f_load( a->y + i ); az = simd4f_load( a->z + i );
+		bx = simd4f_load( b->x + i ); by = simd4f_load( b->y + i ); bz = simd4f_load( b->z + i );
+
+		simd4f_store( result->x + i, simd4f_sub( simd4f_mul( ay, bz ), simd4f_mul( az, by ) ) );
+		simd4f_store( result->y + i, simd4f_sub( simd4f_mul( az, bx ), simd4f_mul( ax, bz ) ) );
+		simd4f_store( result->z + i, simd4f_sub( simd4f_mul( ax, by ), simd4f_mul( ay, bx ) ) );
+	}
+
+	result->count = count;
+}
+
+void vector3_soa_length( float* result, const vector3_soa_t* a )
+{
+	uint32 i, count = a->count;
+	simd4f x, y, z, len;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		x = simd4f_load( a->x + i ); y = simd4f_load( a->y + i ); z = simd4f_load( a->z + i );
+		len = simd4f_sqrt( simd4f_add( simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) ), simd4f_mul( z, z ) ) );
+
+		if ( i + 4 <= count ) simd4f_storeu( result + i, len );
+		else soa_store_partial( result + i, len, count - i );
+	}
+}
+
+// Vectors shorter than the epsilon are left untouched, like in vector3_normalize.
+void vector3_soa_normalize( vector3_soa_t* result, const vector3_soa_t* a )
+{
+	uint32 i, count = a->count;
+	simd4f x, y, z, factor, keep, eps = simd4f_set1( SOA_EPSILON );
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		x = simd4f_load( a->x + i ); y = simd4f_load( a->y + i ); z = simd4f_load( a->z + i );
+
+		factor = simd4f_sqrt( simd4f_add( simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) ), simd4f_mul( z, z ) ) );
+		keep = simd4f_cmplt( factor, eps );
+
+		simd4f_store( result->x + i, simd4f_select( keep, x, simd4f_div( x, factor ) ) );
+		simd4f_store( result->y + i, simd4f_select( keep, y, simd4f_div( y, factor ) ) );
+		simd4f_store( result->z + i, simd4f_select( keep, z, simd4f_div( z, factor ) ) );
+	}
+
+	result->count = count;
+}
+
+void vector3_soa_lerp( vector3_soa_t* result, const vector3_soa_t* a, const vector3_soa_t* b, float t )
+{
+	uint32 i, count = math_min( a->count, b->count );
+	simd4f va, vt = simd4f_set1( t );
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		va = simd4f_load( a->x + i );
+		simd4f_store( result->x + i, simd4f_add( va, simd4f_mul( simd4f_sub( simd4f_load( b->x + i ), va ), vt ) ) );
+		va = simd4f_load( a->y + i );
+		simd4f_store( result->y + i, simd4f_add( va, simd4f_mul( simd4f_sub( simd4f_load( b->y + i ), va ), vt ) ) );
+		va = simd4f_load( a->z + i );
+		simd4f_store( result->z + i, simd4f_add( va, simd4f_mul( simd4f_sub( simd4f_load( b->z + i ), va ), vt ) ) );
+	}
+
+	result->count = count;
+}
+
+// --------------------------------------------------
+// vector4_soa_t
+// --------------------------------------------------
+
+bool vector4_soa_create( vector4_soa_t* soa, uint32 capacity )
+{
+	float* data;
+
+	if ( soa == NULL ) return false;
+
+	data = soa_alloc_components( capacity, 4 );
+	if ( data == NULL ) return false;
+
+	soa->x = data;
+	soa->y = data + SOA_PADDED( capacity );
+	soa->z = data + SOA_PADDED( capacity ) * 2;
+	soa->w = data + SOA_PADDED( capacity ) * 3;
+	soa->count = 0;
+	soa->capacity = capacity;
+
+	return true;
+}
+
+void vector4_soa_destroy( vector4_soa_t* soa )
+{
+	if ( soa == NULL ) return;
+
+	math_aligned_free( soa->x );
+
+	soa->x = soa->y = soa->z = soa->w = NULL;
+	soa->count = soa->capacity = 0;
+}
+
+void vector4_soa_pack( vector4_soa_t* soa, const vector4_t* src, uint32 count )
+{
+	uint32 i;
+
+	count = math_min( count, soa->capacity );
+
+	for ( i = 0; i < count; i++ )
+	{
+		soa->x[i] = src[i].x;
+		soa->y[i] = src[i].y;
+		soa->z[i] = src[i].z;
+		soa->w[i] = src[i].w;
+	}
+
+	soa->count = count;
+}
+
+void vector4_soa_unpack( vector4_t* dst, const vector4_soa_t* soa )
+{
+	uint32 i;
+
+	for ( i = 0; i < soa->count; i++ )
+	{
+		dst[i].x = soa->x[i];
+		dst[i].y = soa->y[i];
+		dst[i].z = soa->z[i];
+		dst[i].w = soa->w[i];
+	}
+}
+
+void vector4_soa_add( vector4_soa_t* result, const vector4_soa_t* a, const vector4_soa_t* b )
+{
+	uint32 i, count = math_min( a->count, b->count );
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		simd4f_store( result->x + i, simd4f_add( simd4f_load( a->x + i ), simd4f_load( b->x + i ) ) );
+		simd4f_store( result->y + i, simd4f_add( simd4f_load( a->y + i ), simd4f_load( b->y + i ) ) );
+		simd4f_store( result->z + i, simd4f_add( simd4f_load( a->z + i ), simd4f_load( b->z + i ) ) );
+		simd4f_store( result->w + i, simd4f_add( simd4f_load( a->w + i ), simd4f_load( b->w + i ) ) );
+	}
+
+	result->count = count;
+}
+
+void vector4_soa_subtract( vector4_soa_t* result, const vector4_soa_t* a, const vector4_soa_t* b )
+{
+	uint32 i, count = math_min( a->count, b->count );
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		simd4f_store( result->x + i, simd4f_sub( simd4f_load( a->x + i ), simd4f_load( b->x + i ) ) );
+		simd4f_store( result->y + i, simd4f_sub( simd4f_load( a->y + i ), simd4f_load( b->y + i ) ) );
+		simd4f_store( result->z + i, simd4f_sub( simd4f_load( a->z + i ), simd4f_load( b->z + i ) ) );
+		simd4f_store( result->w + i, simd4f_sub( simd4f_load( a->w + i ), simd4f_load( b->w + i ) ) );
+	}
+
+	result->count = count;
+}
+
+void vector4_soa_scale( vector4_soa_t* result, const vector4_soa_t* a, float value )
+{
+	uint32 i, count = a->count;
+	simd4f s = simd4f_set1( value );
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		simd4f_store( result->x + i, simd4f_mul( simd4f_load( a->x + i ), s ) );
+		simd4f_store( result->y + i, simd4f_mul( simd4f_load( a->y + i ), s ) );
+		simd4f_store( result->z + i, simd4f_mul( simd4f_load( a->z + i ), s ) );
+		simd4f_store( result->w + i, simd4f_mul( simd4f_load( a->w + i ), s ) );
+	}
+
+	result->count = count;
+}
+
+void vector4_soa_dot( float* result, const vector4_soa_t* a, const vector4_soa_t* b )
+{
+	uint32 i, count = math_min( a->count, b->count );
+	simd4f dot;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		dot = simd4f_mul( simd4f_load( a->x + i ), simd4f_load( b->x + i ) );
+		dot = simd4f_add( dot, simd4f_mul( simd4f_load( a->y + i ), simd4f_load( b->y + i ) ) );
+		dot = simd4f_add( dot, simd4f_mul( simd4f_load( a->z + i ), simd4f_load( b->z + i ) ) );
+		dot = simd4f_add( dot, simd4f_mul( simd4f_load( a->w + i ), simd4f_load( b->w + i ) ) );
+
+		if ( i + 4 <= count ) simd4f_storeu( result + i, dot );
+		else soa_store_partial( result + i, dot, count - i );
+	}
+}
+
+void vector4_soa_length( float* result, const vector4_soa_t* a )
+{
+	uint32 i, count = a->count;
+	simd4f x, y, z, w, len;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		x = simd4f_load( a->x + i ); y = simd4f_load( a->y + i );
+		z = simd4f_load( a->z + i ); w = simd4f_load( a->w + i );
+
+		len = simd4f_add( simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) ), simd4f_mul( z, z ) );
+		len = simd4f_sqrt( simd4f_add( len, simd4f_mul( w, w ) ) );
+
+		if ( i + 4 <= count ) simd4f_storeu( result + i, len );
+		else soa_store_partial( result + i, len, count - i );
+	}
+}
+
+void vector4_soa_normalize( vector4_soa_t* result, const vector4_soa_t* a )
+{
+	uint32 i, count = a->count;
+	simd4f x, y, z, w, factor, keep, eps = simd4f_set1( SOA_EPSILON );
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		x = simd4f_load( a->x + i ); y = simd4f_load( a->y + i );
+		z = simd4f_load( a->z + i ); w = simd4f_load( a->w + i );
+
+		factor = simd4f_add( simd4f_add( simd4f_mul( x, x ), simd4f_mul( y, y ) ), simd4f_mul( z, z ) );
+		factor = simd4f_sqrt( simd4f_add( factor, simd4f_mul( w, w ) ) );
+		keep = simd4f_cmplt( factor, eps );
+
+		simd4f_store( result->x + i, simd4f_select( keep, x, simd4f_div( x, factor ) ) );
+		simd4f_store( result->y + i, simd4f_select( keep, y, simd4f_div( y, factor ) ) );
+		simd4f_store( result->z + i, simd4f_select( keep, z, simd4f_div( z, factor ) ) );
+		simd4f_store( result->w + i, simd4f_select( keep, w, simd4f_div( w, factor ) ) );
+	}
+
+	result->count = count;
+}
+
+void vector4_soa_lerp( vector4_soa_t* result, const vector4_soa_t* a, const vector4_soa_t* b, float t )
+{
+	uint32 i, count = math_min( a->count, b->count );
+	simd4f va, vt = simd4f_set1( t );
+
+	if ( result->capacity < count ) return;
+
+	for ( i = 0; i < count; i += 4 )
+	{
+		va = simd4f_load( a->x + i );
+		simd4f_store( result->x + i, simd4f_add( va, simd4f_mul( simd4f_sub( simd4f_load( b->x + i ), va ), vt ) ) );
+		va = simd4f_load( a->y + i );
+		simd4f_store( result->y + i, simd4f_add( va, simd4f_mul( simd4f_sub( simd4f_load( b->y + i ), va ), vt ) ) );
+		va = simd4f_load( a->z + i );
+		simd4f_store( result->z + i, simd4f_add( va, simd4f_mul( simd4f_sub( simd4f_load( b->z + i ), va ), vt ) ) );
+		va = simd4f_load( a->w + i );
+		simd4f_store( result->w + i, simd4f_add( va, simd4f_mul( simd4f_sub( simd4f_load( b->w + i ), va ), vt ) ) );
+	}
+
+	result->count = count;
+}
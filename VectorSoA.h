@@ -0,0 +1,74 @@
+/**********************************************************************
+ *
+ * PROJECT:		Math library
+ * FILE:		VectorSoA.h
+ * LICENCE:		See Licence.txt
+ * PURPOSE:		Structure-of-arrays vector streams for bulk operations.
+ *
+ *				(c) Tuomo Jauhiainen 2012
+ *
+ **********************************************************************/
+
+#pragma once
+#ifndef __MYLLY_VECTORSOA_H
+#define __MYLLY_VECTORSOA_H
+
+#include "stdtypes.h"
+#include "Math/Vector3.h"
+#include "Math/Vector4.h"
+
+// Each component lives in its own 16-byte aligned array. The arrays are padded to a multiple of
+// four elements so the kernels can always work on full vectors; the padding is scratch space.
+typedef struct
+{
+	float* x;
+	float* y;
+	float* z;
+	uint32 count;		// Number of vectors in use
+	uint32 capacity;	// Number of vectors allocated
+} vector3_soa_t;
+
+typedef struct
+{
+	float* x;
+	float* y;
+	float* z;
+	float* w;
+	uint32 count;
+	uint32 capacity;
+} vector4_soa_t;
+
+__BEGIN_DECLS
+
+// The kernels process min(a->count, b->count) vectors and fail silently if result is too small.
+
+MYLLY_API bool			vector3_soa_create		( vector3_soa_t* soa, uint32 capacity );
+MYLLY_API void			vector3_soa_destroy		( vector3_soa_t* soa );
+MYLLY_API void			vector3_soa_pack		( vector3_soa_t* soa, const vector3_t* src, uint32 count );
+MYLLY_API void			vector3_soa_unpack		( vector3_t* dst, const vector3_soa_t* soa );
+
+MYLLY_API void			vector3_soa_add			( vector3_soa_t* result, const vector3_soa_t* a, const vector3_soa_t* b );
+MYLLY_API void			vector3_soa_subtract	( vector3_soa_t* result, const vector3_soa_t* a, const vector3_soa_t* b );
+MYLLY_API void			vector3_soa_scale		( vector3_soa_t* result, const vector3_soa_t* a, float value );
+MYLLY_API void			vector3_soa_dot			( float* result, const vector3_soa_t* a, const vector3_soa_t* b );
+MYLLY_API void			vector3_soa_cross		( vector3_soa_t* result, const vector3_soa_t* a, const vector3_soa_t* b );
+MYLLY_API void			vector3_soa_length		( float* result, const vector3_soa_t* a );
+MYLLY_API void			vector3_soa_normalize	( vector3_soa_t* result, const vector3_soa_t* a );
+MYLLY_API void			vector3_soa_lerp		( vector3_soa_t* result, const vector3_soa_t* a, const vector3_soa_t* b, float t );
+
+MYLLY_API bool			vector4_soa_create		( vector4_soa_t* soa, uint32 capacity );
+MYLLY_API void			vector4_soa_destroy		( vector4_soa_t* soa );
+MYLLY_API void			vector4_soa_pack		( vector4_soa_t* soa, const vector4_t* src, uint32 count );
+MYLLY_API void			vector4_soa_unpack		( vector4_t* dst, const vector4_soa_t* soa );
+
+MYLLY_API void			vector4_soa_add			( vector4_soa_t* result, const vector4_soa_t* a, const vector4_soa_t* b );
+MYLLY_API void			vector4_soa_subtract	( vector4_soa_t* result, const vector4_soa_t* a, const vector4_soa_t* b );
+MYLLY_API void			vector4_soa_scale		( vector4_soa_t* result, const vector4_soa_t* a, float value );
+MYLLY_API void			vector4_soa_dot			( float* result, const vector4_soa_t* a, const vector4_soa_t* b );
+MYLLY_API void			vector4_soa_length		( float* result, const vector4_soa_t* a );
+MYLLY_API void			vector4_soa_normalize	( vector4_soa_t* result, const vector4_soa_t* a );
+MYLLY_API void			vector4_soa_lerp		( vector4_soa_t* result, const vector4_soa_t* a, const vector4_soa_t* b, float t );
+
+__END_DECLS
+
+#endif /* __MYLLY_VECTORSOA_H */
@@ -3,7 +3,8 @@
 project "Lib-Math"
 	kind "StaticLib"
 	language "C"
-	files { "**.h", "**.c", "premake4.lua" }
+	files { "**.h", "**.inl", "**.c", "premake4.lua" }
+	excludes { "Bench/**" }
 	vpaths { [""] = { "../Libraries/Math" } }
 	includedirs { ".", ".." }
 	location ( "../../Projects/" .. os.get() .. "/" .. _ACTION )
@@ -21,3 +22,27 @@ project "Lib-Math"
 		buildoptions { "/wd4201 /wd4996" } -- C4201: nameless struct/union, C4996: This function or variable may be unsafe.
 		configuration "Debug" targetname "mathd"
 		configuration "Release" targetname "math"
+
+-- Micro-benchmarks for every Lib-Math function. Run with -h for options.
+
+project "Lib-Math-Bench"
+	kind "ConsoleApp"
+	language "C"
+	files { "Bench/**.h", "Bench/**.c" }
+	vpaths { [""] = { "../Libraries/Math/Bench" } }
+	includedirs { ".", "..", "Bench" }
+	links { "Lib-Math" }
+	location ( "../../Projects/" .. os.get() .. "/" .. _ACTION )
+	
+	-- Linux specific stuff
+	configuration "linux"
+		buildoptions { "-fms-extensions" }
+		links { "m", "pthread" }
+		configuration "Debug" targetname "mathbenchd"
+		configuration "Release" targetname "mathbench"
+	
+	-- Windows specific stuff
+	configuration "windows"
+		buildoptions { "/wd4201 /wd4996" }
+		configuration "Debug" targetname "mathbenchd"
+		configuration "Release" targetname "mathbench"